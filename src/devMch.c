@@ -125,6 +125,21 @@
 	   Supported operations:
 
 	     * "chas": read chassis status
+	     * "selcnt": count of System Event Log entries read
+
+         Waveform Device Support:
+         -------------------------------------------------------
+
+	 devWaveformMch
+         --------------
+
+         *   init_waveform_record     - Record initialization
+         *   waveform_ioint_info      - Add to i/o scan list
+         *   read_waveform            - Read waveform
+
+	   Supported operations:
+
+	     * "sel": most recent System Event Log events, newest first (FTVL CHAR)
 
          String Input Device Support:
          -------------------------------------------------------
@@ -187,6 +202,8 @@
 #include <mbbiRecord.h>
 #include <mbboRecord.h>
 #include <stringinRecord.h>
+#include <waveformRecord.h>
+#include <menuFtype.h>
 #include <epicsExport.h>
 #include <asynDriver.h>
 #include <dbScan.h>
@@ -242,6 +259,10 @@ static long write_mbbo(struct mbboRecord *pmbbo);
 static long init_longin_record(struct longinRecord *plongin);
 static long read_longin(struct longinRecord *plongin);
 
+static long init_waveform_record(struct waveformRecord *pwf);
+static long read_waveform(struct waveformRecord *pwf);
+static long waveform_ioint_info(int cmd, struct waveformRecord *pwf, IOSCANPVT *iopvt);
+
 static long init_fru_ai(struct aiRecord *pai);
 static long init_fru_ai_record(struct aiRecord *pai);
 static long read_fru_ai(struct aiRecord *pai);
@@ -273,6 +294,7 @@ MCH_DEV_SUP_SET devMbboMch       = {6, NULL, NULL,              init_mbbo_record
 MCH_DEV_SUP_SET devBiMch         = {6, NULL, init_bi,           init_bi_record,           bi_ioint_info,           read_bi,           NULL};
 MCH_DEV_SUP_SET devMbbiMch       = {6, NULL, init_mbbi,         init_mbbi_record,         mbbi_ioint_info,         read_mbbi,         NULL};
 MCH_DEV_SUP_SET devLonginMch     = {6, NULL, NULL,              init_longin_record,       NULL,                    read_longin,       NULL};
+MCH_DEV_SUP_SET devWaveformMch   = {6, NULL, NULL,              init_waveform_record,     waveform_ioint_info,     read_waveform,     NULL};
 MCH_DEV_SUP_SET devAiFru         = {6, NULL, init_fru_ai,       init_fru_ai_record,       ai_fru_ioint_info,       read_fru_ai,       NULL};
 MCH_DEV_SUP_SET devLongoutFru    = {6, NULL, NULL,              init_fru_longout_record,  NULL,                    write_fru_longout, NULL};
 MCH_DEV_SUP_SET devStringinFru   = {6, NULL, init_fru_stringin, init_fru_stringin_record, stringin_fru_ioint_info, read_fru_stringin, NULL};
@@ -283,6 +305,7 @@ epicsExportAddress(dset, devBiMch);
 epicsExportAddress(dset, devMbbiMch);
 epicsExportAddress(dset, devMbboMch);
 epicsExportAddress(dset, devLonginMch);
+epicsExportAddress(dset, devWaveformMch);
 epicsExportAddress(dset, devAiFru);
 epicsExportAddress(dset, devLongoutFru);
 epicsExportAddress(dset, devStringinFru);
@@ -671,6 +694,7 @@ MchData  mchData;
 MchSess  mchSess;
 MchSys   mchSys;
 Sensor   sens;
+SensorHot hot;
 SdrFull  sdr;
 char     egu[16];
 uint8_t  data[MSG_MAX_LENGTH] = { 0 };
@@ -712,11 +736,20 @@ int      s = 0, inst;
 		}
 
 		sens = &mchSys->sens[index];
+		hot  = &mchSys->hot[index];
+		sens->rec = pai; /* Processed on SEL threshold events */
 
-		if ( mchGetSensorReadingStat( mchData, data, sens ) )
+		if ( mchGetSensorReadingStat( mchData, data, sens ) ) {
+			/* Sensor not present since configuration; treat as if it does not exist */
+			if ( SENS_UNAVAIL( hot ) && !SENS_SEEN( hot ) ) {
+				epicsMutexUnlock( mch->mutex );
+				pai->udf = FALSE;
+				return NO_CONVERT;
+			}
 			s = ERROR;
+		}
 		else
-			sens->val = raw = data[IPMI_RPLY_IMSG2_SENSOR_READING_OFFSET];
+			raw = hot->val;
 	
 		epicsMutexUnlock( mch->mutex );
 
@@ -724,7 +757,7 @@ int      s = 0, inst;
 
 		/* Need to reconsider how to handle alarms if sensor scanning disabled */
 
-		if ( !sens->cnfg ) {
+		if ( !SENS_CNFG( hot ) ) {
 			sensEgu( egu, sdr->units2 );
 			strcpy( pai->egu,  egu );
 			if ( sdr->str )
@@ -733,7 +766,7 @@ int      s = 0, inst;
 			if ( sdr->recType == SDR_TYPE_FULL_SENSOR )
 				sensThresh( sdr, sens, &pai->lolo, &pai->llsv, &pai->low, &pai->lsv, 
 					    &pai->high, &pai->hsv, &pai->hihi, &pai->hhsv, pai->name );
-			sens->cnfg = 1;
+			hot->stat |= SENS_STAT_CNFG;
 		}
 
 		if ( s ) {
@@ -938,7 +971,7 @@ short    index;
 		if ( !(strcmp( task, "spres")) ) {
 
 			index     = sensLkup( mchSys, pbi->inp.value.camacio );
-			pbi->rval = ( -1 == index ) ? 0 : 1;
+			pbi->rval = ( -1 == index || SENS_UNAVAIL( &mchSys->hot[index] ) ) ? 0 : 1;
 		}
 
 		else if ( !(strcmp( task, "fpres")) ) {
@@ -1078,10 +1111,19 @@ int readoffset;
 */
 			epicsMutexLock( mch->mutex );
 
-			if ( mchGetSensorReadingStat( mchData, data, sens ) )
+			sens->rec = pmbbi; /* Processed on SEL hot-swap events */
+
+			if ( mchGetSensorReadingStat( mchData, data, sens ) ) {
+				/* Sensor not present; provide "Not Available" as if it did not exist */
+				if ( SENS_UNAVAIL( &mchSys->hot[sindex] ) ) {
+					epicsMutexUnlock( mch->mutex );
+					pmbbi->rval = 0x100;
+					return 0;
+				}
 				s = ERROR;
+			}
 			else {
-				sens->val = value = data[IPMI_RPLY_IMSG2_DISCRETE_SENSOR_READING_OFFSET];
+				value = data[IPMI_RPLY_IMSG2_DISCRETE_SENSOR_READING_OFFSET];
 
 				if ( MCH_DBG( mchStat[inst] ) >= MCH_DBG_MED )
 					printf("%s read_mbbi: value %02x, sensor %i, owner %i, lun %i, index %i, value %i\n",
@@ -1189,7 +1231,7 @@ int      inst;
 				printf("write_mbbo: call mchMsgChassisControl with value %i\n", pmbbo->val); 
 
 			epicsMutexLock( mch->mutex );
-			status = mchMsgChassisControl( mchData, data, pmbbo->val );
+			status = mchMsgChassisControl( mchSessPoolGet( mchData, MCH_WORK_CTRL ), data, pmbbo->val );
 			epicsMutexUnlock( mch->mutex );
 		}
 		else if ( !(strcmp( task, "fru" )) ) {
@@ -1208,7 +1250,7 @@ int      inst;
 
 			epicsMutexLock( mch->mutex );
 			if ( mchData->mchSys->mchcb->set_fru_act )        
-				status = mchData->mchSys->mchcb->set_fru_act( mchData, data, index, cmd );
+				status = mchData->mchSys->mchcb->set_fru_act( mchSessPoolGet( mchData, MCH_WORK_CTRL ), data, index, cmd );
 			else
 				status = -1;
 			epicsMutexUnlock( mch->mutex );
@@ -1249,7 +1291,7 @@ char     str[40];
 	node = strtok( plongin->inp.value.camacio.parm, "+" );
 	if ( (p = strtok( NULL, "+" )) ) {
 		task = p;
-		if ( strcmp( task, "chas" ) ) { 
+		if ( strcmp( task, "chas" ) && strcmp( task, "sessrst" ) && strcmp( task, "sessms" ) && strcmp( task, "selcnt" ) ) { 
 			sprintf( str, "Unknown task parameter %s", task);
 			status = S_dev_badSignal;
 		}
@@ -1287,6 +1329,30 @@ int      inst;
 	mchSess = mchData->mchSess;
 	inst    = mchSess->instance;
 
+	/* Session re-establishment statistics */
+	if ( !(strcmp( recPvt->task, "sessrst" )) || !(strcmp( recPvt->task, "sessms" )) ) {
+
+		epicsMutexLock( mch->mutex );
+		if ( !(strcmp( recPvt->task, "sessrst" )) )
+			plongin->val = mchSess->sessRestarts;
+		else
+			plongin->val = (epicsInt32)(mchSess->sessHandshakeLast*1000 + 0.5);
+		epicsMutexUnlock( mch->mutex );
+
+		plongin->udf = FALSE;
+		return SUCCESS;
+	}
+
+	if ( !(strcmp( recPvt->task, "selcnt" )) ) {
+
+		epicsMutexLock( mch->mutex );
+		plongin->val = mchData->mchSys->sel.entries;
+		epicsMutexUnlock( mch->mutex );
+
+		plongin->udf = FALSE;
+		return SUCCESS;
+	}
+
 	if ( checkMchOnlnSessInitDone( mchSess ) ) {
 
 		epicsMutexLock( mch->mutex );
@@ -1323,6 +1389,104 @@ bail:
 	return ERROR;
 }
 
+/*
+** Add this record to our IOSCANPVT list.
+*/
+static long
+waveform_ioint_info(int cmd, struct waveformRecord *pwf, IOSCANPVT *iopvt)
+{
+MchRec   recPvt  = pwf->dpvt;
+MchData  mchData;
+
+	if ( !recPvt )
+		return ERROR;
+
+	mchData = recPvt->mch->udata;
+	*iopvt  = drvSelScan[mchData->mchSess->instance];
+	return SUCCESS;
+}
+
+static long 
+init_waveform_record(struct waveformRecord *pwf)
+{
+MchRec   recPvt  = 0; /* Info stored with record */
+MchDev   mch     = 0; /* MCH device data structures */
+char    *node    = 0; /* Network node name, stored in parm */
+char    *task    = 0; /* Optional additional parameter appended to parm */
+char    *p;
+long     status  = SUCCESS;
+char     str[40];
+
+	if ( ! ( recPvt = init_record_chk( &pwf->inp, &status, str )) )
+		goto bail;
+
+	/* Break parm into node name and optional parameter */
+	node = strtok( pwf->inp.value.camacio.parm, "+" );
+	if ( (p = strtok( NULL, "+" )) ) {
+		task = p;
+		if ( strcmp( task, "sel" ) ) { 
+			sprintf( str, "Unknown task parameter %s", task);
+			status = S_dev_badSignal;
+		}
+	}
+
+	if ( !status && pwf->ftvl != menuFtypeCHAR && pwf->ftvl != menuFtypeUCHAR ) {
+		sprintf( str, "FTVL must be CHAR or UCHAR");
+		status = S_db_badField;
+	}
+
+	if ( init_record_find( mch, recPvt, node, task, &status, str ) )
+		goto bail;
+	else
+		pwf->dpvt = recPvt;
+
+bail:
+	if ( status ) {
+	       recGblRecordError( status, (void *)pwf, (const char *)str );
+	       pwf->pact=TRUE;
+	}
+
+        return status;
+}
+
+/* Copy decoded SEL events into waveform, newest first, one per line */
+static long 
+read_waveform(struct waveformRecord *pwf)
+{
+MchRec   recPvt  = pwf->dpvt;
+MchDev   mch;
+MchSel   sel;
+char    *buf     = pwf->bptr;
+size_t   n = 0, len;
+int      i, k;
+
+	if ( !recPvt )
+		return SUCCESS;
+
+	mch = recPvt->mch;
+	sel = &((MchData)mch->udata)->mchSys->sel;
+
+	epicsMutexLock( mch->mutex );
+
+	for ( i = 0; i < sel->logCount && n + 1 < pwf->nelm; i++ ) {
+		k   = (sel->logHead + MCH_SEL_LOG_MAX - 1 - i) % MCH_SEL_LOG_MAX;
+		len = strlen( sel->log[k] );
+		if ( n + len + 1 >= pwf->nelm )
+			len = pwf->nelm - n - 2;
+		memcpy( buf + n, sel->log[k], len );
+		n += len;
+		buf[n++] = '\n';
+	}
+
+	epicsMutexUnlock( mch->mutex );
+
+	if ( n < pwf->nelm )
+		buf[n] = '\0';
+	pwf->nord = n;
+	pwf->udf  = FALSE;
+	return SUCCESS;
+}
+
 /* 
  * Device support to read FRU data
  */
@@ -1791,7 +1955,7 @@ int      s = 0, inst;
 
 /* Need to test this for all archs */
 			if ( mchData->mchSys->mchcb->set_fan_level )
-				s = mchData->mchSys->mchcb->set_fan_level( mchData, data, index, plongout->val );
+				s = mchData->mchSys->mchcb->set_fan_level( mchSessPoolGet( mchData, MCH_WORK_CTRL ), data, index, plongout->val );
 			else
 				s = -1;
 
@@ -27,9 +27,13 @@
 #include <dbScan.h>
 #include <registryFunction.h>
 #include <registry.h>
+#include <drvAsynIPPort.h>
 
 #include <drvMch.h>
 #include <drvMchMsg.h>
+#ifdef IPMI_RMCPP
+#include <ipmiRmcpp.h>
+#endif
 #include <ipmiMsg.h>
 #include <picmgDef.h>
 #include <initHooks.h>
@@ -63,6 +67,23 @@ char mchDescString[MCH_TYPE_MAX][MCH_DESC_MAX_LENGTH] =
                     ""
                 };
 
+/* Default session keepalive idle window (seconds) per MCH type; 0 disables.
+ * IPMI session inactivity timeout is nominally 60 s, but some
+ * shelf managers drop idle sessions sooner. Override with mchKeepalive.
+ */
+static double mchKeepaliveDefault[MCH_TYPE_MAX] =
+                {   20.0, /* Unknown    */
+                    20.0, /* VT         */
+                    20.0, /* NAT        */
+                    20.0, /* Supermicro */
+                    20.0, /* Pentair    */
+                    20.0, /* Artesyn    */
+                    20.0, /* Advantech  */
+                    0,
+                    0,
+                    0
+                };
+
 static int mchCounter = 0;
 static int mchInitSuccessCounter = 0;
 static int mchInitFailCounter = 0;
@@ -72,6 +93,9 @@ epicsMutexId mchStatMtx[MAX_MCH];
 uint32_t     mchStat[MAX_MCH] = { 0 };
 
 IOSCANPVT drvSensorScan[MAX_MCH];
+IOSCANPVT drvSelScan[MAX_MCH];
+
+static MchDev mchDevList[MAX_MCH]; /* For driver report and event sources (mchDevGet) */
 struct MchCbRec_ *MchCb;
 
 static int mchSdrGetDataAll(MchData mchData);
@@ -79,6 +103,12 @@ static int mchFruGetDataAll(MchData mchData);
 int mchGetFruIdFromIndex(MchData mchData, int index);
 static int  mchCnfg(MchData mchData, int initFlag);
 static void mchCnfgReset(MchData mchData);
+static void mchGetSensorThresh(MchData mchData, Sensor sens);
+static int  mchFruDataGet(MchData mchData, Fru fru);
+static int  mchMgmtSdrGet(MchData mchData, int index, uint8_t *response);
+static void mchSensorGetFru(MchData mchData, int index);
+static void mchSensorFruGetInstance(MchData mchData);
+static void mchSensorHotLink(MchSys mchSys);
 
 
 // we must wait for the IPMI sessions to finish initializing before
@@ -116,6 +146,10 @@ int i;
 
 	for ( i = 0; i < IPMI_WRAPPER_ID_LENGTH ; i++)
 		ipmiSess->id[i] = 0;
+
+#ifdef IPMI_RMCPP
+	ipmiRmcppDown( ipmiSess );
+#endif
 }
 
 static void
@@ -123,6 +157,18 @@ mchSetAuth(MchSess mchSess, IpmiSess ipmiSess, uint8_t authByte)
 {
 	ipmiSess->authReq = 0xFF; /* Default to illegal value */
 	ipmiSess->authSup = IPMI_AUTH_TYPE_SUPPORT( authByte );
+	mchSess->rmcpp    = 0;
+
+#ifdef IPMI_RMCPP
+	/* RMCP+ if requested with mchRmcpp, or if BMC only supports IPMI v2.0 (lanplus).
+	 * RMCP+ requests are built as auth type NONE and converted when sent (ipmiRmcpp.h).
+	 */
+	if ( mchSess->rmcppSuite || !(ipmiSess->authSup & ((1<<IPMI_MSG_AUTH_TYPE_NONE) | (1<<IPMI_MSG_AUTH_TYPE_PWD_KEY))) ) {
+		ipmiSess->authReq = IPMI_MSG_AUTH_TYPE_NONE;
+		mchSess->rmcpp    = mchSess->rmcppSuite ? mchSess->rmcppSuite : IPMI_RMCPP_SUITE_DEFAULT;
+		return;
+	}
+#endif
 
 	if ( ipmiSess->authSup & (1<<IPMI_MSG_AUTH_TYPE_NONE) ) {
 		ipmiSess->authReq = IPMI_MSG_AUTH_TYPE_NONE;
@@ -135,34 +181,22 @@ mchSetAuth(MchSess mchSess, IpmiSess ipmiSess, uint8_t authByte)
 		    mchSess->name, ipmiSess->authSup);
 }
 
-/* Start communication session with MCH
- * Multi-step handshaking sequence
+/* Activate IPMI v1.5 session: Get Session Challenge, then Activate Session
  *
  * Caller must perform locking.
  *
  *   RETURNS:
  *         0 on success
  *         non-zero on failure
- */		
-static int 
-mchCommStart(MchSess mchSess, IpmiSess ipmiSess)
-{	
-uint8_t response[MSG_MAX_LENGTH] = { 0 };
-int     i;
-
-	printf("%s Connecting...\n", mchSess->name);
-
-	mchSeqInit( ipmiSess );
-
-	if ( mchMsgGetChanAuth( mchSess, ipmiSess, response ) ) {
-		printf("%s Get Channel Authentication failed\n", mchSess->name);
-		return -1;	
-	}
-
-	mchSetAuth( mchSess, ipmiSess, response[IPMI_RPLY_IMSG2_AUTH_CAP_AUTH_OFFSET] );
+ */
+static int
+mchCommActivate(MchSess mchSess, IpmiSess ipmiSess, uint8_t *response)
+{
+int i;
 
 	if ( mchMsgGetSess( mchSess, ipmiSess, response ) ) {
 		printf("%s Get Session failed\n", mchSess->name);
+		mchSess->authKnown = 0;
 		return -1;
 	}
 
@@ -176,7 +210,8 @@ int     i;
 
 	if ( mchMsgActSess( mchSess, ipmiSess, response ) ) {
 		printf("%s Activate session failed\n", mchSess->name);
-		goto bail;;
+		mchMsgCloseSess( mchSess, ipmiSess, response );
+		return -1;
 	}
 
         /* Extract session ID */
@@ -187,6 +222,56 @@ int     i;
         for ( i = 0; i < IPMI_RPLY_INIT_SEND_SEQ_LENGTH ; i++)
                 ipmiSess->seqSend[i] = response[IPMI_RPLY_IMSG2_ACT_SESS_INIT_SEND_SEQ_OFFSET + i];
 
+	return 0;
+}
+
+/* Start communication session with MCH
+ * Multi-step handshaking sequence
+ *
+ * If reuseAuth is set and authentication capabilities were read
+ * before, skip Get Channel Authentication; they do not change
+ * while the MCH is up. If the session challenge then fails,
+ * the next attempt starts from the beginning.
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS:
+ *         0 on success
+ *         non-zero on failure
+ */		
+static int 
+mchCommStart(MchSess mchSess, IpmiSess ipmiSess, int reuseAuth)
+{	
+uint8_t response[MSG_MAX_LENGTH] = { 0 };
+
+	printf("%s Connecting...\n", mchSess->name);
+
+	mchSeqInit( ipmiSess );
+
+	if ( !(reuseAuth && mchSess->authKnown) ) {
+
+		if ( mchMsgGetChanAuth( mchSess, ipmiSess, response ) ) {
+			printf("%s Get Channel Authentication failed\n", mchSess->name);
+			return -1;	
+		}
+
+		mchSetAuth( mchSess, ipmiSess, response[IPMI_RPLY_IMSG2_AUTH_CAP_AUTH_OFFSET] );
+		mchSess->authKnown = 1;
+	}
+
+#ifdef IPMI_RMCPP
+	if ( mchSess->rmcpp ) {
+		if ( mchMsgRmcppOpen( mchSess, ipmiSess ) ) {
+			printf("%s RMCP+ session (cipher suite %i) failed\n", mchSess->name, mchSess->rmcpp);
+			mchSess->authKnown = 0;
+			return -1;
+		}
+	}
+	else
+#endif
+	if ( mchCommActivate( mchSess, ipmiSess, response ) )
+		return -1;
+
 	/* Need a non-hard-coded way to determine privilege level */
 	if ( mchMsgSetPriv( mchSess, ipmiSess, response, IPMI_MSG_PRIV_LEVEL_OPER ) ) {
 		printf("%s Set session privilege failed\n", mchSess->name);
@@ -203,7 +288,8 @@ bail:
 
 /* Start new session with MCH
  * Reset session sequence number and session ID to 0,
- * then call mchCommStart to initiate new session
+ * then call mchCommStart to initiate new session,
+ * reusing known authentication capabilities
  *
  * Caller must perform locking.
  *
@@ -219,11 +305,546 @@ int rval = -1;
 	mchSeqInit( ipmiSess );
 
 	if ( MCH_ONLN( mchStat[mchSess->instance] ) )
-		rval = mchCommStart( mchSess, ipmiSess );
+		rval = mchCommStart( mchSess, ipmiSess, 1 );
+
+	return rval;
+}
+
+/* Ask ping task to re-establish session. Until it does,
+ * in-session requests fail without being sent.
+ *
+ * Caller must perform locking.
+ */
+void
+mchSessRecoverRequest(MchSess mchSess)
+{
+	if ( mchSess->recover )
+		return;
+
+	mchSess->recover = 1;
+	epicsEventSignal( mchSess->recoverEvent );
+}
+
+/* Send cheap in-session message on each session in pool that has been idle
+ * for the keepalive window, so that the MCH does not expire it; run by ping task.
+ */
+static void
+mchSessKeepalive(MchDev mch)
+{
+MchData  mchData  = mch->udata;
+MchData  d;
+MchSess  mchSess  = mchData->mchSess;
+uint8_t  response[MSG_MAX_LENGTH] = { 0 };
+epicsTimeStamp now;
+int      inst = mchSess->instance, i;
+
+	if ( mchSess->keepalive <= 0 || !mchSess->session || !MCH_INIT_DONE( mchStat[inst] ) )
+		return;
+
+	epicsMutexLock( mch->mutex );
+
+	for ( i = 0; i < mchData->poolSize; i++ ) {
+
+		d = mchData->pool[i];
+
+		epicsTimeGetCurrent( &now );
+		if ( d->mchSess->recover || epicsTimeDiffInSeconds( &now, &d->mchSess->lastTraffic ) < mchSess->keepalive )
+			continue;
+
+		if ( mchMsgGetDeviceIdWrapper( d, response, &d->mchSys->route ) && MCH_DBG( mchStat[inst] ) )
+			printf("%s keepalive failed\n", d->mchSess->name);
+		d->mchSess->keepalives++;
+	}
+
+	epicsMutexUnlock( mch->mutex );
+}
+
+/* Make settings of pooled session match those of primary session
+ * determined when MCH was identified
+ */
+static void
+mchSessPoolSync(MchData mchData, MchData d)
+{
+	d->mchSess->type       = mchData->mchSess->type;
+	d->mchSess->timeout    = mchData->mchSess->timeout;
+	d->mchSess->session    = mchData->mchSess->session;
+	d->ipmiSess->timeout   = mchData->ipmiSess->timeout;
+	d->ipmiSess->features  = mchData->ipmiSess->features;
+	d->mchSess->rmcppSuite = mchData->mchSess->rmcppSuite;
+}
+
+/* Close session 'd' (primary or pooled) and start a new one
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS: (return val from mchNewSession)
+ *           0 on success
+ *           non-zero on failure
+ */
+static int
+mchSessRestart(MchData mchData, MchData d)
+{
+MchSess  mchSess = d->mchSess;
+uint8_t  response[MSG_MAX_LENGTH] = { 0 };
+epicsTimeStamp t0, t1;
+int      rval;
+
+	if ( d != mchData )
+		mchSessPoolSync( mchData, d );
+
+	epicsTimeGetCurrent( &t0 );
+
+	/* Close current session, start new one */
+	mchMsgCloseSess( mchSess, d->ipmiSess, response );
+	rval = mchNewSession( mchSess, d->ipmiSess );
+
+	epicsTimeGetCurrent( &t1 );
+	mchSess->sessHandshakeLast   = epicsTimeDiffInSeconds( &t1, &t0 );
+	mchSess->sessHandshakeTotal += mchSess->sessHandshakeLast;
+
+	if ( rval )
+		mchSess->sessRestartFails++;
+	else {
+		mchSess->sessRestarts++;
+		mchSess->recover = 0;
+		mchSess->err     = 0;
+	}
+
+	if ( MCH_DBG( mchStat[mchSess->instance] ) )
+		printf("%s session re-establish %s in %.3f s\n", mchSess->name, rval ? "failed" : "done", mchSess->sessHandshakeLast);
 
 	return rval;
 }
 
+/* Re-establish sessions in pool, if requested; run by ping task.
+ * Pooled sessions are only (re)started once MCH type is known.
+ * Once the primary session is back, scan sensor records so that
+ * those that failed meanwhile are refreshed right away.
+ */
+static void
+mchSessRecover(MchDev mch)
+{
+MchData  mchData  = mch->udata;
+MchData  d;
+int      inst = mchData->mchSess->instance, i, scan = 0;
+
+	epicsMutexLock( mch->mutex );
+
+	for ( i = 0; i < mchData->poolSize && MCH_ONLN( mchStat[inst] ); i++ ) {
+
+		d = mchData->pool[i];
+
+		if ( !d->mchSess->recover )
+			continue;
+
+		if ( i > 0 && !MCH_INIT_DONE( mchStat[inst] ) )
+			continue;
+
+		if ( !mchSessRestart( mchData, d ) && i == 0 )
+			scan = 1;
+	}
+
+	epicsMutexUnlock( mch->mutex );
+
+	if ( scan && drvSensorScan[inst] )
+		scanIoRequest( drvSensorScan[inst] );
+}
+
+/* Session to use for a workload (MCH_WORK_xxx).
+ * The sensor sweep always uses the primary session; other workloads
+ * share the remaining sessions in the pool. Falls back to the primary
+ * session if there is no pool or the pooled session is not established.
+ */
+MchData
+mchSessPoolGet(MchData mchData, int work)
+{
+MchData d;
+
+	if ( mchData->poolSize <= 1 || work == MCH_WORK_SENSOR )
+		return mchData;
+
+	d = mchData->pool[1 + (work - 1) % (mchData->poolSize - 1)];
+
+	return d->mchSess->recover ? mchData : d;
+}
+
+/* Start pooled sessions after MCH has been (re)identified
+ *
+ * Caller must perform locking.
+ */
+static void
+mchSessPoolStart(MchData mchData)
+{
+int i;
+
+	for ( i = 1; i < mchData->poolSize; i++ ) {
+		if ( mchSessRestart( mchData, mchData->pool[i] ) )
+			mchData->pool[i]->mchSess->recover = 1;
+	}
+}
+
+/* Threshold event offsets (event data 1 [3:0]) */
+static const char *mchSelThreshStr[] = {
+	"lower non-critical going low",  "lower non-critical going high",
+	"lower critical going low",      "lower critical going high",
+	"lower non-recoverable going low", "lower non-recoverable going high",
+	"upper non-critical going low",  "upper non-critical going high",
+	"upper critical going low",      "upper critical going high",
+	"upper non-recoverable going low", "upper non-recoverable going high"
+};
+
+/* Add decoded event to SEL log ring buffer */
+static void
+mchSelLog(MchSel sel, uint8_t *rec, Sensor sens)
+{
+uint8_t  etype = rec[IPMI_SEL_REC_EVENT_TYPE_OFFSET];
+uint8_t  stype = rec[IPMI_SEL_REC_SENS_TYPE_OFFSET];
+uint8_t *edata = rec + IPMI_SEL_REC_EVENT_DATA_OFFSET;
+uint32_t ts    = arrayToUint32( rec + IPMI_SEL_REC_TS_OFFSET );
+epicsTimeStamp ets;
+char     tstr[32], estr[48];
+char    *line  = sel->log[sel->logHead];
+
+	/* Timestamps up to 0x20000000 are relative to MCH initialization */
+	if ( ts > 0x20000000 ) {
+		epicsTimeFromTime_t( &ets, (time_t)ts );
+		epicsTimeToStrftime( tstr, sizeof( tstr ), "%Y-%m-%d %H:%M:%S", &ets );
+	}
+	else
+		snprintf( tstr, sizeof( tstr ), "+%us", (unsigned)ts );
+
+	if ( IPMI_SEL_EVENT_TYPE( etype ) == IPMI_EVENT_TYPE_THRESHOLD && IPMI_SEL_EVENT_OFFSET( edata[0] ) < 12 )
+		snprintf( estr, sizeof( estr ), "%s", mchSelThreshStr[IPMI_SEL_EVENT_OFFSET( edata[0] )] );
+	else if ( stype == SENSOR_TYPE_HOTSWAP || stype == SENSOR_TYPE_HOTSWAP_NAT )
+		snprintf( estr, sizeof( estr ), "hot swap M%u -> M%u", edata[1] & 0x0F, edata[0] & 0x0F );
+	else
+		snprintf( estr, sizeof( estr ), "type 0x%02x offset %u", IPMI_SEL_EVENT_TYPE( etype ), IPMI_SEL_EVENT_OFFSET( edata[0] ) );
+
+	snprintf( line, MCH_SEL_LOG_LENGTH, "%s 0x%02x #%u %s: %s %s", tstr, rec[IPMI_SEL_REC_GEN_ADDR_OFFSET],
+	    rec[IPMI_SEL_REC_SENS_NUM_OFFSET], sens ? sens->sdr.str : "?", estr, 
+	    IPMI_SEL_EVENT_DEASSERT( etype ) ? "deasserted" : "asserted" );
+
+	sel->logHead = (sel->logHead + 1) % MCH_SEL_LOG_MAX;
+	if ( sel->logCount < MCH_SEL_LOG_MAX )
+		sel->logCount++;
+}
+
+/* Refresh sensor now: queue processing of its record if device support
+ * has attached one (the record reads the sensor), else read it directly
+ */
+static void
+mchEventSensorRefresh(MchData mchData, Sensor sens)
+{
+uint8_t response[MSG_MAX_LENGTH] = { 0 };
+
+	if ( sens->rec ) {
+		scanOnce( sens->rec );
+		mchData->mchSys->sel.triggered++;
+	}
+	else
+		mchGetSensorReadingStat( mchData, response, sens );
+}
+
+/* Find sensor by owner address, owner LUN and number.
+ * lunMask selects the bits of the owner LUN (channel [7:4], LUN [1:0]) that must match;
+ * 0 if the event source does not report them.
+ *
+ *   RETURNS: sensor, or NULL if not found
+ */
+static Sensor
+mchSensorFind(MchSys mchSys, uint8_t addr, uint8_t lun, uint8_t lunMask, uint8_t number)
+{
+Sensor s;
+int    i;
+
+	for ( i = 0; i < mchSys->sensCount; i++ ) {
+		s = &mchSys->sens[i];
+		if ( s->sdr.owner == addr && ((s->sdr.lun ^ lun) & lunMask) == 0 && s->sdr.number == number )
+			return s;
+	}
+	return 0;
+}
+
+/* Act on an event from the SEL or a LAN alert: for threshold and hot-swap events,
+ * refresh the affected sensors now rather than at next scan. For a hot-swap event
+ * these are all sensors behind the same controller, whose re-probe backoff is also ended.
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS: sensor that generated the event, or NULL if not found
+ */
+Sensor
+mchSensorEvent(MchData mchData, uint8_t addr, uint8_t lun, uint8_t lunMask, uint8_t number, uint8_t stype, uint8_t etype)
+{
+MchSys    mchSys = mchData->mchSys;
+Sensor    sens, s;
+SensorHot hot;
+int       i;
+
+	if ( !MCH_INIT_DONE( mchStat[mchData->mchSess->instance] ) )
+		return 0;
+
+	sens = mchSensorFind( mchSys, addr, lun, lunMask, number );
+
+	if ( stype == SENSOR_TYPE_HOTSWAP || stype == SENSOR_TYPE_HOTSWAP_NAT ) {
+
+		for ( i = 0; i < mchSys->sensCount; i++ ) {
+			s = &mchSys->sens[i];
+			if ( s->sdr.owner != addr || ((s->sdr.lun ^ lun) & lunMask & 0xF0) )
+				continue;
+			hot = &mchSys->hot[i];
+			if ( SENS_UNAVAIL( hot ) ) {
+				hot->tries = 0;
+				epicsTimeGetCurrent( &hot->probe );
+			}
+			mchEventSensorRefresh( mchData, s );
+		}
+	}
+	else if ( sens && IPMI_SEL_EVENT_TYPE( etype ) == IPMI_EVENT_TYPE_THRESHOLD )
+		mchEventSensorRefresh( mchData, sens );
+
+	return sens;
+}
+
+/* Handle one new SEL entry: log it and act on it (see mchSensorEvent)
+ *
+ * Caller must perform locking.
+ */
+static void
+mchSelEvent(MchData mchData, uint8_t *rec)
+{
+MchSel    sel    = &mchData->mchSys->sel;
+Sensor    sens;
+uint8_t   lun    = rec[IPMI_SEL_REC_GEN_LUN_OFFSET]; /* Channel and LUN, same layout as SDR owner LUN */
+
+	sel->entries++;
+
+	/* Ignore OEM records */
+	if ( rec[IPMI_SEL_REC_TYPE_OFFSET] != IPMI_SEL_REC_TYPE_SYSTEM )
+		return;
+
+	sens = mchSensorEvent( mchData, rec[IPMI_SEL_REC_GEN_ADDR_OFFSET], lun, 0xF3, rec[IPMI_SEL_REC_SENS_NUM_OFFSET],
+	    rec[IPMI_SEL_REC_SENS_TYPE_OFFSET], rec[IPMI_SEL_REC_EVENT_TYPE_OFFSET] );
+
+	mchSelLog( sel, rec, sens );
+
+	if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) )
+		printf("%s SEL event: %s\n", mchData->mchSess->name, sel->log[(sel->logHead + MCH_SEL_LOG_MAX - 1) % MCH_SEL_LOG_MAX]);
+}
+
+/* MCH device handle by instance number
+ *
+ *   RETURNS: device, or NULL if no MCH with that instance
+ */
+MchDev
+mchDevGet(int inst)
+{
+	return ( inst >= 0 && inst < MAX_MCH ) ? mchDevList[inst] : 0;
+}
+
+/* Read SEL entries added since last poll; run by ping task.
+ * Returns without reading entries if the SEL has not changed.
+ * On first poll only the position of the most recent entry is recorded.
+ */
+static void
+mchSelPoll(MchDev mch)
+{
+MchData  mchData = mch->udata;
+MchSys   mchSys  = mchData->mchSys;
+MchSel   sel     = &mchSys->sel;
+MchData  work;
+uint8_t  data[MSG_MAX_LENGTH] = { 0 };
+uint8_t  id[2], res[2] = { 0 };
+uint32_t addTs, eraseTs;
+uint16_t next;
+int      inst = mchData->mchSess->instance, n = 0, rval;
+
+	if ( sel->disabled || !MCH_INIT_DONE( mchStat[inst] ) )
+		return;
+
+	epicsMutexLock( mch->mutex );
+
+	work = mchSessPoolGet( mchData, MCH_WORK_CNFG );
+
+	if ( (rval = mchMsgGetSelInfo( work, data )) ) {
+		if ( rval == IPMI_COMP_CODE_INVALID_COMMAND || rval == IPMI_COMP_CODE_NOT_SUPPORTED ) {
+			printf("%s does not support System Event Log; SEL reader disabled\n", mch->name);
+			sel->disabled = 1;
+		}
+		goto bail;
+	}
+	sel->polls++;
+
+	addTs   = arrayToUint32( data + IPMI_RPLY_IMSG2_SEL_ADD_TS_OFFSET );
+	eraseTs = arrayToUint32( data + IPMI_RPLY_IMSG2_SEL_ERASE_TS_OFFSET );
+
+	if ( sel->primed && addTs == sel->addTs && eraseTs == sel->eraseTs )
+		goto bail;
+
+	if ( IPMI_SEL_OP_RESERVE( data[IPMI_RPLY_IMSG2_SEL_OP_OFFSET] ) ) {
+		if ( mchMsgReserveSel( work, data ) )
+			goto bail;
+		res[0] = data[IPMI_RPLY_IMSG2_SEL_RES_LSB_OFFSET];
+		res[1] = data[IPMI_RPLY_IMSG2_SEL_RES_MSB_OFFSET];
+	}
+
+	/* First poll: start after most recent entry */
+	if ( !sel->primed ) {
+		id[0] = id[1] = 0xFF;
+		rval = mchMsgGetSelEntry( work, data, id, res );
+		if ( rval && rval != IPMI_COMP_CODE_REQUESTED_DATA )
+			goto bail;
+		if ( (sel->haveLast = !rval) )
+			sel->lastId = arrayToUint16( data + IPMI_RPLY_IMSG2_SEL_DATA_OFFSET + IPMI_SEL_REC_ID_OFFSET );
+		sel->primed  = 1;
+		sel->addTs   = addTs;
+		sel->eraseTs = eraseTs;
+		goto bail;
+	}
+
+	/* SEL was cleared */
+	if ( eraseTs != sel->eraseTs )
+		sel->haveLast = 0;
+
+	next = IPMI_SEL_ID_FIRST;
+
+	/* Re-read last entry read to find the one after it */
+	if ( sel->haveLast ) {
+		id[0] = sel->lastId & 0xFF;
+		id[1] = sel->lastId >> 8;
+		rval  = mchMsgGetSelEntry( work, data, id, res );
+		if ( rval == IPMI_COMP_CODE_REQUESTED_DATA ) /* Deleted; start over */
+			sel->haveLast = 0;
+		else if ( rval )
+			goto bail;
+		else
+			next = arrayToUint16( data + IPMI_RPLY_IMSG2_SEL_NEXT_ID_LSB_OFFSET );
+	}
+
+	while ( next != IPMI_SEL_ID_LAST && n < MCH_SEL_READ_MAX ) {
+
+		id[0] = next & 0xFF;
+		id[1] = next >> 8;
+		if ( (rval = mchMsgGetSelEntry( work, data, id, res )) ) {
+			/* SEL empty */
+			if ( rval == IPMI_COMP_CODE_REQUESTED_DATA && next == IPMI_SEL_ID_FIRST )
+				next = IPMI_SEL_ID_LAST;
+			break;
+		}
+
+		sel->lastId   = arrayToUint16( data + IPMI_RPLY_IMSG2_SEL_DATA_OFFSET + IPMI_SEL_REC_ID_OFFSET );
+		sel->haveLast = 1;
+		next          = arrayToUint16( data + IPMI_RPLY_IMSG2_SEL_NEXT_ID_LSB_OFFSET );
+
+		mchSelEvent( mchData, data + IPMI_RPLY_IMSG2_SEL_DATA_OFFSET );
+		n++;
+	}
+
+	/* Caught up; otherwise continue on next poll */
+	if ( next == IPMI_SEL_ID_LAST ) {
+		sel->addTs   = addTs;
+		sel->eraseTs = eraseTs;
+	}
+
+bail:
+	epicsMutexUnlock( mch->mutex );
+
+	if ( n && drvSelScan[inst] )
+		scanIoRequest( drvSelScan[inst] );
+}
+
+/* Rediscover FRUs that changed hot-swap state (see mchFruRescanRequest); run by ping task.
+ * Only the affected FRU's inventory and its controller's device SDRs are read,
+ * rather than the whole shelf. Sensors found in the device SDRs that were not
+ * known before are added and indexed; known sensors are kept as they are.
+ * New FRU data are allocated from the configuration arena; the old data
+ * are released with the configuration generation.
+ */
+static void
+mchFruRescan(MchDev mch)
+{
+MchData  mchData = mch->udata;
+MchSys   mchSys  = mchData->mchSys;
+MchData  work;
+Fru      fru;
+Mgmt     mgmt;
+uint8_t  response[MSG_MAX_LENGTH] = { 0 };
+uint8_t  what;
+int      inst = mchData->mchSess->instance, sensCount, i, j, n = 0;
+
+	if ( !mchSys->fruRescanPend || !MCH_INIT_DONE( mchStat[inst] ) )
+		return;
+
+	epicsMutexLock( mch->mutex );
+
+	work = mchSessPoolGet( mchData, MCH_WORK_CNFG );
+
+	mchSys->fruRescanPend = 0;
+	sensCount = mchSys->sensCount;
+
+	for ( i = 0; i < mchSys->fruCount && i < MAX_FRU; i++ ) {
+
+		if ( !(what = mchSys->fruRescan[i]) )
+			continue;
+		mchSys->fruRescan[i] = 0;
+
+		fru = &mchSys->fru[i];
+		if ( mchSys->fruLkup[fru->id] == -1 )
+			continue;
+
+		if ( MCH_DBG( mchStat[inst] ) >= MCH_DBG_LOW )
+			printf("%s mchFruRescan: FRU index %i ID %i addr 0x%02x, %s\n", mch->name, i, fru->id, fru->sdr.addr,
+			    (what & MCH_FRU_RESCAN_CLR) ? "removed" : (what & MCH_FRU_RESCAN_SDR) ? "inventory and SDRs" : "inventory");
+
+		if ( what & MCH_FRU_RESCAN_CLR ) {
+			memset( &(fru->board),   0, sizeof( fru->board ) );
+			memset( &(fru->prod),    0, sizeof( fru->prod ) );
+			memset( &(fru->chassis), 0, sizeof( fru->chassis ) );
+			fru->size[0] = fru->size[1] = 0;
+			n++;
+			continue;
+		}
+
+		if ( what & MCH_FRU_RESCAN_SDR ) {
+			for ( j = 0; j < mchSys->mgmtCount; j++ ) {
+				mgmt = &mchSys->mgmt[j];
+				if ( mgmt->sdr.addr == fru->sdr.addr && mgmt->sdr.chan == fru->sdr.chan && mgmt->sdr.addr != IPMI_MSG_ADDR_BMC ) {
+					mchMgmtSdrGet( work, j, response );
+					break;
+				}
+			}
+			/* Device SDRs may include FRU locator records; FRU array may have moved */
+			fru = &mchSys->fru[i];
+		}
+
+		if ( what & MCH_FRU_RESCAN_INV ) {
+			mchFruDataGet( work, fru );
+			if ( mchSys->mchcb->fru_data_suppl )
+				mchSys->mchcb->fru_data_suppl( work, i );
+		}
+		n++;
+	}
+
+	/* Index sensors found in device SDRs */
+	if ( mchSys->sensCount > sensCount ) {
+		mchSensorHotLink( mchSys );
+		for ( i = sensCount; i < mchSys->sensCount; i++ )
+			mchSensorGetFru( mchData, i );
+		mchSensorFruGetInstance( mchData );
+	}
+
+	mchSys->fruRescans += n;
+
+	epicsMutexUnlock( mch->mutex );
+
+	if ( n ) {
+		if ( drvMchFruScan )
+			scanIoRequest( drvMchFruScan );
+		if ( drvSensorScan[inst] )
+			scanIoRequest( drvSensorScan[inst] );
+	}
+}
+
 static uint8_t
 bcdPlusConvert(uint8_t raw)
 {
@@ -376,9 +997,27 @@ mchFruFieldCheckLength(uint8_t length, int type)
 	return 0;
 
 }
+/* Allocate storage for converted FRU field data (plus terminating null)
+ * from the configuration arena
+ *
+ *   RETURNS:
+ *           0 on success
+ *          -1 if no memory
+ */
+static int
+mchFruFieldAllocData(MchSys mchSys, FruField field)
+{
+	if ( !(field->data = mchArenaAlloc( &mchSys->arena, field->length + 1 )) ) {
+		printf("FRU field: no memory for %i bytes of data\n", field->length);
+		return -1;
+	}
+	mchSys->fruStrBytes += field->rlength + field->length + 1;
+	return 0;
+}
+
 /* If error, set field->length to zero to indicate no valid data */
 static int
-mchFruFieldConvertData(FruField field, uint8_t lang)
+mchFruFieldConvertData(MchSys mchSys, FruField field, uint8_t lang)
 {
 int i;
 
@@ -394,8 +1033,9 @@ int i;
 #endif
 
 			field->length = 2*field->rlength;
-			if ( mchFruFieldCheckLength(field->length , FRU_FIELD_LENGTH_TYPE_CONVERTED ) )
-				return -1;
+			if ( mchFruFieldCheckLength(field->length , FRU_FIELD_LENGTH_TYPE_CONVERTED ) ||
+			     mchFruFieldAllocData( mchSys, field ) )
+				break;
 
        			hexAsciiConvert( field->rdata, field->data, field->length );
 	       		return 0;
@@ -404,8 +1044,9 @@ int i;
 		case FRU_DATA_TYPE_BCDPLUS:
 
 			field->length = field->rlength;
-			if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) )
-				return -1;
+			if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) ||
+			     mchFruFieldAllocData( mchSys, field ) )
+				break;
 			for ( i = 0; i < field->length; i++ )
 				field->data[i] = bcdPlusConvert( field->rdata[i] );
 			return 0;
@@ -415,8 +1056,9 @@ int i;
 			field->length = ceil( 8*((float)field->rlength/6) );
 			if ( field->rlength % 3 )
 				printf("6-bit ASCII data length not integer multiple of 3, something may be wrong.\n");
-			if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) )
-				return -1;
+			if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) ||
+			     mchFruFieldAllocData( mchSys, field ) )
+				break;
        			sixBitAsciiConvert( field->rdata, field->data, field->rlength, field->length);
 	       		return 0;
 
@@ -425,15 +1067,23 @@ int i;
 			if ( IPMI_DATA_LANG_ENGLISH( lang ) ) {
 
 				field->length = field->rlength;
-				if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) )
-					return -1;
+				if ( mchFruFieldCheckLength( field->length, FRU_FIELD_LENGTH_TYPE_CONVERTED ) ||
+				     mchFruFieldAllocData( mchSys, field ) )
+					break;
 				memcpy( field->data, field->rdata, field->length );
 				return 0;
 			}
-			else
+			else {
 				printf("Warning FRU data language %i is not english; need to add 2-byte unicode support\n", lang);		   
+				field->length = 0;
+				return 0;
+			}
 	}
-	return 0;
+
+	/* Length check or allocation failed */
+	field->length = 0;
+	field->data   = 0;
+	return -1;
 }
 
 /* Copy FRU area field to data structure
@@ -445,9 +1095,8 @@ int i;
  *          -1 if no data to store
  */
 static int
-mchFruFieldGet(FruField field, uint8_t *raw, unsigned *offset, uint8_t lang)
+mchFruFieldGet(MchSys mchSys, FruField field, uint8_t *raw, unsigned *offset, uint8_t lang)
 {
-int i;
         if ( ( field->rlength = IPMI_DATA_LENGTH( raw[*offset] ) ) ) {
 
                 field->type = IPMI_DATA_TYPE( raw[*offset] );
@@ -457,12 +1106,12 @@ int i;
 		if ( mchFruFieldCheckLength( field->rlength, FRU_FIELD_LENGTH_TYPE_RAW ) )
 			return -1;
 
-		for ( i = 0; i < field->rlength; i++ )
-			field->rdata[i] = raw[*offset + i];
+		/* Raw data stays in the FRU data buffer, which lives as long as the configuration */
+		field->rdata = raw + *offset;
 
 		*offset += field->rlength;
 
-		return mchFruFieldConvertData( field, lang );
+		return mchFruFieldConvertData( mchSys, field, lang );
         }
         return -1;
 }
@@ -473,7 +1122,7 @@ int i;
  * Caller must perform locking.
  */
 static void
-mchFruChassisDataGet(FruChassis chas, uint8_t *raw, unsigned *offset)
+mchFruChassisDataGet(MchSys mchSys, FruChassis chas, uint8_t *raw, unsigned *offset)
 {
 	if ( 0 != (*offset = 8*raw[FRU_DATA_COMMON_HEADER_OFFSET + FRU_DATA_COMMON_HEADER_CHASSIS_AREA_OFFSET]) ) {
 
@@ -481,9 +1130,9 @@ mchFruChassisDataGet(FruChassis chas, uint8_t *raw, unsigned *offset)
 
 		*offset += FRU_DATA_CHASSIS_AREA_PART_LENGTH_OFFSET;
 
-		if ( mchFruFieldGet( &(chas->part),   raw, offset, IPMI_DATA_LANG_CODE_ENGLISH1 ) )
+		if ( mchFruFieldGet( mchSys, &(chas->part),   raw, offset, IPMI_DATA_LANG_CODE_ENGLISH1 ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(chas->sn),     raw, offset, IPMI_DATA_LANG_CODE_ENGLISH1 ) )
+		if ( mchFruFieldGet( mchSys, &(chas->sn),     raw, offset, IPMI_DATA_LANG_CODE_ENGLISH1 ) )
 			(*offset)++;
 	}
 }
@@ -494,7 +1143,7 @@ mchFruChassisDataGet(FruChassis chas, uint8_t *raw, unsigned *offset)
  * Caller must perform locking.
  */
 static void
-mchFruProdDataGet(FruProd prod, uint8_t *raw, unsigned *offset)
+mchFruProdDataGet(MchSys mchSys, FruProd prod, uint8_t *raw, unsigned *offset)
 {
 	if ( 0 != (*offset = 8*raw[FRU_DATA_COMMON_HEADER_OFFSET + FRU_DATA_COMMON_HEADER_PROD_AREA_OFFSET]) ) {
 
@@ -502,15 +1151,15 @@ mchFruProdDataGet(FruProd prod, uint8_t *raw, unsigned *offset)
 
 		*offset += FRU_DATA_PROD_AREA_MANUF_LENGTH_OFFSET;
 
-		if ( mchFruFieldGet( &(prod->manuf),   raw, offset, prod->lang ) )
+		if ( mchFruFieldGet( mchSys, &(prod->manuf),   raw, offset, prod->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(prod->prod),    raw, offset, prod->lang) )
+		if ( mchFruFieldGet( mchSys, &(prod->prod),    raw, offset, prod->lang) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(prod->part),    raw, offset, prod->lang ) )
+		if ( mchFruFieldGet( mchSys, &(prod->part),    raw, offset, prod->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(prod->version), raw, offset, prod->lang ) )
+		if ( mchFruFieldGet( mchSys, &(prod->version), raw, offset, prod->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(prod->sn),      raw, offset, prod->lang ) )
+		if ( mchFruFieldGet( mchSys, &(prod->sn),      raw, offset, prod->lang ) )
 			(*offset)++;
 	}
 }
@@ -521,7 +1170,7 @@ mchFruProdDataGet(FruProd prod, uint8_t *raw, unsigned *offset)
  * Caller must perform locking.
  */
 static void
-mchFruBoardDataGet(FruBoard board, uint8_t *raw, unsigned *offset)
+mchFruBoardDataGet(MchSys mchSys, FruBoard board, uint8_t *raw, unsigned *offset)
 {
 	if ( 0 != (*offset = 8*raw[FRU_DATA_COMMON_HEADER_OFFSET + FRU_DATA_COMMON_HEADER_BOARD_AREA_OFFSET] ) ) {
 
@@ -529,13 +1178,13 @@ mchFruBoardDataGet(FruBoard board, uint8_t *raw, unsigned *offset)
 
 		*offset += FRU_DATA_BOARD_AREA_MANUF_LENGTH_OFFSET;
 
-		if ( mchFruFieldGet( &(board->manuf), raw, offset, board->lang ) )
+		if ( mchFruFieldGet( mchSys, &(board->manuf), raw, offset, board->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(board->prod),  raw, offset, board->lang ) )
+		if ( mchFruFieldGet( mchSys, &(board->prod),  raw, offset, board->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(board->sn),    raw, offset, board->lang ) )
+		if ( mchFruFieldGet( mchSys, &(board->sn),    raw, offset, board->lang ) )
 			(*offset)++;
-		if ( mchFruFieldGet( &(board->part),  raw, offset, board->lang ) )
+		if ( mchFruFieldGet( mchSys, &(board->part),  raw, offset, board->lang ) )
 			(*offset)++;	       
 	}
 }
@@ -577,7 +1226,8 @@ int        rval;
 		printf("%s mchFruDataGet: FRU addr 0x%02x ID %i inventory info size %i\n", 
 		    mchSess->name, fru->sdr.addr, fru->sdr.fruId, sizeInt);
 
-	if ( !(raw = calloc( 1, sizeInt ) ) ) {
+	/* Pad so that field decoders reading in groups of 3 bytes stay in bounds */
+	if ( !(raw = mchArenaAlloc( &mchData->mchSys->arena, sizeInt + 3 ) ) ) {
 		printf("mchFruDataGet: No memory for FRU addr 0x%02x ID %i data\n", fru->sdr.addr, fru->sdr.fruId);
 		return -1;
 	}
@@ -620,10 +1270,9 @@ int        rval;
 	memset( &(fru->board),   0, sizeof( fru->board ) );
 	memset( &(fru->prod),    0, sizeof( fru->prod ) );
 	memset( &(fru->chassis), 0, sizeof( fru->chassis ) );
-	mchFruBoardDataGet( &(fru->board), raw, &offset );
-	mchFruProdDataGet(  &(fru->prod) , raw, &offset );
-	mchFruChassisDataGet( &(fru->chassis), raw, &offset );
-	free( raw );
+	mchFruBoardDataGet( mchData->mchSys, &(fru->board), raw, &offset );
+	mchFruProdDataGet(  mchData->mchSys, &(fru->prod) , raw, &offset );
+	mchFruChassisDataGet( mchData->mchSys, &(fru->chassis), raw, &offset );
 
 	return 0;
 }
@@ -681,7 +1330,7 @@ int rval = 0;
 			fru = &mchSys->fru[i];
 			if ( fru->sdr.fruId || (arrayToUint16( fru->size ) > 0) )
 				printf("SDR FRU index %i ID %i %i %s was found, ent id 0x%02x instance 0x%02x, addr 0x%02x id 0x%02x lun %i lkup %i\n", 
-				    i, fru->sdr.fruId, fru->id, fru->board.prod.data, fru->sdr.entityId, fru->sdr.entityInst, fru->sdr.addr, fru->sdr.fruId, 
+				    i, fru->sdr.fruId, fru->id, fru->board.prod.length ? (char *)fru->board.prod.data : "", fru->sdr.entityId, fru->sdr.entityInst, fru->sdr.addr, fru->sdr.fruId, 
 				    fru->sdr.lun, mchSys->fruLkup[fru->id]);
 		}
 	}
@@ -719,10 +1368,10 @@ Sensor sens   = &mchSys->sens[index];
 
 /* Caller must perform locking */
 static int
-mchSdrRepGetInfoMsg(MchData mchData, uint8_t *response, uint8_t parm, uint8_t addr) 
+mchSdrRepGetInfoMsg(MchData mchData, uint8_t *response, uint8_t parm, IpmiRoute route) 
 {
 
-	return mchMsgGetSdrRepInfoWrapper( mchData, response, parm, addr );
+	return mchMsgGetSdrRepInfoWrapper( mchData, response, parm, route );
 
 }
 
@@ -747,7 +1396,7 @@ uint32_t  add, del;
 uint32_t *addTs = &mchSys->sdrRep.addTs, *delTs = &mchSys->sdrRep.delTs;
 uint8_t   buff[MSG_MAX_LENGTH] = { 0 };
 
-	if ( mchSdrRepGetInfoMsg( mchData, buff, IPMI_SDRREP_PARM_GET_SDR, IPMI_MSG_ADDR_BMC ) )
+	if ( mchSdrRepGetInfoMsg( mchData, buff, IPMI_SDRREP_PARM_GET_SDR, &mchSys->route ) )
 		return 0;
 
 	mchSdrRepGetTs( buff, &add, &del );
@@ -773,13 +1422,13 @@ uint8_t   buff[MSG_MAX_LENGTH] = { 0 };
  * Caller must perform locking.
  */
 static int
-mchSdrRepGetInfo(MchData mchData, uint8_t parm, uint8_t addr, SdrRep sdrRep, uint32_t *sdrCount)
+mchSdrRepGetInfo(MchData mchData, uint8_t parm, IpmiRoute route, SdrRep sdrRep, uint32_t *sdrCount)
 {
 uint8_t response[MSG_MAX_LENGTH] = { 0 };
 uint8_t flags;
 int     rval;
 
-	rval = mchSdrRepGetInfoMsg( mchData, response, parm, addr );
+	rval = mchSdrRepGetInfoMsg( mchData, response, parm, route );
 
 	if (  parm == IPMI_SDRREP_PARM_GET_SDR ) {
 
@@ -992,9 +1641,8 @@ Mgmt mgmt;
 
 		if ( 0 == parm ) {
 			if ( (fru->entityCount = rval) > 0 ) {
-				if ( 0 == (fru->entity = calloc( rval, sizeof( EntityRec ) ) ) )
+				if ( 0 == (fru->entity = mchArenaAlloc( &mchSys->arena, rval*sizeof( EntityRec ) ) ) )
 					cantProceed("FATAL ERROR: No memory for FRU entity structure for %s\n", mchData->mchSess->name);
-				fru->entityAlloc = 1;
 			}
 		}
 	}
@@ -1005,9 +1653,8 @@ Mgmt mgmt;
 
 		if ( 0 == parm ) {
 			if ( (mgmt->entityCount = rval) > 0 ) {
-				if ( 0 == (mgmt->entity = calloc( rval, sizeof( EntityRec ) ) ) )
+				if ( 0 == (mgmt->entity = mchArenaAlloc( &mchSys->arena, rval*sizeof( EntityRec ) ) ) )
 					cantProceed("FATAL ERROR: No memory for MGMT entity structure for %s\n", mchData->mchSess->name);
-				mgmt->entityAlloc = 1;
 			}
 		}
 	}
@@ -1330,87 +1977,419 @@ printf("mchSdrFullSens: owner 0x%02x lun %i sdr number %i type 0x%02x, m %i, b %
 
 }
 
+/* Sensor reported not present: mark it unavailable and schedule next probe */
+static void
+mchSensorUnavail(SensorHot hot)
+{
+double delay = MCH_SENS_PROBE_MIN;
+int    i;
+
+	hot->stat |= SENS_STAT_UNAVAIL;
+	if ( hot->tries < 255 )
+		hot->tries++;
+
+	for ( i = 1; i < hot->tries && delay < MCH_SENS_PROBE_MAX; i++ )
+		delay *= 2;
+	if ( delay > MCH_SENS_PROBE_MAX )
+		delay = MCH_SENS_PROBE_MAX;
+
+	epicsTimeGetCurrent( &hot->probe );
+	epicsTimeAddSeconds( &hot->probe, delay );
+}
+
 /* If sensor read error or disabled, return error and indicate 'unavailable' in sensor data structure */
+/* Note hot-swap transition of a sensor's FRU and wake ping task to rediscover it:
+ * entering M4 (board activated), re-read inventory and device SDRs;
+ * entering M1 (inserted or deactivated), re-read inventory only;
+ * entering M0 (removed), clear inventory.
+ *
+ * Caller must perform locking.
+ */
+static void
+mchFruRescanRequest(MchData mchData, Sensor sens, uint8_t prev, uint8_t state)
+{
+MchSys  mchSys = mchData->mchSys;
+uint8_t what   = 0;
+
+	if ( sens->fruIndex < 0 || sens->fruIndex >= MAX_FRU )
+		return;
+
+	if ( MCH_HS_STATE( state, MCH_HS_M4 ) && !MCH_HS_STATE( prev, MCH_HS_M4 ) )
+		what = MCH_FRU_RESCAN_INV | MCH_FRU_RESCAN_SDR;
+	else if ( MCH_HS_STATE( state, MCH_HS_M1 ) && !MCH_HS_STATE( prev, MCH_HS_M1 ) )
+		what = MCH_FRU_RESCAN_INV;
+	else if ( MCH_HS_STATE( state, MCH_HS_M0 ) && !MCH_HS_STATE( prev, MCH_HS_M0 ) )
+		what = MCH_FRU_RESCAN_CLR;
+
+	if ( !what )
+		return;
+
+	if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_LOW )
+		printf("%s hot-swap sensor %s state 0x%02x -> 0x%02x; rediscover FRU index %i\n",
+		    mchData->mchSess->name, sens->sdr.str, prev, state, sens->fruIndex);
+
+	/* A later transition supersedes an earlier one not yet acted on */
+	mchSys->fruRescan[sens->fruIndex] = what;
+	mchSys->fruRescanPend = 1;
+	epicsEventSignal( mchData->mchSess->recoverEvent );
+}
+
+/* Find bulk read state of controller, adding it if not yet tracked
+ *
+ *   RETURNS: state, or NULL if table is full
+ */
+static MchBulkCtl
+mchBulkCtlFind(MchSys mchSys, uint8_t addr, uint8_t chan)
+{
+MchBulkCtl ctl;
+int        i;
+
+	for ( i = 0; i < mchSys->bulkCtlCount; i++ ) {
+		ctl = &mchSys->bulkCtl[i];
+		if ( ctl->addr == addr && ctl->chan == chan )
+			return ctl;
+	}
+
+	if ( mchSys->bulkCtlCount >= MCH_BULK_CTL_MAX )
+		return NULL;
+
+	ctl = &mchSys->bulkCtl[mchSys->bulkCtlCount++];
+	memset( ctl, 0, sizeof(*ctl) );
+	ctl->addr = addr;
+	ctl->chan = chan;
+	return ctl;
+}
+
+/* Store reading of one sensor from a bulk read; called by MCH type's sensor_read_bulk.
+ * data is what Get Sensor Reading would return: completion code, reading, enable bits, state.
+ * Readings of sensors not in configuration are ignored.
+ *
+ * Caller must perform locking.
+ */
+void
+mchSensorBulkStore(MchData mchData, uint8_t addr, uint8_t chan, uint8_t lun, uint8_t number, uint8_t *data, size_t length)
+{
+MchSys      mchSys = mchData->mchSys;
+MchBulkSlot slot;
+Sensor      s;
+int         i;
+
+	if ( !mchSys->bulk || length == 0 )
+		return;
+
+	if ( length > sizeof( slot->data ) )
+		length = sizeof( slot->data );
+
+	for ( i = 0; i < mchSys->sensCount; i++ ) {
+		s = &mchSys->sens[i];
+		if ( s->route.addr != addr || s->route.chan != chan || (s->sdr.lun & 0x3) != lun || s->sdr.number != number )
+			continue;
+		slot = &mchSys->bulk[i];
+		memcpy( slot->data, data, length );
+		slot->length = length;
+		slot->valid  = 1;
+		return;
+	}
+}
+
+/* Answer a sensor read from a bulk read of the sensor's controller. The bulk read
+ * is done if this sensor's stored reading has been used or is too old.
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS: completion code of sensor's reading, which is in response
+ *            -1 if sensor must be read with Get Sensor Reading
+ */
+static int
+mchSensorReadBulk(MchData mchData, uint8_t *response, Sensor sens)
+{
+MchSys      mchSys = mchData->mchSys;
+MchBulkSlot slot;
+MchBulkCtl  ctl;
+Sensor      s;
+epicsTimeStamp now;
+int         i;
+
+	if ( !mchSys->bulk || !mchSys->mchcb->sensor_read_bulk )
+		return -1;
+
+	if ( !(ctl = mchBulkCtlFind( mchSys, sens->route.addr, sens->route.chan )) || ctl->off )
+		return -1;
+
+	slot = &mchSys->bulk[sens - mchSys->sens];
+	epicsTimeGetCurrent( &now );
+
+	if ( !slot->valid || epicsTimeDiffInSeconds( &now, &ctl->ts ) > MCH_BULK_AGE_MAX ) {
+
+		/* Sensors missing from the new reply must not be answered from the old one */
+		for ( i = 0; i < mchSys->sensCount; i++ ) {
+			s = &mchSys->sens[i];
+			if ( s->route.addr == ctl->addr && s->route.chan == ctl->chan )
+				mchSys->bulk[i].valid = 0;
+		}
+
+		if ( mchSys->mchcb->sensor_read_bulk( mchData, ctl->addr, ctl->chan ) ) {
+			if ( ++ctl->fail >= MCH_BULK_FAIL_MAX ) {
+				ctl->off = 1;
+				if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) )
+					printf("%s bulk sensor read of controller 0x%02x failed %i times; reading its sensors individually\n",
+					    mchData->mchSess->name, ctl->addr, (int)ctl->fail);
+			}
+			return -1;
+		}
+
+		ctl->fail = 0;
+		ctl->ts   = now;
+		ctl->reads++;
+
+		if ( !slot->valid )
+			return -1;
+	}
+
+	slot->valid = 0;
+	memcpy( response, slot->data, slot->length );
+	mchSys->bulkHits++;
+
+	return response[0];
+}
+
+/* On success, the raw reading, status bits and timestamp are cached in the sensor's hot-state record */
+/* An unavailable sensor is only read when its re-probe is due; when it answers again it is
+ * returned to service and its thresholds are re-read
+ */
 int
 mchGetSensorReadingStat(MchData mchData, uint8_t *response, Sensor sens)//, uint8_t number, uint8_t lun, size_t *sensReadMsgLength)
 {
-uint8_t bits;
-uint8_t rval;
-size_t  tmp = sens->readMsgLength; /* Initially set to requested msg length, 
-				    * then mchMsgReadSensorWrapper sets it to actual message length */
+SensorHot hot = MCH_SENS_HOT( mchData->mchSys, sens );
+uint8_t bits, state;
+int     rval;
+int     seen;
+size_t  tmp = hot->readMsgLength; /* Initially set to requested msg length, 
+				   * then mchMsgReadSensorWrapper sets it to actual message length */
+epicsTimeStamp now;
+
+	if ( SENS_UNAVAIL( hot ) ) {
+		epicsTimeGetCurrent( &now );
+		if ( epicsTimeDiffInSeconds( &now, &hot->probe ) < 0 ) {
+			hot->err++;
+			return -1;
+		}
+	}
+
+	if ( (rval = mchSensorReadBulk( mchData, response, sens )) < 0 )
+		rval = mchMsgReadSensorWrapper( mchData, response, sens, &tmp );
+
+	/* If error code ... */
+	if ( rval ) {
+		if ( rval == IPMI_COMP_CODE_REQUESTED_DATA || rval == IPMI_COMP_CODE_DESTINATION_UNAVAIL )
+			mchSensorUnavail( hot );
+		hot->err++;
+		return -1;
+	}
+	else
+		hot->readMsgLength = tmp;
+
+	if ( SENS_UNAVAIL( hot ) ) {
+		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_LOW )
+			printf("%s mchGetSensorReadingStat: sensor %i %s available again\n", 
+			    mchData->mchSess->name, sens->sdr.number, sens->sdr.str);
+		hot->stat &= ~(SENS_STAT_UNAVAIL | SENS_STAT_CNFG); /* Have device support refresh record fields */
+		hot->tries = 0;
+		mchGetSensorThresh( mchSessPoolGet( mchData, MCH_WORK_THRESH ), sens );
+	}
+	seen = SENS_SEEN( hot );
+	hot->stat |= SENS_STAT_SEEN;
+
+	hot->bits = bits = response[IPMI_RPLY_IMSG2_SENSOR_ENABLE_BITS_OFFSET];
+	if ( IPMI_SENSOR_READING_DISABLED(bits) || IPMI_SENSOR_SCANNING_DISABLED(bits) ) {
+		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_LOW )
+			printf("%s mchGetSensorReadingStat: sensor %i reading/state unavailable or scanning disabled. Bits: %02x\n", 
+			    mchData->mchSess->name, sens->sdr.number, bits);
+		hot->stat |= SENS_STAT_DISABLED;
+		hot->err++;
+		return -1;
+	}
+
+	hot->stat &= ~SENS_STAT_DISABLED;
+	hot->val   = response[IPMI_RPLY_IMSG2_SENSOR_READING_OFFSET];
+	hot->err   = 0;
+	epicsTimeGetCurrent( &hot->ts );
+
+	/* First reading after configuration only establishes the M-state */
+	if ( sens->sdr.sensType == SENSOR_TYPE_HOTSWAP || sens->sdr.sensType == SENSOR_TYPE_HOTSWAP_NAT ) {
+		state = response[IPMI_RPLY_IMSG2_DISCRETE_SENSOR_READING_OFFSET];
+		if ( seen && state != hot->state )
+			mchFruRescanRequest( mchData, sens, hot->state, state );
+		hot->state = state;
+	}
+
+	return 0;
+}
+
+/*
+ * Get sensor thresholds and store them for use by device support.
+ * (Assuming thresholds do not change)
+ *
+ * Caller must perform locking.
+ */
+static void
+mchGetSensorThresh(MchData mchData, Sensor sens)
+{
+uint8_t  response[MSG_MAX_LENGTH] = { 0 };
+
+	sens->tmask = 0; /* Set default to no readable thresholds */
+
+	if ( IPMI_SENSOR_THRESH_IS_READABLE( IPMI_SDR_SENSOR_THRESH_ACCESS( sens->sdr.cap ) ) ) {
+
+		if (  mchMsgGetSensorThresholdsWrapper( mchData, response, sens ) ) {
+			if ( (MCH_DBG( mchStat[mchData->mchSess->instance]) >=  MCH_DBG_LOW) )
+				printf("%s mchGetSensorInfo: mchMsgGetSensorThresholds error, assume no thresholds are readable\n", mchData->mchSess->name);
+			return;
+		}
+
+		sens->tmask = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_MASK_OFFSET];
+		sens->tlnc  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LNC_OFFSET];
+		sens->tlc   = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LC_OFFSET];
+		sens->tlnr  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LNR_OFFSET];
+		sens->tunc  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UNC_OFFSET];
+		sens->tuc   = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UC_OFFSET];
+		sens->tunr  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UNR_OFFSET];
+
+		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_HIGH )
+			printf("sensor %s thresholds tmask 0x%02x, tlnc %i tlc %i tlnr %i tunc %i tuc %i tunr %i\n", 
+				sens->sdr.str, sens->tmask, sens->tlnc, sens->tlc, sens->tlnr, sens->tunc, sens->tuc, sens->tunr);
+	}
+}
+
+/*
+ * Read sensor to save sensor reading response length; it varies
+ * by sensor and this prevents read timeouts later.
+ * Get sensor thresholds.
+ *
+ * Caller must perform locking.
+ */
+static void
+mchGetSensorInfo(MchData mchData, Sensor sens)
+{
+uint8_t  response[MSG_MAX_LENGTH] = { 0 };
+SensorHot hot = MCH_SENS_HOT( mchData->mchSys, sens );
+
+	hot->readMsgLength = IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH;
+
+	if( !(MCH_ONLN( mchStat[mchData->mchSess->instance] )) ) {
+		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) )
+			printf("%s mchGetSensorInfo: MCH offline; aborting\n", mchData->mchSess->name);
+		return;
+	}
+
+	/* If sensor does not exist, do not read thresholds, etc.; they are read if it appears later */
+	mchGetSensorReadingStat( mchData, response, sens);
+
+	if ( SENS_UNAVAIL( hot ) )
+		return;
+
+	mchGetSensorThresh( mchData, sens );
+}
+
+/*
+ * FRU and management controller arrays come from the configuration arena
+ * and are sized from the locator records actually discovered, up to
+ * the architecture-dependent fruCountMax/mgmtCountMax.
+ *
+ * Make room for 'n' more records. Growing may move the array, so
+ * callers must not hold Fru/Mgmt pointers across these calls.
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS:
+ *           0 on success
+ *          -1 if no memory
+ */
+static int
+mchFruReserve(MchSys mchSys, size_t n)
+{
+size_t want = mchSys->fruCount + n;
+Fru    fru;
+
+	if ( want > mchSys->fruCountMax )
+		want = mchSys->fruCountMax;
+
+	if ( want <= mchSys->fruCap )
+		return 0;
+
+	if ( !(fru = mchArenaGrow( &mchSys->arena, mchSys->fru, mchSys->fruCap*sizeof(*fru), want*sizeof(*fru) )) )
+		return -1;
+
+	mchSys->fru    = fru;
+	mchSys->fruCap = want;
+	return 0;
+}
+
+static int
+mchMgmtReserve(MchSys mchSys, size_t n)
+{
+size_t want = mchSys->mgmtCount + n;
+Mgmt   mgmt;
 
-	rval = mchMsgReadSensorWrapper( mchData, response, sens, &tmp );
+	if ( want > mchSys->mgmtCountMax )
+		want = mchSys->mgmtCountMax;
 
-	/* If error code ... */
-	if ( rval ) {
-		if ( rval == IPMI_COMP_CODE_REQUESTED_DATA || rval == IPMI_COMP_CODE_DESTINATION_UNAVAIL )
-			sens->unavail = 1;
-		return -1;
-	}
-	else
-		sens->readMsgLength = tmp;
+	if ( want <= mchSys->mgmtCap )
+		return 0;
 
-	bits = response[IPMI_RPLY_IMSG2_SENSOR_ENABLE_BITS_OFFSET];
-	if ( IPMI_SENSOR_READING_DISABLED(bits) || IPMI_SENSOR_SCANNING_DISABLED(bits) ) {
-		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_LOW )
-			printf("%s mchGetSensorReadingStat: sensor %i reading/state unavailable or scanning disabled. Bits: %02x\n", 
-			    mchData->mchSess->name, sens->sdr.number, bits);
+	if ( !(mgmt = mchArenaGrow( &mchSys->arena, mchSys->mgmt, mchSys->mgmtCap*sizeof(*mgmt), want*sizeof(*mgmt) )) )
 		return -1;
-	}
 
+	mchSys->mgmt    = mgmt;
+	mchSys->mgmtCap = want;
 	return 0;
 }
 
 /*
- * Read sensor to save sensor reading response length; it varies
- * by sensor and this prevents read timeouts later.
- * Get sensor thresholds and store them for use by device support.
- * (Assuming thresholds do not change)
+ * Append a FRU record to the FRU array, growing it if needed
  *
  * Caller must perform locking.
+ *
+ *   RETURNS:
+ *           pointer to new, zeroed FRU record
+ *           NULL if fruCountMax reached or no memory
  */
-static void
-mchGetSensorInfo(MchData mchData, Sensor sens)
+Fru
+mchFruAdd(MchData mchData)
 {
-uint8_t  response[MSG_MAX_LENGTH] = { 0 };
-size_t   sensReadMsgLength;
-
-	sensReadMsgLength = sens->readMsgLength = IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH;
+MchSys mchSys = mchData->mchSys;
 
-	if( !(MCH_ONLN( mchStat[mchData->mchSess->instance] )) ) {
-		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) )
-			printf("%s mchGetSensorInfo: MCH offline; aborting\n", mchData->mchSess->name);
-		return;
+	if ( mchSys->fruCount >= mchSys->fruCountMax ) {
+		printf("ERROR: %s discovered more than %i FRUs, the maximum supported.\n", 
+		    mchData->mchSess->name, (int)mchSys->fruCountMax);
+		return NULL;
 	}
 
-	/* If sensor does not exist, do not read thresholds, etc. */
-	mchGetSensorReadingStat( mchData, response, sens);
-
-	if ( sens->unavail )
-		return;
-
-	sens->tmask = 0; /* Set default to no readable thresholds */
+	if ( mchFruReserve( mchSys, 1 ) ) {
+		printf("ERROR: %s no memory for FRU data\n", mchData->mchSess->name);
+		return NULL;
+	}
 
-	if ( IPMI_SENSOR_THRESH_IS_READABLE( IPMI_SDR_SENSOR_THRESH_ACCESS( sens->sdr.cap ) ) ) {
+	return &mchSys->fru[mchSys->fruCount++];
+}
 
-		if (  mchMsgGetSensorThresholdsWrapper( mchData, response, sens ) ) {
-			if ( (MCH_DBG( mchStat[mchData->mchSess->instance]) >=  MCH_DBG_LOW) )
-				printf("%s mchGetSensorInfo: mchMsgGetSensorThresholds error, assume no thresholds are readable\n", mchData->mchSess->name);
-			return;
-		}
+static Mgmt
+mchMgmtAdd(MchData mchData)
+{
+MchSys mchSys = mchData->mchSys;
 
-		sens->tmask = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_MASK_OFFSET];
-		sens->tlnc  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LNC_OFFSET];
-		sens->tlc   = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LC_OFFSET];
-		sens->tlnr  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_LNR_OFFSET];
-		sens->tunc  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UNC_OFFSET];
-		sens->tuc   = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UC_OFFSET];
-		sens->tunr  = response[IPMI_RPLY_IMSG2_SENSOR_THRESH_UNR_OFFSET];
+	if ( mchSys->mgmtCount >= mchSys->mgmtCountMax ) {
+		printf("ERROR: %s discovered more than %i MGMTs, the maximum supported.\n", 
+		    mchData->mchSess->name, (int)mchSys->mgmtCountMax);
+		return NULL;
+	}
 
-		if ( MCH_DBG( mchStat[mchData->mchSess->instance] ) >= MCH_DBG_HIGH )
-			printf("sensor %s thresholds tmask 0x%02x, tlnc %i tlc %i tlnr %i tunc %i tuc %i tunr %i\n", 
-				sens->sdr.str, sens->tmask, sens->tlnc, sens->tlc, sens->tlnr, sens->tunc, sens->tuc, sens->tunr);
+	if ( mchMgmtReserve( mchSys, 1 ) ) {
+		printf("ERROR: %s no memory for Management Controller data\n", mchData->mchSess->name);
+		return NULL;
 	}
+
+	return &mchSys->mgmt[mchSys->mgmtCount++];
 }
 
 /* 'owner' and 'chan' args are address/channel of owner; used only for device-relative entity assocation record
@@ -1442,9 +2421,10 @@ DevEntAssoc devEntAssoc;
 				break;
 			sens = &mchSys->sens[mchSys->sensCount];
 			mchSdrFullSens( &sens->sdr , raw, type );
+			mchRouteInit( &sens->route, sens->sdr.owner, (sens->sdr.lun >> 4) );
 			sens->instance = 0; /* Initialize instance to 0 */
 			mchGetSensorInfo( mchData, sens );
-			sens->cnfg = 0;
+			MCH_SENS_HOT( mchSys, sens )->stat &= ~SENS_STAT_CNFG;
 			mchSys->sensCount++;
 
 			break;
@@ -1454,9 +2434,10 @@ DevEntAssoc devEntAssoc;
 				break;
 			sens = &mchSys->sens[mchSys->sensCount];
 			mchSdrFullSens( &sens->sdr , raw, type );
+			mchRouteInit( &sens->route, sens->sdr.owner, (sens->sdr.lun >> 4) );
 			sens->instance = 0; /* Initialize instance to 0 */
 			mchGetSensorInfo( mchData, sens );
-			sens->cnfg = 0;
+			MCH_SENS_HOT( mchSys, sens )->stat &= ~SENS_STAT_CNFG;
 			mchSys->sensCount++;
 
 			break;
@@ -1465,16 +2446,12 @@ DevEntAssoc devEntAssoc;
 			if ( mchSdrFruDuplicate( mchSys, raw ) )
 				break;
 
-			if ( mchSys->fruCount >= mchSys->fruCountMax ) {
-				printf("ERROR: %s discovered %i FRUs but only allocated memory for %i.\n", 
-				    mchData->mchSess->name, mchSys->fruCount, (int)mchSys->fruCountMax);
+			if ( !(fru = mchFruAdd( mchData )) )
 				return -1;
-			}
 
-			fru = &mchSys->fru[mchSys->fruCount];
 			mchSdrFruDev( &fru->sdr, raw );
+			mchRouteInit( &fru->route, fru->sdr.addr, fru->sdr.chan );
 			fru->instance = 0;     /* Initialize instance to 0 */
-			mchSys->fruCount++;
 
 			break;
 
@@ -1482,15 +2459,11 @@ DevEntAssoc devEntAssoc;
 			if ( mchSdrMgmtCtrlDuplicate( mchSys, raw ) )
             	break;
 
-			if ( mchSys->mgmtCount >= mchSys->mgmtCountMax ) {
-				printf("ERROR: %s discovered %i MGMTs but only allocated memory for %i.\n", 
-				    mchData->mchSess->name, mchSys->mgmtCount, (int)mchSys->mgmtCountMax);
+			if ( !(mgmt = mchMgmtAdd( mchData )) )
 				return -1;
-			}
 
-			mgmt = &mchSys->mgmt[mchSys->mgmtCount];
 			mchSdrMgmtCtrlDev( &mgmt->sdr, raw );
-			mchSys->mgmtCount++;
+			mchRouteInit( &mgmt->route, mgmt->sdr.addr, mgmt->sdr.chan );
 
 			break;
 
@@ -1526,36 +2499,17 @@ DevEntAssoc devEntAssoc;
 	return 0;
 }
 
-static void *
-ipmiReallocZeros(void *dest, size_t old_size, size_t new_size, int flag)
-{
-	if ( flag )
-		dest = realloc( dest, new_size );
-	else
-		dest = realloc( NULL, new_size );
-
-	 if ( 0 == dest) {
-		dest = NULL;
-		goto bail;
-	}
-
-	memset( dest + old_size, 0, new_size - old_size );
-
-bail:
-	return dest;
-}
-
 /* First read of SDR to get record length */
 
 static int				  
-mchSdrGetLength(MchData mchData, uint8_t parm, uint8_t addr, SdrRep sdrRep, uint8_t *id, uint8_t *res, uint8_t *response)
+mchSdrGetLength(MchData mchData, uint8_t parm, IpmiRoute route, SdrRep sdrRep, uint8_t *id, uint8_t *res, uint8_t *response)
 {
 uint8_t  offset = 0;
 int      size = 5; /* readSize = 5 because 5th byte is remaining record length; 0xFF reads entire record */
 int      err = 0;
 
 	while ( err <= 3 ) {
-		if ( (mchMsgGetSdrWrapper( mchData, response, id, res, offset, size, parm, addr )) ) {
+		if ( (mchMsgGetSdrWrapper( mchData, response, id, res, offset, size, parm, route )) ) {
 			err++;
 		}
 		else
@@ -1569,6 +2523,9 @@ int      err = 0;
  * once to get record length, then to read record. This prevents timeouts,
  * saving much delay. 
  *
+ * Route to repository owner at addr/chan is built once for all of its
+ * records; a copy is used since the mgmt array can move while SDRs are stored.
+ *
  * Caller must perform locking.
  */				  
 static int				  
@@ -1581,27 +2538,56 @@ uint32_t sdrCount;
 uint8_t  id[2]  = { 0 }, nextid[2]  = { 0 };
 uint8_t  res[2] = { 0 };
 Sensor   sens   = 0;
+SensorHot hot   = 0;
 uint8_t  offset = 0;
 uint8_t  type   = 0;
 uint8_t *raw    = 0;
+uint8_t **raws  = 0;  /* Raw SDRs read from this repository */
+uint8_t *types  = 0;  /* Record types of raws */
+int      nread  = 0, nfru = 0, nmgmt = 0;
 int      size; /* SDR record read size (after header) */
 uint32_t sdrCount_i  = mchSys->sdrCount; /* Initial SDR count */
-int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0;
+int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0, readFailed = 0;
+IpmiRouteRec route;
+
+	mchRouteInit( &route, addr, chan );
 
-	if ( mchSdrRepGetInfo( mchData, parm, addr, sdrRep, &sdrCount ) )
+	if ( mchSdrRepGetInfo( mchData, parm, &route, sdrRep, &sdrCount ) )
 		return rval;
 
-	/* Reluctant to statically assign memory to this structure because
-	 * size can vary so widely. For now, alloc dynamically and free
+	/* Size can vary so widely that sensor storage is grown per SDR repository.
+	 * Memory comes from the configuration arena and is released
 	 * when configuration is re-read
 	 */
-	if ( !(mchSys->sens = ipmiReallocZeros( mchSys->sens, sdrCount_i*sizeof(*sens), (sdrCount_i+sdrCount)*sizeof(*sens), mchSys->sensAlloc ) ) ) {
+	if ( !(sens = mchArenaGrow( &mchSys->arena, mchSys->sens, sdrCount_i*sizeof(*sens), (sdrCount_i+sdrCount)*sizeof(*sens) ) ) ) {
 		printf("mchSdrGetData: No memory for sensor data for %s\n", mchSess->name);
 		goto bail;
 	}
-	mchSys->sensAlloc = 1;
+	mchSys->sens = sens;
+
+	/* Hot-state array is kept parallel to sens */
+	if ( !(hot = mchArenaGrow( &mchSys->arena, mchSys->hot, sdrCount_i*sizeof(*hot), (sdrCount_i+sdrCount)*sizeof(*hot) ) ) ) {
+		printf("mchSdrGetData: No memory for sensor state for %s\n", mchSess->name);
+		goto bail;
+	}
+	mchSys->hot = hot;
+
+	/* So is bulk read state, if MCH type has bulk read */
+	if ( mchSys->mchcb && mchSys->mchcb->sensor_read_bulk ) {
+		if ( !(mchSys->bulk = mchArenaGrow( &mchSys->arena, mchSys->bulk, sdrCount_i*sizeof(*mchSys->bulk), (sdrCount_i+sdrCount)*sizeof(*mchSys->bulk) )) ) {
+			printf("mchSdrGetData: No memory for bulk read state for %s\n", mchSess->name);
+			goto bail;
+		}
+		memset( mchSys->bulk + sdrCount_i, 0, sdrCount*sizeof(*mchSys->bulk) );
+	}
+
+	if ( !(raws = mchArenaAlloc( &mchSys->arena, sdrCount*sizeof(*raws) )) || 
+	     !(types = mchArenaAlloc( &mchSys->arena, sdrCount )) ) {
+		printf("mchSdrGetData: No memory for raw SDR list for %s\n", mchSess->name);
+		goto bail;
+	}
 
-	if ( mchMsgReserveSdrRepWrapper( mchData, response, parm, addr ) ) {
+	if ( mchMsgReserveSdrRepWrapper( mchData, response, parm, &route ) ) {
 		printf("mchSdrGetData: Error reserving SDR repository %s\n", mchSess->name);
 		goto bail;
 	}
@@ -1610,16 +2596,17 @@ int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0;
 
 	for ( i = 0; i < sdrCount; i++) { /* memset raw to zeros on each sdr? */
 
-		if ( !(raw = calloc( 1, SDR_MAX_LENGTH ) ) ) {
+		if ( !(raw = mchArenaAlloc( &mchSys->arena, SDR_MAX_LENGTH ) ) ) {
 			printf("mchSdrGetData: No memory for raw SDR data for %s\n", mchSess->name);
 			goto bail;
 		}
 
 		/* If failed to read this SDR, cannot get ID for subsequent units. */
-		if ( mchSdrGetLength( mchData, parm, addr, sdrRep, id, res, response) ) {
+		if ( mchSdrGetLength( mchData, parm, &route, sdrRep, id, res, response) ) {
 			sdrFailedCount++;
 			printf("%s cannot read SDR %i nor subsequent SDRs\n", mchSess->name, i);
-			goto bail;
+			readFailed = 1;
+			break;
 		}
 		nextid[0]  = response[IPMI_RPLY_IMSG2_GET_SDR_NEXT_ID_LSB_OFFSET];
 		nextid[1]  = response[IPMI_RPLY_IMSG2_GET_SDR_NEXT_ID_MSB_OFFSET];
@@ -1636,7 +2623,7 @@ int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0;
 		offset = 0;
 
 		while ( size > 0 ) {
-			if ( mchMsgGetSdrWrapper( mchData, response, id, res, offset, size, parm, addr ) ) {
+			if ( mchMsgGetSdrWrapper( mchData, response, id, res, offset, size, parm, &route ) ) {
 				/* If too many errors, break out of while loop, move on to next SDR */
 				if ( err++ > 3 )
 					break;
@@ -1659,8 +2646,13 @@ int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0;
 			sdrFailedCount++;
 			continue;
 		}
-		if ( mchSdrStoreData( mchData, raw, type, addr, chan ) )
-			goto bail;
+		raws[nread]  = raw;
+		types[nread] = type;
+		nread++;
+		if ( type == SDR_TYPE_FRU_DEV )
+			nfru++;
+		else if ( type == SDR_TYPE_MGMT_CTRL_DEV )
+			nmgmt++;
 
 		id[0] = nextid[0];
 		id[1] = nextid[1];
@@ -1668,6 +2660,21 @@ int      rval = -1, err = 0, sdrFailedCount = 0, i, remainder = 0;
 		if ( arrayToUint16( id ) == SDR_ID_LAST_SENSOR ) /* last record in SDR */
 			break;
        	}
+
+	/* Size FRU and MGMT arrays from the locator records just read, then store everything */
+	if ( mchFruReserve( mchSys, nfru ) || mchMgmtReserve( mchSys, nmgmt ) ) {
+		printf("mchSdrGetData: No memory for FRU/MGMT data for %s\n", mchSess->name);
+		goto bail;
+	}
+
+	for ( i = 0; i < nread; i++ ) {
+		if ( mchSdrStoreData( mchData, raws[i], types[i], addr, chan ) )
+			goto bail;
+	}
+
+	if ( readFailed )
+		goto bail;
+
 	mchSys->sdrCount += sdrCount;
 	rval = 0;
 
@@ -1675,11 +2682,51 @@ bail:
 	if ( sdrFailedCount > 0 ) 
 	    printf("%s: failed to read %i SDRs due to too many read errors\n", mchSess->name, sdrFailedCount);
 
-	if ( raw )
-		free( raw );
 	return rval;
 }
 
+/*
+ * Read SDRs of one (non-primary) management controller: send Get Device ID,
+ * then read its SDR repository or, if it has none, its device SDRs.
+ * Device ID response is left in response.
+ *
+ * Note: reading SDRs can grow (and move) the mgmt array.
+ *
+ * Caller must perform locking.
+ *
+ *   RETURNS: 0 if Get Device ID succeeded (even if SDRs could not be read)
+ *            -1 on error
+ */
+static int
+mchMgmtSdrGet(MchData mchData, int index, uint8_t *response)
+{
+MchSys  mchSys = mchData->mchSys;
+Mgmt    mgmt   = &mchSys->mgmt[index];
+uint8_t addr   = mgmt->sdr.addr;
+uint8_t chan   = mgmt->sdr.chan;
+
+	if ( mchMsgGetDeviceIdWrapper( mchData, response, &mgmt->route ) ) {
+		printf("mchMgmtSdrGet: Error from Get Device ID command to mgmt controller at addr 0x%02x\n", addr);
+		return -1;
+	}
+
+	/* If supports SDR... */
+	if ( (IPMI_DEV_CAP_SDRREP( response[IPMI_RPLY_IMSG2_GET_DEVICE_ID_SUPPORT_OFFSET] ) ) ) { 
+		if ( mchSdrGetData( mchData, IPMI_SDRREP_PARM_GET_SDR, addr, chan, &mgmt->sdrRep ) ) {
+			printf("mchMgmtSdrGet: Error in reading mgmt %i SDR\n", index);
+		}
+	}
+	/* Else if supports device SDR... */
+	else if ( IPMI_DEVICE_PROVIDES_DEVICE_SDR(response[IPMI_RPLY_IMSG2_GET_DEVICE_ID_DEVICE_VERS_OFFSET]) ) { 
+
+		if ( mchSdrGetData( mchData, IPMI_SDRREP_PARM_GET_DEV_SDR, addr, chan, &mgmt->sdrRep ) ) {
+			printf("mchMgmtSdrGet: Error in reading mgmt %i SDR\n", index);
+		}
+	}
+
+	return 0;
+}
+
 static int				  
 mchSdrGetDataAll(MchData mchData)
 {
@@ -1705,42 +2752,29 @@ uint8_t  chan = 0;
 
 		mgmt = &mchSys->mgmt[i];
 		addr = mgmt->sdr.addr;
-		chan = mgmt->sdr.chan;
 
 		/* Skip primary BMC; already queried */
 		if ( addr == IPMI_MSG_ADDR_BMC )
 			continue;
 
-		if ( mchMsgGetDeviceIdWrapper( mchData, response, addr ) ) {
-			printf("mchSdrGetDataAll: Error from Get Device ID command to mgmt controller at addr 0x%02x\n", addr);
+		if ( mchMgmtSdrGet( mchData, i, response ) )
 			continue;
-		}
-
-		/* If supports SDR... */
-		if ( (IPMI_DEV_CAP_SDRREP( response[IPMI_RPLY_IMSG2_GET_DEVICE_ID_SUPPORT_OFFSET] ) ) ) { 
-			if ( mchSdrGetData( mchData, IPMI_SDRREP_PARM_GET_SDR, addr, chan, &mgmt->sdrRep ) ) {
-				printf("mchSdrGetDataAll: Error in reading mgmt %i SDR\n", i);
-			}
-		}
-		/* Else if supports device SDR... */
-		else if ( IPMI_DEVICE_PROVIDES_DEVICE_SDR(response[IPMI_RPLY_IMSG2_GET_DEVICE_ID_DEVICE_VERS_OFFSET]) ) { 
 
-			if ( mchSdrGetData( mchData, IPMI_SDRREP_PARM_GET_DEV_SDR, addr, chan, &mgmt->sdrRep ) ) {
-				printf("mchSdrGetDataAll: Error in reading mgmt %i SDR\n", i);
-			}
-		}
+		/* Reading SDRs can grow (and move) the mgmt array; re-fetch mgmt */
+		mgmt = &mchSys->mgmt[i];
 
 		/* If provides FRU info, create a FRU instance for it in our data structure */
 		if ( (IPMI_DEV_CAP_FRU_INV( response[IPMI_RPLY_IMSG2_GET_DEVICE_ID_SUPPORT_OFFSET] ) ) ) { 
 
-			fru = &mchSys->fru[mchSys->fruCount];
-			mchSys->fruCount++;
+			if ( !(fru = mchFruAdd( mchData )) )
+				continue;
 			fru->sdr.addr  = mgmt->sdr.addr;
 			fru->sdr.chan  = mgmt->sdr.chan;
 			fru->sdr.fruId = 0; /* Arbitrarily set to 0 */
 			fru->sdr.entityId   = mgmt->sdr.entityId;
 			fru->sdr.entityInst = mgmt->sdr.entityInst;
 			fru->sdr.recType    = mgmt->sdr.recType; /* Because recType is used as validity check in various places */			
+			fru->route          = mgmt->route;
 		}
 	}
 
@@ -1879,7 +2913,12 @@ int     online = 0, tries = 0;
 
 	while (1) {
 
-		epicsThreadSleep( PING_PERIOD );
+		/* Woken early if a session must be re-established */
+		if ( epicsEventWaitWithTimeout( mchSess->recoverEvent, PING_PERIOD ) == epicsEventWaitOK ) {
+			mchSessRecover( mch );
+			mchFruRescan( mch );
+			continue;
+		}
 
 		cos = 0;
 
@@ -1910,6 +2949,18 @@ int     online = 0, tries = 0;
 				mchStatSet( inst, MCH_MASK_ONLN, MCH_MASK_ONLN );
 				cos = 1;
 			}
+			/* Retry failed session re-establishment */
+			mchSessRecover( mch );
+
+			/* Keep idle session from expiring */
+			mchSessKeepalive( mch );
+
+			/* Read new System Event Log entries; events trigger sensor reads */
+			mchSelPoll( mch );
+
+			/* Rediscover FRUs whose hot-swap state changed */
+			mchFruRescan( mch );
+
 			/* Every 30 seconds (while mch online), set flag to check if system configuration has changed */
 			if ( i > 30/PING_PERIOD ) {
 				mchStatSet( inst, MCH_MASK_CNFG_CHK, MCH_MASK_CNFG_CHK );
@@ -1948,7 +2999,7 @@ int    inst   = mchData->mchSess->instance;
 	}
 
 	else if ( MCH_INIT_DONE( mchStat[inst] ) ) { 
-		if ( mchSdrRepTsDiff( mchData ) )
+		if ( mchSdrRepTsDiff( mchSessPoolGet( mchData, MCH_WORK_CNFG ) ) )
 			return mchCnfg( mchData, MCH_CNFG_NOT_INIT );
 	}
 
@@ -2019,6 +3070,9 @@ IpmiSess ipmiSess = mchData->ipmiSess;
 
 	if ( mchSess->type == MCH_TYPE_VT )
 		ipmiSess->features |= MCH_FEAT_SENDMSG_RPLY;		
+
+	if ( !mchSess->keepaliveUser )
+		mchSess->keepalive = mchKeepaliveDefault[mchSess->type];
 }	
 
 static void
@@ -2050,7 +3104,7 @@ uint8_t  tmp[4] = { 0 }, vers;
 uint32_t mf;
 void    *mchcb = 0;
 
-	if ( mchMsgGetDeviceIdWrapper( mchData, response, IPMI_MSG_ADDR_BMC ) ) {
+	if ( mchMsgGetDeviceIdWrapper( mchData, response, &mchData->mchSys->route ) ) {
 		printf("mchIdentify: Error from Get Device ID command\n");
 		mchMsgCloseSess( mchSess, mchData->ipmiSess, response );
 		return -1;
@@ -2155,8 +3209,8 @@ Sensor  sens;
 					continue;
 				}
 
-				if ( !sens->unavail )
-					mchSys->sensLkup[index][sens->sdr.sensType][sens->instance] = j;
+				/* Index unavailable sensors too, so they are picked up if they appear later */
+				mchSys->sensLkup[index][sens->sdr.sensType][sens->instance] = j;
 			}
 		}
 	}
@@ -2174,7 +3228,7 @@ Sensor  sens;
 					sens->sdr.str, sens->sdr.number, sens->sdr.sensType, sens->instance, fru->sdr.addr, 
 					fru->sdr.entityId, fru->sdr.entityInst, sens->sdr.owner, sens->sdr.entityId, 
 					sens->sdr.entityInst, sens->sdr.recType, fru->id, mchSys->fruLkup[fru->id], 
-					sens->fruIndex, sens->unavail);
+					sens->fruIndex, SENS_UNAVAIL( &mchSys->hot[i] ) ? 1 : 0);
 			}
 			else if ( sens->mgmtIndex != -1 ) {
 				mgmt  = &mchSys->mgmt[sens->mgmtIndex];
@@ -2182,61 +3236,63 @@ Sensor  sens;
 				"Sens owner 0x%02x EntId 0x%02x EntInst 0x%02x RecType %i Unavail %i\n",
 					sens->sdr.str, sens->sdr.number, sens->sdr.sensType, sens->instance, mgmt->sdr.addr, 
 					mgmt->sdr.entityId, mgmt->sdr.entityInst, sens->sdr.owner, sens->sdr.entityId, 
-					sens->sdr.entityInst, sens->sdr.recType, sens->unavail);
+					sens->sdr.entityInst, sens->sdr.recType, SENS_UNAVAIL( &mchSys->hot[i] ) ? 1 : 0);
 			}
 			else
 				printf("Sensor %s %i Type 0x%02x Inst %i EntId 0x%02x EntInst 0x%02x RecType %i "
 					"no corresponding FRU or MGTM unavail %i\n",
 					sens->sdr.str, sens->sdr.number, sens->sdr.sensType, sens->instance, sens->sdr.entityId, 
-					sens->sdr.entityInst, sens->sdr.recType, sens->unavail);
+					sens->sdr.entityInst, sens->sdr.recType, SENS_UNAVAIL( &mchSys->hot[i] ) ? 1 : 0);
 		}
 	}
 }
 
 /*
- * Free memory and set flag to 0
- * Use flag to know that memory was successfully
- * allocated and later to know if it was actually
- * freed.
- * (Can't just test the pointer because even 
- *  after free, a pointer still contains the previous
- *  address even though it is no longer valid.)
+ * Release the previous configuration generation.
+ * FRU and management controller arrays are allocated as locator records are found.
  */
-static void
-freememory(void *ptr, int *flag)
-{
-        if ( *flag ) {
-                free( ptr );
-		ptr = NULL;
-                *flag = 0;
-        }
-}
-
 static void
 mchCnfgReset(MchData mchData) {
 MchSys mchSys = mchData->mchSys;
-int i;
-
-	if ( mchSys->fru ) { /* If FRU struct already allocated */
-		for ( i = 0; i < mchSys->fruCountMax ; i++ )
-			freememory( mchSys->fru[i].entity, &mchSys->fru[i].entityAlloc );
-
-		memset( mchSys->fru,  0, mchSys->fruCountMax*sizeof(FruRec)   );
-	}
-
-	if ( mchSys->mgmt ) { /* If Mgmt struct already allocated */
-		for ( i = 0; i < mchSys->mgmtCountMax ; i++ )
-			freememory( mchSys->mgmt[i].entity, &mchSys->mgmt[i].entityAlloc );
-
-		memset( mchSys->mgmt, 0, mchSys->mgmtCountMax*sizeof(MgmtRec) );
-	}
+int    i;
 
 	/* move this to reset values routine, add fruid, fuindex, etc. */
 	set3DArrayVals( MAX_FRU_MGMT, MAX_SENSOR_TYPE, MAX_SENS_INST, mchSys->sensLkup, -1 );
 	set1DArrayVals( MAX_FRU_MGMT, mchSys->fruLkup, -1 );
 
-	/* Free memory for previously allocated sensor array */
-	freememory( mchSys->sens, &mchSys->sensAlloc );
+	/* One operation frees sensors, FRUs, MGMTs, entity arrays, FRU strings and raw data */
+	mchArenaFree( &mchSys->arena );
+	mchSys->sens = 0;
+	mchSys->hot  = 0;
+	mchSys->bulk = 0;
+	mchSys->fru  = 0;
+	mchSys->mgmt = 0;
+	mchSys->fruCap = mchSys->mgmtCap = 0;
+	mchSys->fruStrBytes = 0;
+
+	/* Full configuration supersedes pending FRU rediscovery */
+	memset( mchSys->fruRescan, 0, sizeof( mchSys->fruRescan ) );
+	mchSys->fruRescanPend = 0;
+
+	/* Controllers may have changed */
+	mchSys->bulkCtlCount = 0;
+
+	/* Bridged targets may have changed */
+	for ( i = 0; i < mchData->poolSize; i++ )
+		mchBrkReset( mchData->pool[i]->mchSess );
+}
+
+/* Point each hot-state record at its configuration-time sensor data.
+ * Done once all SDRs have been read because the sens array may
+ * be reallocated as each SDR repository is read.
+ */
+static void
+mchSensorHotLink(MchSys mchSys)
+{
+int i;
+
+	for ( i = 0; i < mchSys->sensCount; i++ )
+		mchSys->hot[i].sens = &mchSys->sens[i];
 }
 
 /* Get info about MCH, shelf, FRUs, sensors
@@ -2248,6 +3304,7 @@ static int
 mchCnfg(MchData mchData, int initFlag) {
 MchSess mchSess = mchData->mchSess;
 MchSys  mchSys  = mchData->mchSys;
+MchData work;
 int inst = mchSess->instance;
 int i;
 
@@ -2259,10 +3316,11 @@ int i;
 	mchStatSet( inst, MCH_MASK_DBG, MCH_DBG_SET(MCH_DBG_MED) ); */
 
 	/* Initiate communication session with MCH */
-	if ( mchCommStart( mchSess, mchData->ipmiSess ) ) {
+	if ( mchCommStart( mchSess, mchData->ipmiSess, 0 ) ) {
 		printf("Error initiating session with %s; cannot complete initialization\n",mchSess->name);
 		goto bail;
 	}
+	mchSess->recover = 0;
 
         /* Determine MCH type */
         if ( mchIdentify( mchData ) ) {
@@ -2270,22 +3328,11 @@ int i;
 		goto bail;
 	}
 
-	/* If first time executing this routine, perform some startup-only tasks */
-	if ( initFlag == MCH_CNFG_INIT ) {
-		if ( !(mchSys->fru = calloc( 1, mchSys->fruCountMax*sizeof(FruRec) )) )
-			cantProceed("FATAL ERROR: No memory for FRU data for %s\n", mchData->mchSess->name);
-
-		if ( !(mchSys->mgmt = calloc( 1, mchSys->mgmtCountMax*sizeof(MgmtRec) )) )
-			cantProceed("FATAL ERROR: No memory for Management Controller data for %s\n", mchData->mchSess->name);
-
-		for ( i = 0; i < mchSys->fruCountMax ; i++ ) {
-			mchSys->fru[i].entityAlloc  = 0; /* Indicates memory has not been allocated for fru entity array;  this supports alloc/free scheme */
-		}
-		for ( i = 0; i < mchSys->mgmtCountMax ; i++ ) {
-			mchSys->mgmt[i].entityAlloc = 0; /* Indicates memory has not been allocated for mgmt entity array; this supports alloc/free scheme */
-		}
+	/* Pooled sessions need MCH type-dependent settings */
+	mchSessPoolStart( mchData );
 
-	}
+	/* Discovery uses its own session, if there is a pool */
+	work = mchSessPoolGet( mchData, MCH_WORK_CNFG );
 
 	/* Moved to after mchIdentify so that max fru/mgmt counts are defined */
 	mchCnfgReset( mchData );
@@ -2294,13 +3341,15 @@ int i;
 	mchSys->sdrCount = mchSys->sensCount = mchSys->fruCount = mchSys->mgmtCount = 0;
 
        	/* Get SDR data */
-       	if ( mchSdrGetDataAll( mchData ) ) {
+       	if ( mchSdrGetDataAll( work ) ) {
        		printf("Failed to read %s SDR; cannot complete initialization\n",mchSess->name);
 		goto bail;
        	}
 
+	mchSensorHotLink( mchSys );
+
 	/* Get FRU data; errors are not fatal, but could cause missing FRU data */
-	mchFruGetDataAll( mchData );
+	mchFruGetDataAll( work );
  
 		/* Comment this out for now; it always happens at the end of initialization and it is confusing
 		printf("Warning: errors getting %s FRU data; some data may be missing\n",mchSess->name);
@@ -2374,6 +3423,8 @@ int      inst;
 
 	mchStatMtx[inst] = epicsMutexMustCreate(); /* Used for global mchStat mask */
 
+	mchSess->recoverEvent = epicsEventMustCreate( epicsEventEmpty );
+
 	/* Allocate and initialize memory for MCH device support structure */
 	if ( ! (mch = devMchRegister( name )) )
 		printf("FATAL ERROR: Unable to register MCH %s with device support\n", name);
@@ -2381,33 +3432,143 @@ int      inst;
 	mchData->ipmiSess = ipmiSess;
 	mchData->mchSess = mchSess;
 	mchData->mchSys  = mchSys;
+	mchData->pool[0]  = mchData; /* Primary session; mchSessPool adds more */
+	mchData->poolSize = 1;
 
 	strncpy( mchSess->name, mch->name, MAX_NAME_LENGTH );
 	strncpy( mchSys->name,  mch->name, MAX_NAME_LENGTH ); // okay to remove this and from drvMch.h?
 	mch->udata = mchData;
+	mchDevList[inst] = mch;
 
 	/* Set default maximum counts (for this device) for FRU/MGMT to max
 	 * Individual device types can override this in callbacks
 	 */
 	mchSys->fruCountMax  = MAX_FRU;
 	mchSys->mgmtCountMax = MAX_MGMT;
-	mchSys->sensAlloc = 0; /* Indicates memory has not been allocated for sensor struct; this supports alloc/free scheme */
+	mchArenaInit( &mchSys->arena, MCH_ARENA_BLK_SIZE_DEFAULT );
+	mchRouteInit( &mchSys->route, IPMI_MSG_ADDR_BMC, 0 );
 
 	mchSess->timeout = ipmiSess->timeout = RPLY_TIMEOUT_SENDMSG_RPLY; /* Default, until determine type */
 	mchSess->session = 1;   /* Default: enable session with MCH */
 
 	/* For sensor record scanning */
 	scanIoInit( &drvSensorScan[inst] );
+	scanIoInit( &drvSelScan[inst] );
 
 	/* Start task to continue initialization and periodically ping MCH */
 	sprintf( taskName, "%s-PING", mch->name ); 
 	mchSess->pingThreadId = epicsThreadMustCreate( taskName, epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackMedium), mchPing, mch );
 }
 
+/*
+ * Memory used by FRU/MGMT data with arrays sized from the discovered
+ * configuration and FRU strings stored out of line, and the memory that
+ * would be used with arrays of fruCountMax/mgmtCountMax and in-line strings
+ *
+ * Caller must perform locking.
+ */
+static void
+mchFruMgmtMemUsage(MchSys mchSys, size_t *used, size_t *fixed)
+{
+	*used  = mchSys->fruCap*sizeof(FruRec) + mchSys->mgmtCap*sizeof(MgmtRec) + mchSys->fruStrBytes;
+	*fixed = mchSys->fruCountMax*(sizeof(FruRec) - FRU_FIELD_COUNT*sizeof(FruFieldRec) + FRU_FIELD_COUNT*FRU_FIELD_INLINE_SIZE)
+	       + mchSys->mgmtCountMax*sizeof(MgmtRec);
+}
+
 static long
 drvMchReport(int level)
 {
+MchDev  mch;
+MchData mchData;
+MchSys  mchSys;
+size_t  used, fixed;
+size_t  typeUsed[MCH_TYPE_MAX] = { 0 }, typeFixed[MCH_TYPE_MAX] = { 0 };
+int     typeCount[MCH_TYPE_MAX] = { 0 };
+int     i, j, n, type;
+MchBrk  brk;
+MchData d;
+
 	printf("IPMI communication driver support\n");
+
+	if ( level < 1 )
+		return 0;
+
+	for ( i = 0; i < mchCounter; i++ ) {
+
+		if ( !(mch = mchDevList[i]) || !(mchData = mch->udata) )
+			continue;
+
+		mchSys = mchData->mchSys;
+
+		epicsMutexLock( mch->mutex );
+
+		type = mchData->mchSess->type;
+		if ( type < 0 || type >= MCH_TYPE_MAX )
+			type = MCH_TYPE_UNKNOWN;
+
+		mchFruMgmtMemUsage( mchSys, &used, &fixed );
+
+		printf("  %s (%s): %i FRUs (%i allocated, max %i), %i MGMTs (%i allocated, max %i), %i sensors\n",
+		    mch->name, mchDescString[type], 
+		    mchSys->fruCount,  (int)mchSys->fruCap,  (int)mchSys->fruCountMax,
+		    mchSys->mgmtCount, (int)mchSys->mgmtCap, (int)mchSys->mgmtCountMax, mchSys->sensCount);
+		printf("    FRU/MGMT data %lu bytes (%lu bytes if sized to max), FRU strings %lu bytes\n",
+		    (unsigned long)used, (unsigned long)fixed, (unsigned long)mchSys->fruStrBytes);
+		printf("    config arena generation %u: %lu bytes used, %lu bytes in %u blocks, peak %lu\n",
+		    (unsigned)mchSys->arena.gen, (unsigned long)mchSys->arena.used, (unsigned long)mchSys->arena.size,
+		    mchSys->arena.nblk, (unsigned long)mchSys->arena.peak);
+
+		printf("    session restarts %u (%u failed), last handshake %.3f s, total %.3f s\n",
+		    (unsigned)mchData->mchSess->sessRestarts, (unsigned)mchData->mchSess->sessRestartFails,
+		    mchData->mchSess->sessHandshakeLast, mchData->mchSess->sessHandshakeTotal);
+		printf("    keepalive window %.0f s, %u keepalives sent\n",
+		    mchData->mchSess->keepalive, (unsigned)mchData->mchSess->keepalives);
+
+		if ( mchData->mchSys->sel.disabled )
+			printf("    SEL reader disabled (not supported)\n");
+		else
+			printf("    SEL: %u polls, %u entries read, last record ID 0x%04x, %u sensor records processed on events\n",
+			    (unsigned)mchData->mchSys->sel.polls, (unsigned)mchData->mchSys->sel.entries,
+			    mchData->mchSys->sel.lastId, (unsigned)mchData->mchSys->sel.triggered);
+		printf("    %u FRUs rediscovered after hot-swap transitions\n", (unsigned)mchData->mchSys->fruRescans);
+		if ( mchSys->bulk ) {
+			for ( j = 0, n = 0; j < mchSys->bulkCtlCount; j++ )
+				n += mchSys->bulkCtl[j].off;
+			printf("    bulk sensor reads: %u sensor reads answered, %i controllers tracked, %i read per sensor\n",
+			    (unsigned)mchSys->bulkHits, mchSys->bulkCtlCount, n);
+		}
+
+		for ( j = 1; j < mchData->poolSize; j++ ) {
+			d = mchData->pool[j];
+			printf("    pooled session %s: %s, restarts %u (%u failed), %u keepalives\n",
+			    d->mchSess->name, d->mchSess->recover ? "not established" : "active",
+			    (unsigned)d->mchSess->sessRestarts, (unsigned)d->mchSess->sessRestartFails, (unsigned)d->mchSess->keepalives);
+		}
+
+		for ( j = 0; j < mchData->mchSess->brkCount; j++ ) {
+			brk = &mchData->mchSess->brk[j];
+			if ( brk->open || level > 1 )
+				printf("    target 0x%02x chan %i: %s, %u consecutive failures, quarantined %u times, %u requests skipped\n",
+				    brk->addr, brk->chan, brk->open ? "QUARANTINED" : "ok", 
+				    (unsigned)brk->fail, (unsigned)brk->trips, (unsigned)brk->skipped);
+		}
+
+		epicsMutexUnlock( mch->mutex );
+
+		typeUsed[type]  += used;
+		typeFixed[type] += fixed;
+		typeCount[type]++;
+	}
+
+	printf("  FRU/MGMT memory by MCH type:\n");
+	for ( type = 0; type < MCH_TYPE_MAX; type++ ) {
+		if ( typeCount[type] == 0 )
+			continue;
+		printf("    %-24s %3i MCH(s): %8lu bytes, saved %8lu bytes\n",
+		    mchDescString[type], typeCount[type], (unsigned long)typeUsed[type], 
+		    (unsigned long)( typeFixed[type] > typeUsed[type] ? typeFixed[type] - typeUsed[type] : 0 ));
+	}
+
 	return 0;
 }
 
@@ -2443,6 +3604,157 @@ mchInitCallFunc(const iocshArgBuf *args)
 	mchInit(args[0].sval);
 }
 
+/* Set session keepalive idle window for an MCH; call after mchInit */
+static void
+mchKeepalive(const char *name, double seconds)
+{
+MchDev  mch;
+MchSess mchSess;
+
+	if ( !name || !(mch = devMchFind( name )) || !mch->udata ) {
+		printf("mchKeepalive: MCH %s not found; call mchInit first\n", name ? name : "");
+		return;
+	}
+
+	mchSess = ((MchData)mch->udata)->mchSess;
+
+	epicsMutexLock( mch->mutex );
+	mchSess->keepalive     = ( seconds > 0 ) ? seconds : 0;
+	mchSess->keepaliveUser = 1;
+	epicsMutexUnlock( mch->mutex );
+}
+
+/* Use RMCP+ (IPMI v2.0, 'lanplus') sessions with the given cipher suite; call after mchInit.
+ * Without this, RMCP+ is used only if the BMC supports no IPMI v1.5 authentication type we know.
+ * Suite 0 restores the default. Takes effect when the next session is started.
+ */
+static void
+mchRmcpp(const char *name, int suite)
+{
+MchDev  mch;
+MchSess mchSess;
+
+	if ( !name || !(mch = devMchFind( name )) || !mch->udata ) {
+		printf("mchRmcpp: MCH %s not found; call mchInit first\n", name ? name : "");
+		return;
+	}
+
+	mchSess = ((MchData)mch->udata)->mchSess;
+
+#ifdef IPMI_RMCPP
+	if ( suite && !ipmiRmcppSuiteValid( suite ) ) {
+		printf("mchRmcpp: unsupported cipher suite %i; use 1, 2, 3, 15, 16 or 17\n", suite);
+		return;
+	}
+#else
+	if ( suite ) {
+		printf("mchRmcpp: ipmiComm was built without RMCP+ support (IPMI_RMCPP in configure/CONFIG_APP)\n");
+		return;
+	}
+#endif
+
+	/* Re-read authentication capabilities so that the next session uses the new setting */
+	epicsMutexLock( mch->mutex );
+	mchSess->rmcppSuite = suite;
+	mchSess->authKnown  = 0;
+	epicsMutexUnlock( mch->mutex );
+}
+
+/* Add sessions to an MCH's session pool; call after mchInit, before iocInit.
+ * Each pooled session gets its own asyn port, <port name>.<n>, connected to hostInfo.
+ * Sessions are started once the MCH has been identified.
+ */
+static void
+mchSessPool(const char *name, int size, const char *hostInfo)
+{
+MchDev   mch;
+MchData  mchData, d;
+int      i;
+
+	if ( postIocStart ) {
+		printf("mchSessPool: Error: call before iocInit\n");
+		return;
+	}
+
+	if ( !name || !(mch = devMchFind( name )) || !(mchData = mch->udata) ) {
+		printf("mchSessPool: MCH %s not found; call mchInit first\n", name ? name : "");
+		return;
+	}
+
+	if ( !hostInfo || !hostInfo[0] ) {
+		printf("mchSessPool: host info (for example \"%s:623 udp\") is required\n", name);
+		return;
+	}
+
+	if ( size > MCH_SESS_POOL_MAX ) {
+		printf("mchSessPool: %s pool size %i exceeds maximum, using %i\n", name, size, MCH_SESS_POOL_MAX);
+		size = MCH_SESS_POOL_MAX;
+	}
+
+	for ( i = mchData->poolSize; i < size; i++ ) {
+
+		if ( ! (d = calloc( 1, sizeof( *d ))) || ! (d->mchSess = calloc( 1, sizeof( *d->mchSess ))) || 
+		     ! (d->ipmiSess = calloc( 1, sizeof( *d->ipmiSess ))) )
+			cantProceed("FATAL ERROR: No memory for pooled session for %s\n", name);
+
+		snprintf( d->mchSess->name, MAX_NAME_LENGTH, "%s.%i", name, i );
+
+		if ( drvAsynIPPortConfigure( d->mchSess->name, hostInfo, 0, 0, 0 ) ) {
+			printf("mchSessPool: failed to create asyn port %s for %s\n", d->mchSess->name, hostInfo);
+			free( d->ipmiSess );
+			free( d->mchSess );
+			free( d );
+			break;
+		}
+
+		d->mchSys                = mchData->mchSys;
+		d->ipmiSess->wrf         = mchData->ipmiSess->wrf;
+		d->mchSess->instance     = mchData->mchSess->instance;
+		d->mchSess->recoverEvent = mchData->mchSess->recoverEvent;
+		d->mchSess->recover      = 1; /* Not yet established */
+		mchSessPoolSync( mchData, d );
+
+		epicsMutexLock( mch->mutex );
+		mchData->pool[i]  = d;
+		mchData->poolSize = i + 1;
+		epicsMutexUnlock( mch->mutex );
+	}
+}
+
+static const iocshArg mchSessPoolArg0        = { "port name",iocshArgString};
+static const iocshArg mchSessPoolArg1        = { "pool size",iocshArgInt};
+static const iocshArg mchSessPoolArg2        = { "host info",iocshArgString};
+static const iocshArg *mchSessPoolArgs[3]    = { &mchSessPoolArg0, &mchSessPoolArg1, &mchSessPoolArg2 };
+static const iocshFuncDef mchSessPoolFuncDef = { "mchSessPool", 3, mchSessPoolArgs };
+
+static void 
+mchSessPoolCallFunc(const iocshArgBuf *args)
+{
+	mchSessPool(args[0].sval, args[1].ival, args[2].sval);
+}
+
+static const iocshArg mchKeepaliveArg0        = { "port name",iocshArgString};
+static const iocshArg mchKeepaliveArg1        = { "idle seconds (0 to disable)",iocshArgDouble};
+static const iocshArg *mchKeepaliveArgs[2]    = { &mchKeepaliveArg0, &mchKeepaliveArg1 };
+static const iocshFuncDef mchKeepaliveFuncDef = { "mchKeepalive", 2, mchKeepaliveArgs };
+
+static void 
+mchKeepaliveCallFunc(const iocshArgBuf *args)
+{
+	mchKeepalive(args[0].sval, args[1].dval);
+}
+
+static const iocshArg mchRmcppArg0        = { "port name",iocshArgString};
+static const iocshArg mchRmcppArg1        = { "cipher suite (0 for default)",iocshArgInt};
+static const iocshArg *mchRmcppArgs[2]    = { &mchRmcppArg0, &mchRmcppArg1 };
+static const iocshFuncDef mchRmcppFuncDef = { "mchRmcpp", 2, mchRmcppArgs };
+
+static void 
+mchRmcppCallFunc(const iocshArgBuf *args)
+{
+	mchRmcpp(args[0].sval, args[1].ival);
+}
+
 static void
 drvMchRegisterCommands(void)
 {
@@ -2450,6 +3762,9 @@ drvMchRegisterCommands(void)
 	if ( firstTime ) {
 		initHookRegister(mchInitHook);
 		iocshRegister(&mchInitFuncDef, mchInitCallFunc);
+		iocshRegister(&mchKeepaliveFuncDef, mchKeepaliveCallFunc);
+		iocshRegister(&mchSessPoolFuncDef, mchSessPoolCallFunc);
+		iocshRegister(&mchRmcppFuncDef, mchRmcppCallFunc);
 		firstTime = 0;
 	}
 }
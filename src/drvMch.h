@@ -11,8 +11,11 @@
 #define DRV_MCH_H
 
 #include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsTime.h>
 #include <devMch.h>
 #include <ipmiDef.h>
+#include <drvMchArena.h>
 
 #define MAX_FRU             255   // 0xFF reserved, according to IPMI 2.0 spec
 #define MAX_MGMT            32    // management controller device, arbitrary limit, may need adjusting
@@ -30,6 +33,9 @@ extern epicsMutexId mchStatMtx[MAX_MCH];
 /* Used for sensor scanning; one list per MCH */
 extern IOSCANPVT drvSensorScan[MAX_MCH];
 
+/* Used to update event log records when new SEL entries are read; one list per MCH */
+extern IOSCANPVT drvSelScan[MAX_MCH];
+
 /* Vadatech typically sends 2 replies; NAT sends 1 */
 #define RPLY_TIMEOUT_SENDMSG_RPLY    0.50
 #define RPLY_TIMEOUT_DEFAULT         0.25
@@ -94,8 +100,8 @@ typedef struct MgmtRec_ {
 	uint8_t      instance;      /* Instance of management controller set in drvMch.c - needed? */
 	SdrMgmtRec   sdr;
 	SdrRepRec    sdrRep;
-	EntityRec    *entity;       /* Array of associated entities that should be considered subsets of this management controller */
-	int          entityAlloc;   /* Flag indicating entity array memory has been allocated and can be freed during configuration update*/
+	IpmiRouteRec route;         /* Route to this controller, set when SDR is stored */
+	EntityRec    *entity;       /* Array of associated entities that should be considered subsets of this management controller (from config arena) */
 	int          entityCount;   /* Count of entities contained by this management controller */
 } MgmtRec, *Mgmt;
 
@@ -113,6 +119,8 @@ typedef struct FruRec_ {
 	FruBoardRec  board;
 	FruProdRec   prod;
 	SdrFruRec    sdr;
+	IpmiRouteRec route;         /* Route to controller that provides FRU data, set with sdr.addr/chan */
+	IpmiRouteRec cmRoute;       /* NAT only: twice-bridged route via carrier manager; set on first use */
 	char         parm[10];      /* Describes FRU type, used to load EPICS records */
 	uint8_t      pwrDyn;        /* 1 if FRU supports dynamic reconfiguration of power, otherwise 0 */
 	uint8_t      pwrDly;        /* Delay to stable power */
@@ -122,26 +130,25 @@ typedef struct FruRec_ {
         uint8_t      fanNom;        /* Fan nominal level */   
         uint8_t      fanProp;       /* [7] 1 if fan try supports automatic fan speed adjustment */
 	int          mgmtIndex;     /* If associated with management controller, index into Mgmt array; else -1 */
-	EntityRec    *entity;       /* Array of associated entities that should be considered subsets of this FRU */
-	int          entityAlloc;   /* Flag indicating entity array memory has been allocated and can be freed during configuration update*/
+	EntityRec    *entity;       /* Array of associated entities that should be considered subsets of this FRU (from config arena) */
 	int          entityCount;   /* Count of entities contained by this FRU */
 /* Next section used only for PICMG systems */
 	uint8_t      siteNumber;    /* Maps to physical location, slot number */
 	uint8_t      siteType;      /* Maps to physical location, slot number */
 } FruRec, *Fru;
 
-/* Handle for each SDR */
+/* Handle for each SDR
+ * Holds data that is set at configuration time and rarely read afterward;
+ * per-scan state lives in the parallel SensorHotRec array (see below)
+ */
 typedef struct SensorRec_ {
 	SdrFullRec    sdr;          /* Full Sensor SDR */
-        uint8_t       val;          /* Most recent sensor reading */
+	IpmiRouteRec  route;        /* Route to sensor owner, set when SDR is stored */
 	int           fruId;        /* FRU ID for associated FRU ( -1 if no associated FRU ) */
 	int           fruIndex;     /* Index into FRU array for associated FRU ( -1 if no associated FRU ) */
 	int           mgmtIndex;    /* Index into Mgmt array for associated Management Controller ( -1 if no associated MGMT ) */
 	uint8_t       instance;     /* Instance of this sensor type on this entity (usually a FRU) */
-	int           unavail;      /* 1 if sensor reading returns 'Requested Sensor, data, or record not present' */
 	char          parm[10];     /* Describes signal type, used by device support */
-	size_t        readMsgLength;/* Get Sensor Reading message response length */
-	int           cnfg;         /* 0 if needs record fields need to be updated */
 	uint8_t       tmask;        /* Mask of which thresholds are readable */
 	uint8_t       tlnc;         /* Threshold lower non-critical */
 	uint8_t       tlc;          /* Threshold lower critical */
@@ -149,8 +156,128 @@ typedef struct SensorRec_ {
 	uint8_t       tunc;         /* Threshold upper non-critical */
 	uint8_t       tuc;          /* Threshold upper critical */
 	uint8_t       tunr;         /* Threshold upper non-recoverable */
+	void         *rec;          /* Record that reads this sensor, set by device support; processed on SEL events */
 } SensorRec, *Sensor;
 
+/* Per-sensor state touched on every scan
+ * Kept in a dense array (mchSys->hot) indexed in parallel with mchSys->sens
+ * so that sweeping all sensors does not pull SDR data into the cache
+ */
+typedef struct SensorHotRec_ {
+	uint8_t        val;           /* Most recent sensor reading (raw) */
+	uint8_t        stat;          /* Sensor status bits, see SENS_STAT_xxx below */
+	uint8_t        bits;          /* Enable/scanning bits from most recent sensor reading */
+	uint8_t        readMsgLength; /* Get Sensor Reading message response length */
+	uint8_t        tries;         /* Count of sequential 'not present' replies; sets re-probe backoff */
+	uint8_t        state;         /* Hot-swap sensors: M-state bits of most recent reading */
+	uint32_t       err;           /* Count of sequential sensor read errors */
+	epicsTimeStamp ts;            /* Time of most recent successful sensor reading */
+	epicsTimeStamp probe;         /* If unavailable, earliest time to read sensor again */
+	SensorRec     *sens;          /* Configuration-time data (SDR template) for this sensor */
+} SensorHotRec, *SensorHot;
+
+#define SENS_STAT_UNAVAIL        (1<<0) /* 1 if sensor reading returns 'Requested Sensor, data, or record not present' */
+#define SENS_STAT_CNFG           (1<<1) /* 1 if record fields have been updated from SDR */
+#define SENS_STAT_DISABLED       (1<<2) /* 1 if most recent reading reported reading/scanning disabled */
+#define SENS_STAT_SEEN           (1<<3) /* 1 if sensor has been read successfully since configuration */
+#define SENS_UNAVAIL(x)          ((x)->stat & SENS_STAT_UNAVAIL)
+#define SENS_CNFG(x)             ((x)->stat & SENS_STAT_CNFG)
+#define SENS_SEEN(x)             ((x)->stat & SENS_STAT_SEEN)
+
+/* Unavailable sensors are re-probed with exponential backoff:
+ * MCH_SENS_PROBE_MIN after the first 'not present' reply, doubling up to MCH_SENS_PROBE_MAX.
+ * Requests in between fail without being sent.
+ */
+#define MCH_SENS_PROBE_MIN       10.0   /* seconds */
+#define MCH_SENS_PROBE_MAX       600.0  /* seconds */
+
+/* Hot-state record for a sensor in the mchSys->sens array */
+#define MCH_SENS_HOT(sys, s)     (&(sys)->hot[(s) - (sys)->sens])
+
+/* Hot-swap M-states (bit number in hot-swap sensor reading) */
+#define MCH_HS_M0                0  /* Not installed */
+#define MCH_HS_M1                1  /* Inactive */
+#define MCH_HS_M4                4  /* Active */
+#define MCH_HS_STATE(x, m)       ((x) & (1<<(m)))
+
+/* Per-FRU rediscovery requested from a hot-swap transition; done by ping task (see mchFruRescan) */
+#define MCH_FRU_RESCAN_INV       (1<<0) /* Re-read FRU inventory */
+#define MCH_FRU_RESCAN_SDR       (1<<1) /* Re-read device SDRs of FRU's management controller */
+#define MCH_FRU_RESCAN_CLR       (1<<2) /* FRU removed; clear inventory */
+
+/* Circuit breaker for a bridged target (IPMB address/channel behind the MCH).
+ * After MCH_BRK_THRESHOLD consecutive timeouts the target is quarantined:
+ * requests to it fail immediately, except for one probe per backoff interval.
+ * Backoff doubles after each failed probe, from MCH_BRK_BACKOFF_MIN to MCH_BRK_BACKOFF_MAX.
+ */
+#define MCH_BRK_MAX              64     /* Max bridged targets tracked per MCH; untracked targets are never quarantined */
+#define MCH_BRK_THRESHOLD        5      /* Consecutive failures that quarantine a target */
+#define MCH_BRK_BACKOFF_MIN      2.0    /* Initial probe interval (seconds) */
+#define MCH_BRK_BACKOFF_MAX      300.0  /* Maximum probe interval (seconds) */
+
+typedef struct MchBrkRec_ {
+	uint8_t        addr;          /* Target IPMB address */
+	uint8_t        chan;          /* Target channel */
+	uint8_t        open;          /* 1 if target is quarantined */
+	uint32_t       fail;          /* Count of consecutive failures */
+	double         backoff;       /* Current probe interval (seconds) */
+	epicsTimeStamp probe;         /* Earliest time of next probe, if open */
+	uint32_t       trips;         /* Number of times target was quarantined */
+	uint32_t       skipped;       /* Requests failed without being sent */
+} MchBrkRec, *MchBrk;
+
+/* Bulk sensor reads (see sensor_read_bulk in MchCbRec).
+ * If the MCH type can return the readings of all sensors of a controller in one
+ * reply, the first read of one of those sensors in a sweep fetches them all and
+ * the others are answered from the result. A stored reading is used at most once,
+ * and only within MCH_BULK_AGE_MAX of the exchange. Sensors missing from the reply,
+ * and all sensors of a controller whose bulk read fails MCH_BULK_FAIL_MAX times
+ * in a row, are read with Get Sensor Reading.
+ */
+#define MCH_BULK_CTL_MAX         32     /* Max controllers tracked per MCH; sensors of others are read individually */
+#define MCH_BULK_AGE_MAX         2.0    /* Max age of a stored reading (seconds) */
+#define MCH_BULK_FAIL_MAX        3      /* Consecutive failures after which a controller is read per sensor */
+
+typedef struct MchBulkCtlRec_ {
+	uint8_t        addr;          /* Controller IPMB address */
+	uint8_t        chan;          /* Controller channel */
+	uint8_t        off;           /* 1 if bulk read is not used for this controller */
+	uint32_t       fail;          /* Count of consecutive failed bulk reads */
+	uint32_t       reads;         /* Count of successful bulk reads */
+	epicsTimeStamp ts;            /* Time of most recent successful bulk read */
+} MchBulkCtlRec, *MchBulkCtl;
+
+/* Result of bulk read for one sensor, in the form of a Get Sensor Reading reply */
+typedef struct MchBulkSlotRec_ {
+	uint8_t        valid;         /* 1 if stored by most recent bulk read of controller and not yet used */
+	uint8_t        length;        /* Bytes in data */
+	uint8_t        data[IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH]; /* Completion code, reading, enable bits, state */
+} MchBulkSlotRec, *MchBulkSlot;
+
+/* Incremental System Event Log (SEL) reader, run by ping task.
+ * Each poll sends Get SEL Info; only if the most recent addition or erase timestamp
+ * changed are the new entries read, starting after the last one already read.
+ * Entries that predate the IOC are skipped.
+ */
+#define MCH_SEL_READ_MAX         32     /* Max entries read per poll; remainder are read on next poll */
+#define MCH_SEL_LOG_MAX          16     /* Number of decoded events kept for event log waveform */
+#define MCH_SEL_LOG_LENGTH       96     /* Max length of one decoded event */
+
+typedef struct MchSelRec_ {
+	int            disabled;      /* 1 if MCH does not support SEL commands */
+	int            primed;        /* 1 once position in SEL has been established */
+	int            haveLast;      /* 1 if lastId is an entry in the SEL */
+	uint16_t       lastId;        /* Record ID of most recent entry read */
+	uint32_t       addTs;         /* SEL 'most recent addition' timestamp, when all entries had been read */
+	uint32_t       eraseTs;       /* SEL 'most recent erase' timestamp, when all entries had been read */
+	uint32_t       polls;         /* Count of Get SEL Info requests answered */
+	uint32_t       entries;       /* Count of new entries read */
+	uint32_t       triggered;     /* Count of sensor records processed because of an event (SEL or LAN alert) */
+	char           log[MCH_SEL_LOG_MAX][MCH_SEL_LOG_LENGTH]; /* Most recent decoded events, ring buffer */
+	int            logHead;       /* Index of next log entry to write */
+	int            logCount;      /* Number of log entries in use */
+} MchSelRec, *MchSel;
+
 /* Struct for MCH session information */
 typedef struct MchSessRec_ {
 	char    name[MAX_NAME_LENGTH];  /* MCH port name used by asyn */
@@ -160,18 +287,36 @@ typedef struct MchSessRec_ {
 	int           session;       /* Enable session with MCH */
 	int           err;           /* Count of sequential message errors */         
 	int           type;          /* MCH vendor, Vadatech, NAT, etc. - need to clean this up, perhaps merge with vendor and/or add 'features' */
+	MchBrkRec     brk[MCH_BRK_MAX]; /* Circuit breakers for bridged targets */
+	int           brkCount;      /* Number of brk entries in use */
+	MchBrk        brkCur;        /* Breaker of target of request in progress; NULL if not bridged or untracked */
+	int           authKnown;     /* 1 if channel authentication capabilities have been read */
+	int           recover;       /* 1 if session must be re-established; done by ping task */
+	epicsEventId  recoverEvent;  /* Wakes ping task to re-establish session or rediscover a hot-swapped FRU */
+	uint32_t      sessRestarts;  /* Count of sessions re-established by ping task */
+	uint32_t      sessRestartFails; /* Count of failed attempts to re-establish session */
+	double        sessHandshakeLast;  /* Duration of most recent session handshake (seconds) */
+	double        sessHandshakeTotal; /* Total time spent in session re-establishment handshakes (seconds) */
+	epicsTimeStamp lastTraffic;  /* Time of most recent in-session reply */
+	double        keepalive;     /* Idle time (seconds) after which ping task sends keepalive; 0 to disable */
+	int           keepaliveUser; /* 1 if keepalive set with mchKeepalive; overrides per-type default */
+	uint32_t      keepalives;    /* Count of keepalive messages sent */
+	int           rmcppSuite;    /* RMCP+ cipher suite set with mchRmcpp; 0 to use RMCP+ only if no IPMI v1.5 auth type is supported */
+	int           rmcpp;         /* RMCP+ cipher suite of this session; 0 for IPMI v1.5 session */
 } MchSessRec, *MchSess;
 
 /* Struct for MCH system information */
 typedef struct MchSysRec_ {
 	char    name[MAX_NAME_LENGTH]; /* MCH port name used by asyn */
 	SdrRepRec     sdrRep;
+	IpmiRouteRec  route;         /* Route to BMC */
 	uint32_t      sdrCount;
 	uint8_t       fruCount;      /* FRU device count */
 	size_t        fruCountMax;   /* Max number of supported FRUs. Architecture-dependent. Implemented to reduce memory usage */
 	size_t        mgmtCountMax;  /* Max number of supported MGMTs. Architecture-dependent. Implemented to reduce memory usage */
 	size_t        sensCountMax;  /* Max number of supported sensors. Architecture-dependent. Implemented to reduce memory usage */
-	FruRec       *fru;           /* Array of FRUs (size of MAX_FRU) */
+	FruRec       *fru;           /* Array of FRUs (size of fruCap) */
+	size_t        fruCap;        /* Allocated FRU array length; sized from FRU locator records, at most fruCountMax */
 	int           fruLkup[MAX_FRU_MGMT];/* Element values of fruLkup are indices into data arrays for FRUs (and Management Controllers that provide FRU data)
                                              * Indices of fruLkup are 'ids' of FRU/MGMT, which may be chosen arbitrarily for each platform
 					     * in order to provide consistent IDs in device support addresses
@@ -182,21 +327,44 @@ typedef struct MchSysRec_ {
 				     /* First index is FRU index (not FRU ID) */
 	int           sensCount;     /* Sensor count, data type must be larger than MAX_FRU_MGMT*MAX_SENSOR_TYPE*MAX_SENS_INST */
 	SensorRec    *sens;          /* Array of sensors (size of sensCount) */
-	int           sensAlloc;     /* Flag indicating sensor array memory has been allocated and can be freed during configuration update*/
+	SensorHotRec *hot;           /* Array of per-sensor scan state, parallel to sens (size of sensCount) */
 	uint8_t       mgmtCount;     /* Management controller device count */
-	MgmtRec      *mgmt;          /* Array of management controller devices (size of mgmtCount) */	
+	MgmtRec      *mgmt;          /* Array of management controller devices (size of mgmtCap) */	
+	size_t        mgmtCap;       /* Allocated MGMT array length; sized from locator records, at most mgmtCountMax */
 	MchCbRec     *mchcb;         /* Callbacks for architecture-specific functionality */
 	EntAssocRec entAssoc[10];
 	int            entAssocCount;
 	DevEntAssocRec devEntAssoc[10];
 	int            devEntAssocCount;
+	size_t         fruStrBytes;  /* Bytes of FRU inventory strings (raw and converted) */
+	MchArenaRec    arena;        /* Storage for sens, hot, fru, mgmt, entity arrays and raw SDR/FRU data;
+	                              * one generation per configuration, released by mchCnfgReset */
+	MchSelRec      sel;          /* System Event Log reader state; kept across configurations */
+	uint8_t        fruRescan[MAX_FRU]; /* Pending rediscovery per FRU index, MCH_FRU_RESCAN_xxx bits */
+	int            fruRescanPend; /* 1 if any fruRescan entry is set */
+	uint32_t       fruRescans;   /* Count of FRUs rediscovered after hot-swap transitions */
+	MchBulkSlotRec *bulk;        /* Bulk read results, parallel to sens (from config arena); NULL if MCH type has no bulk read */
+	MchBulkCtlRec  bulkCtl[MCH_BULK_CTL_MAX]; /* Bulk read state per controller that owns sensors */
+	int            bulkCtlCount; /* Number of bulkCtl entries in use */
+	uint32_t       bulkHits;     /* Count of sensor reads answered from a bulk read */
 } MchSysRec, *MchSys;
 
+/* Workloads that may be given their own session from the session pool (see mchSessPool) */
+#define MCH_WORK_SENSOR          0  /* Periodic sensor sweep; always primary session */
+#define MCH_WORK_CNFG            1  /* Discovery: SDR and FRU inventory reads */
+#define MCH_WORK_CTRL            2  /* Control writes: chassis control, FRU activation, fan level */
+#define MCH_WORK_THRESH          3  /* Sensor threshold refresh */
+#define MCH_SESS_POOL_MAX        4  /* Max sessions per MCH, including primary */
+
 /* Struct for MCH system information */
 typedef struct MchDataRec_ {
 	IpmiSess   ipmiSess;       /* IPMI session information; defined in ipmiDef.h */
 	MchSess    mchSess;        /* Additional MCH session info */
 	MchSys     mchSys;         /* MCH system info */
+	struct MchDataRec_ *pool[MCH_SESS_POOL_MAX]; /* Session pool; pool[0] is primary (this) session. 
+	                             * Pooled sessions share mchSys, but have own IPMI session, sequence
+	                             * numbers, error counts and asyn port. Only set in primary */
+	int        poolSize;       /* Number of sessions in pool; 0 in pooled sessions */
 } MchDataRec, *MchData;
 
 /*extern MchSys mchSysData[MAX_MCH];*/
@@ -204,8 +372,14 @@ typedef struct MchDataRec_ {
 int  mchCnfgChk(MchData mchData);
 void mchStatSet(int inst, uint32_t clear, uint32_t set);
 int  mchNewSession(MchSess mchSess, IpmiSess ipmiSess);
+void mchSessRecoverRequest(MchSess mchSess);
+MchData mchSessPoolGet(MchData mchData, int work);
 int  mchGetSensorReadingStat(MchData mchData, uint8_t *response, Sensor sens);
+void mchSensorBulkStore(MchData mchData, uint8_t addr, uint8_t chan, uint8_t lun, uint8_t number, uint8_t *data, size_t length);
 int  mchGetFruIdFromIndex(MchData mchData, int index);
+Fru  mchFruAdd(MchData mchData);
+Sensor mchSensorEvent(MchData mchData, uint8_t addr, uint8_t lun, uint8_t lunMask, uint8_t number, uint8_t stype, uint8_t etype);
+MchDev mchDevGet(int inst);
 
 #define IPMI_RPLY_CLOSE_SESSION_LENGTH_VT        22
 
@@ -259,6 +433,11 @@ extern struct MchCbRec_ {
     int    (*fru_data_suppl)     (MchData mchData, int index);
     void   (*sensor_get_fru)     (MchData mchData, Sensor sens);
     int    (*get_chassis_status) (MchData mchData, uint8_t *data);
+/* Optional: read all sensors owned by controller addr/chan in one exchange,
+ * passing each reading to mchSensorBulkStore; returns 0 on success.
+ * No supported MCH type implements it yet.
+ */
+    int    (*sensor_read_bulk)   (MchData mchData, uint8_t addr, uint8_t chan);
 /* Following are PICMG only */
     int    (*set_fru_act)        (MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t parm);
     int    (*get_fan_prop)       (MchData mchData, uint8_t *data, uint8_t fruIndex);
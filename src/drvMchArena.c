@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdlib.h>
+#include <string.h>
+
+#include <drvMchArena.h>
+
+struct MchArenaBlkRec_ {
+	MchArenaBlk  prev;      /* Previously filled block */
+	size_t       size;      /* Usable bytes in data */
+	size_t       used;      /* Bytes handed out from data */
+	double       data[1];   /* Start of storage (double for alignment) */
+};
+
+#define MCH_ARENA_ROUND(x)  (((x) + MCH_ARENA_ALIGN - 1) & ~((size_t)MCH_ARENA_ALIGN - 1))
+
+void
+mchArenaInit(MchArena arena, size_t blkSize)
+{
+	memset( arena, 0, sizeof(*arena) );
+	arena->blkSize = blkSize ? blkSize : MCH_ARENA_BLK_SIZE_DEFAULT;
+}
+
+/* Add a block of at least 'size' bytes to the arena
+ *
+ *   RETURNS: 0 on success
+ *            non-zero if no memory
+ */
+static int
+mchArenaAddBlk(MchArena arena, size_t size)
+{
+MchArenaBlk blk;
+size_t      n = arena->blkSize;
+
+	/* First block of a generation is sized to hold everything the previous one used */
+	if ( !arena->blk && arena->hint > n )
+		n = arena->hint;
+	if ( size > n )
+		n = size;
+	n = MCH_ARENA_ROUND( n );
+
+	if ( !(blk = malloc( offsetof( struct MchArenaBlkRec_, data ) + n )) )
+		return -1;
+
+	blk->prev   = arena->blk;
+	blk->size   = n;
+	blk->used   = 0;
+	arena->blk  = blk;
+	arena->size += n;
+	arena->nblk++;
+	if ( arena->size > arena->peak )
+		arena->peak = arena->size;
+
+	return 0;
+}
+
+/* Allocate zeroed memory from the arena
+ *
+ *   RETURNS: pointer to memory
+ *            NULL if no memory
+ */
+void *
+mchArenaAlloc(MchArena arena, size_t size)
+{
+MchArenaBlk blk;
+void       *p;
+
+	size = MCH_ARENA_ROUND( size ? size : 1 );
+
+	if ( !(blk = arena->blk) || (blk->size - blk->used) < size ) {
+		if ( mchArenaAddBlk( arena, size ) )
+			return NULL;
+		blk = arena->blk;
+	}
+
+	p = (uint8_t *)blk->data + blk->used;
+	blk->used   += size;
+	arena->used += size;
+	arena->last  = p;
+
+	memset( p, 0, size );
+	return p;
+}
+
+/* Grow an allocation, preserving its contents and zeroing the new space
+ * If ptr is the most recent allocation and the block has room, grow in place;
+ * otherwise copy to new space (old space is reclaimed with the generation).
+ * ptr may be NULL.
+ *
+ *   RETURNS: pointer to memory
+ *            NULL if no memory (ptr is still valid)
+ */
+void *
+mchArenaGrow(MchArena arena, void *ptr, size_t oldSize, size_t newSize)
+{
+MchArenaBlk blk = arena->blk;
+size_t      o, n;
+void       *p;
+
+	if ( !ptr || !oldSize )
+		return mchArenaAlloc( arena, newSize );
+
+	if ( newSize <= oldSize )
+		return ptr;
+
+	o = MCH_ARENA_ROUND( oldSize );
+	n = MCH_ARENA_ROUND( newSize );
+
+	if ( ptr == arena->last && (blk->size - blk->used) >= (n - o) ) {
+		blk->used   += n - o;
+		arena->used += n - o;
+		memset( (uint8_t *)ptr + oldSize, 0, n - oldSize );
+		return ptr;
+	}
+
+	if ( !(p = mchArenaAlloc( arena, newSize )) )
+		return NULL;
+
+	memcpy( p, ptr, oldSize );
+	return p;
+}
+
+/* Release all memory of the current generation and start a new one */
+void
+mchArenaFree(MchArena arena)
+{
+MchArenaBlk blk, prev;
+
+	for ( blk = arena->blk; blk; blk = prev ) {
+		prev = blk->prev;
+		free( blk );
+	}
+
+	arena->hint = arena->used;
+	arena->blk  = NULL;
+	arena->last = NULL;
+	arena->used = arena->size = 0;
+	arena->nblk = 0;
+	arena->gen++;
+}
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef DRV_MCH_ARENA_H
+#define DRV_MCH_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Arena allocator for MCH configuration data
+ *
+ * All memory for one configuration generation (SDRs, sensors, FRUs,
+ * management controllers, entity lists, FRU data) is carved out of
+ * a short chain of large blocks. Nothing is freed individually;
+ * mchArenaFree releases the whole generation at once.
+ *
+ * Arena routines are not thread-safe; caller must perform locking
+ * (in the driver, the MCH mutex).
+ */
+
+#define MCH_ARENA_BLK_SIZE_DEFAULT  (64*1024) /* Default block size [bytes] */
+#define MCH_ARENA_ALIGN             16        /* Alignment of returned pointers */
+
+typedef struct MchArenaBlkRec_ *MchArenaBlk;
+
+typedef struct MchArenaRec_ {
+	MchArenaBlk  blk;       /* Current (most recently added) block; earlier blocks chained behind it */
+	size_t       blkSize;   /* Minimum block size */
+	size_t       hint;      /* Bytes used by previous generation; sizes first block of next generation */
+	size_t       used;      /* Bytes handed out in this generation */
+	size_t       size;      /* Bytes held in blocks in this generation */
+	size_t       peak;      /* Largest 'size' of any generation */
+	unsigned     nblk;      /* Number of blocks in this generation */
+	uint32_t     gen;       /* Generation number; incremented by mchArenaFree */
+	void        *last;      /* Most recent allocation; can be grown in place */
+} MchArenaRec, *MchArena;
+
+void  mchArenaInit(MchArena arena, size_t blkSize);
+
+void *mchArenaAlloc(MchArena arena, size_t size);
+
+void *mchArenaGrow(MchArena arena, void *ptr, size_t oldSize, size_t newSize);
+
+void  mchArenaFree(MchArena arena);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
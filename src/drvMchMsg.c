@@ -19,14 +19,120 @@
 #include <ipmiDef.h>
 #include <picmgDef.h>
 #include <drvMchMsg.h>
+#ifdef IPMI_RMCPP
+#include <ipmiRmcpp.h>
+#endif
 
 
+/*
+ * Find circuit breaker for bridged target; add it if not yet tracked.
+ *
+ *   RETURNS: pointer to breaker
+ *            NULL if table is full (target is never quarantined)
+ */
+MchBrk
+mchBrkFind(MchSess mchSess, uint8_t addr, uint8_t chan)
+{
+MchBrk brk;
+int    i;
+
+	for ( i = 0; i < mchSess->brkCount; i++ ) {
+		brk = &mchSess->brk[i];
+		if ( brk->addr == addr && brk->chan == chan )
+			return brk;
+	}
+
+	if ( mchSess->brkCount >= MCH_BRK_MAX )
+		return NULL;
+
+	brk = &mchSess->brk[mchSess->brkCount++];
+	memset( brk, 0, sizeof(*brk) );
+	brk->addr = addr;
+	brk->chan = chan;
+	return brk;
+}
+
+/*
+ * Check whether a request may be sent to target.
+ * If target is quarantined and its probe time has come, allow this
+ * one request as a probe and schedule the next one.
+ *
+ *   RETURNS: 1 if request may be sent
+ *            0 if target is quarantined
+ */
+int
+mchBrkAllow(MchSess mchSess, MchBrk brk)
+{
+epicsTimeStamp now;
+
+	if ( !brk || !brk->open )
+		return 1;
+
+	epicsTimeGetCurrent( &now );
+	if ( epicsTimeDiffInSeconds( &now, &brk->probe ) >= 0 ) {
+		brk->probe = now;
+		epicsTimeAddSeconds( &brk->probe, brk->backoff );
+		return 1;
+	}
+
+	brk->skipped++;
+	return 0;
+}
+
+/* Forget all targets; called when configuration is re-read */
+void
+mchBrkReset(MchSess mchSess)
+{
+	mchSess->brkCount = 0;
+	mchSess->brkCur   = 0;
+}
+
+/* Record outcome of request to target; quarantine it or back off further on failure */
+static void
+mchBrkResult(MchSess mchSess, MchBrk brk, int ok)
+{
+int inst = mchSess->instance;
+
+	if ( ok ) {
+		if ( brk->open && MCH_DBG( mchStat[inst] ) )
+			printf("%s target 0x%02x chan %i responding again; ending quarantine\n", mchSess->name, brk->addr, brk->chan);
+		brk->open = 0;
+		brk->fail = 0;
+		return;
+	}
+
+	brk->fail++;
+
+	if ( brk->open ) {
+		/* Failed probe */
+		brk->backoff *= 2;
+		if ( brk->backoff > MCH_BRK_BACKOFF_MAX )
+			brk->backoff = MCH_BRK_BACKOFF_MAX;
+	}
+	else if ( brk->fail >= MCH_BRK_THRESHOLD ) {
+		if ( MCH_DBG( mchStat[inst] ) )
+			printf("%s target 0x%02x chan %i not responding after %i tries; quarantining\n", mchSess->name, brk->addr, brk->chan, brk->fail);
+		brk->open    = 1;
+		brk->backoff = MCH_BRK_BACKOFF_MIN;
+		brk->trips++;
+	}
+	else
+		return;
+
+	epicsTimeGetCurrent( &brk->probe );
+	epicsTimeAddSeconds( &brk->probe, brk->backoff );
+}
+
 /* change this to be callback mchWriteRead, move to drvMch.c
  *
  * Call ipmiMsgWriteRead. 
  * If error, increment error count. Else, set error count back to zero.
  * If MCH is alive, but there is no response or error count reaches 10,
- * start a new session and return error. 
+ * request a new session (started by the ping task) and return error. 
+ * Until the new session is active, in-session messages fail without being sent.
+ * If request is bridged to a tracked target (mchSess->brkCur), a missing
+ * response or timeout is charged to the target's circuit breaker instead
+ * of the session error count.
  * Check message sequence, session sequence, completion code.
  *
  *   RETURNS: 0 if error-free response
@@ -62,6 +168,14 @@ size_t   responseLen;
 	if ( !MCH_ONLN( mchStat[inst] ) )
 		return -1;
 
+	if ( !outSess && mchSess->recover )
+		return -1;
+
+#ifdef IPMI_RMCPP
+	if ( ipmiRmcppActive( ipmiSess ) )
+		status = ipmiRmcppWriteRead( ipmiSess, mchSess->name, message, messageSize, response, responseSize, mchSess->timeout, &responseLen );
+	else
+#endif
        	status = ipmiMsgWriteRead( mchSess->name, message, messageSize, response, responseSize, mchSess->timeout, &responseLen );
 
 	if ( MCH_DBG( mchStat[inst] ) >= MCH_DBG_MED ) {
@@ -89,19 +203,24 @@ size_t   responseLen;
 
        	if ( mchSess->err > 9 ) {
        		if ( MCH_DBG( mchStat[inst] ) )
-       			printf("%s start new session; err count is %i\n", mchSess->name, mchSess->err);
+       			printf("%s request new session; err count is %i\n", mchSess->name, mchSess->err);
 
        		/* Reset error count to 0 */
        		mchSess->err = 0;
 
-       		/* Close current session, start new one, and return error */
-       		mchMsgCloseSess( mchSess, ipmiSess, response );
-       		mchNewSession( mchSess, ipmiSess );
+       		/* Ping task closes current session and starts new one; return error */
+       		mchSessRecoverRequest( mchSess );
        	       	return -1;
        	}
 
+	if ( responseLen != 0 )
+		epicsTimeGetCurrent( &mchSess->lastTraffic );
+
 	if ( responseLen == 0 ) {
-		mchSess->err++;
+		if ( mchSess->brkCur )
+			mchBrkResult( mchSess, mchSess->brkCur, 0 );
+		else
+			mchSess->err++;
 		return -1;
 	}
 
@@ -155,6 +274,8 @@ size_t   responseLen;
 			ipmiSess->seqRply[i] = seq[i];
 
 		if ( (code = response[codeOffs] ) ) {
+			if ( mchSess->brkCur )
+				mchBrkResult( mchSess, mchSess->brkCur, code != IPMI_COMP_CODE_TIMEOUT );
 			if ( MCH_DBG( mchStat[inst] ) )
 				ipmiCompletionCode( mchSess->name, code, cmd, netfn );
 			//mchSess->err++; // only increment error count for some errors ? --not parameter out of range, for example
@@ -162,54 +283,176 @@ size_t   responseLen;
 		}
 	}
 
+	if ( mchSess->brkCur )
+		mchBrkResult( mchSess, mchSess->brkCur, 1 );
+
 	mchSess->err = 0;
 	return 0;
 }
 
-/* Only relevant for messages in a session. Do not call for messages preceding a session. Do this so we can use authReq to determine auth type. 
- * Some devices do both bridged/non-bridged messages, so cannot use ipmiSess->features alone to determine this. For now,
- * also check *bridged, which should be set to non-zero value for a bridged message. Also this is only for once-bridged messages.
- * Twice-bridged messages handled separately
+/* Set target of route: direct to BMC if addr is the BMC, else bridged.
+ * Addressing and offsets are filled in by mchRouteGet on first use.
  */
 void
-mchSetSizeOffs(IpmiSess ipmiSess, size_t payloadSize, size_t *roffs, size_t *responseSize, int *bridged, uint8_t *rsAddr, uint8_t *rqAddr)
+mchRouteInit(IpmiRoute route, uint8_t addr, uint8_t chan)
+{
+	memset( route, 0, sizeof(*route) );
+	route->addr = addr;
+	route->chan = chan;
+	route->type = ( addr == IPMI_MSG_ADDR_BMC ) ? IPMI_ROUTE_DIRECT : IPMI_ROUTE_BRIDGED;
+}
+
+/* Set target of twice-bridged route: via carrier manager to target on IPMB-L (NAT) */
+void
+mchRouteInitCm(IpmiRoute route, uint8_t addr)
 {
-int authOffs, offs;
+	memset( route, 0, sizeof(*route) );
+	route->addr = addr;
+	route->chan = IPMI_MSG_CHAN_IPMBL;
+	route->type = IPMI_ROUTE_BRIDGED_CM;
+}
 
+/* 
+ * Return route, first (re)building it if it was built for a different
+ * authentication type or BMC features than those of this session.
+ * Only relevant for messages in a session; session establishment
+ * messages use a BMC route built for the authentication type being requested.
+ * 
+ * Some devices do both bridged/non-bridged messages, so cannot use ipmiSess->features alone
+ * to determine this; route type set with target is also used.
+ *
+ * Caller must perform locking.
+ */
+IpmiRoute
+mchRouteGet(IpmiSess ipmiSess, IpmiRoute route)
+{
+uint8_t key = MCH_ROUTE_KEY( ipmiSess );
+int     roffs;
+
+	if ( route->key == key )
+		return route;
+
+	route->sendChan = IPMI_MSG_CHAN_IPMB0 + IPMI_MSG_TRACKING;
+
+	if ( route->type == IPMI_ROUTE_BRIDGED_CM ) {
+		route->bridged = IPMI_ROUTE_BRIDGED_CM;
+		route->rsAddr  = IPMI_MSG_ADDR_CM;
+		route->rqAddr  = IPMI_MSG_ADDR_BMC;
+		roffs = IPMI_RPLY_HEADER_LENGTH + 2*IPMI_MSG1_LENGTH + 2*IPMI_RPLY_IMSG2_SEND_MSG_LENGTH;
+	}
 	/* This section needs to be completely figured out (Vadatech) */
-	if ( ipmiSess->features & MCH_FEAT_SENDMSG_RPLY ) {
+	else if ( ipmiSess->features & MCH_FEAT_SENDMSG_RPLY ) {
 		// note that we used to only check comp code of send msg reply (not payload reply) which is different than other devices; may need to revert to that
-		offs = IPMI_RPLY_BRIDGED_2REPLY_OFFSET;
-		*responseSize += IPMI_RPLY_HEADER_LENGTH + offs;
-		*bridged = 1;
-		*rsAddr = IPMI_MSG_ADDR_CM;
-		*rqAddr = IPMI_MSG_ADDR_BMC;
+		route->bridged = IPMI_ROUTE_BRIDGED;
+		route->rsAddr  = IPMI_MSG_ADDR_CM;
+		route->rqAddr  = IPMI_MSG_ADDR_BMC;
+		roffs = IPMI_RPLY_HEADER_LENGTH + IPMI_RPLY_BRIDGED_2REPLY_OFFSET;
 	}
-	else if ( *bridged ) {
-		offs = IPMI_RPLY_BRIDGED_2REPLY_OFFSET;
-		*responseSize += IPMI_RPLY_HEADER_LENGTH + offs;
-		*rqAddr = IPMI_MSG_ADDR_BMC;
+	else if ( route->type == IPMI_ROUTE_BRIDGED ) {
+		route->bridged = IPMI_ROUTE_BRIDGED;
+		route->rsAddr  = route->addr;
+		route->rqAddr  = IPMI_MSG_ADDR_BMC;
+		roffs = IPMI_RPLY_HEADER_LENGTH + IPMI_RPLY_BRIDGED_2REPLY_OFFSET;
 	}
 	else {
-		offs = 0;
-		*responseSize += IPMI_RPLY_HEADER_LENGTH;
-		*bridged = 0;
-		*rqAddr  = IPMI_MSG_ADDR_SW;
+		route->bridged = IPMI_ROUTE_DIRECT;
+		route->rsAddr  = IPMI_MSG_ADDR_BMC;
+		route->rqAddr  = IPMI_MSG_ADDR_SW;
+		roffs = IPMI_RPLY_HEADER_LENGTH;
+	}
+
+	if ( ipmiSess->authReq != IPMI_MSG_AUTH_TYPE_NONE )
+		roffs += sizeof( IPMI_WRAPPER_PWD_KEY ) - sizeof( IPMI_WRAPPER );
+
+	route->roffs = roffs;
+	route->key   = key;
+
+	return route;
+}
+
+/* Check size of reply payload and copy it to caller's buffer.
+ * Reply buffers are MSG_MAX_LENGTH bytes.
+ *
+ *   RETURNS: 0 on success
+ *            non-zero if payload does not fit in reply buffer
+ */
+int
+mchMsgPayload(const char *name, IpmiRoute route, uint8_t *data, uint8_t *response, size_t payloadSize)
+{
+int rval;
+
+	if ( (rval = mchMsgCheckSizes( MSG_MAX_LENGTH, route->roffs, payloadSize )) ) {
+		printf("%s size error roffs %i payloadSize %i\n", name, (int)route->roffs, (int)payloadSize);
+		return rval;
 	}
 
+	memcpy( data, response + route->roffs, payloadSize );
+	return 0;
+}
 
-	if ( ipmiSess->authReq != IPMI_MSG_AUTH_TYPE_NONE ) {
-		authOffs = sizeof( IPMI_WRAPPER_PWD_KEY ) - sizeof( IPMI_WRAPPER );
-		offs += authOffs;
-		*responseSize += authOffs;
+/*
+ * Expected response size for command id (IPMI_CMD_xxx) sent on route.
+ * Uses reply length learned from the target if its replies to this command
+ * are shorter than the command table's (see mchMsgRply), so that the read 
+ * does not wait out the timeout for bytes that never come.
+ * dataSize is number of data bytes requested for variable-length replies.
+ */
+size_t
+mchMsgRplySize(IpmiRoute route, int id, size_t dataSize)
+{
+const IpmiCmdRec *c = &ipmiCmdTable[id];
+int i;
+
+	if ( !(c->flags & IPMI_CMD_RPLY_VAR) ) {
+		for ( i = 0; i < IPMI_ROUTE_RPLY_SLOTS; i++ )
+			if ( route->rplyId[i] == id + 1 )
+				return MCH_ROUTE_RPLY_SIZE( route, route->rplyLen[i] );
 	}
 
-	*roffs = *responseSize;  /* Offset into packet our section of interest */
-	/* If payloadSize is 0, it means the response length is variable or unknown;
-         * Set responseSize to 0 to indicate this to write/read function */         
-	*responseSize += payloadSize + FOOTER_LENGTH;
+	return MCH_ROUTE_RPLY_SIZE( route, c->rplyLength + dataSize );
+}
+
+/* Remember reply length of command for target; reuse slot of command or a free one,
+ * else replace one
+ */
+static void
+mchMsgRplyLearn(IpmiRoute route, int id, uint8_t length)
+{
+int i, slot = id % IPMI_ROUTE_RPLY_SLOTS;
+
+	for ( i = 0; i < IPMI_ROUTE_RPLY_SLOTS; i++ ) {
+		if ( route->rplyId[i] == id + 1 || route->rplyId[i] == 0 ) {
+			slot = i;
+			break;
+		}
+	}
 
-	return;
+	route->rplyId[slot]  = id + 1;
+	route->rplyLen[slot] = length;
+}
+
+/*
+ * Check reply to command id and copy its payload to caller's buffer:
+ * command table reply length plus dataSize bytes; bytes not sent by the 
+ * target are 0. responseSize is actual response length returned by write/read.
+ * If the target sent less than the table says, learn its reply length.
+ *
+ *   RETURNS: 0 on success
+ *            non-zero if payload does not fit in reply buffer
+ */
+int
+mchMsgRply(const char *name, IpmiRoute route, int id, uint8_t *data, uint8_t *response, size_t responseSize, size_t dataSize)
+{
+const IpmiCmdRec *c = &ipmiCmdTable[id];
+size_t length;
+
+	if ( !(c->flags & IPMI_CMD_RPLY_VAR) && (responseSize > route->roffs + FOOTER_LENGTH) ) {
+		length = responseSize - route->roffs - FOOTER_LENGTH;
+		if ( length < c->rplyLength )
+			mchMsgRplyLearn( route, id, length );
+	}
+
+	return mchMsgPayload( name, route, data, response, c->rplyLength + dataSize );
 }
 
 int
@@ -303,6 +546,26 @@ bail:
 	return rval;
 }
 
+#ifdef IPMI_RMCPP
+/* Establish RMCP+ session with cipher suite mchSess->rmcpp,
+ * using the same user name and password as Get Session Challenge
+ * with password/key authentication
+ *
+ *   RETURNS: status from ipmiRmcppOpen
+ *            0 on success
+ *            non-zero for error
+ */
+int
+mchMsgRmcppOpen(MchSess mchSess, IpmiSess ipmiSess)
+{
+const uint8_t *user = GET_SESS_MSG_PWD_KEY + IPMI_MSG2_USER_OFFSET;
+const uint8_t *key  = IPMI_WRAPPER_PWD_KEY + IPMI_WRAPPER_AUTH_CODE_OFFSET;
+
+	return ipmiRmcppOpen( mchSess, ipmiSess, mchSess->rmcpp, user, strnlen( (const char *)user, IPMI_MSG2_USER_LENGTH ),
+	    key, strnlen( (const char *)key, IPMI_WRAPPER_AUTH_CODE_LENGTH ), IPMI_MSG_PRIV_LEVEL_OPER );
+}
+#endif
+
 /* Activate Session
  *
  *   RETURNS: status from ipmiMsgActSess
@@ -313,23 +576,18 @@ int
 mchMsgActSess(MchSess mchSess, IpmiSess ipmiSess, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_ACTIVATE_SESSION_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRouteRec route;
+size_t   responseSize, payloadSize = IPMI_RPLY_IMSG2_ACTIVATE_SESSION_LENGTH; 
+int      rval;
 
-	if ( (rval = ipmiMsgActSess( mchSess, ipmiSess, response, &responseSize, roffs )) )
-		goto bail;
+	mchRouteInit( &route, IPMI_MSG_ADDR_BMC, 0 );
+	mchRouteGet( ipmiSess, &route );
+	responseSize = MCH_ROUTE_RPLY_SIZE( &route, payloadSize );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgActSess size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgActSess( mchSess, ipmiSess, response, &responseSize, route.roffs )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgPayload( "mchMsgActSess", &route, data, response, payloadSize );
 }
 
 /* Set Session Privilege level
@@ -342,23 +600,18 @@ int
 mchMsgSetPriv(MchSess mchSess, IpmiSess ipmiSess, uint8_t *data, uint8_t level)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_SET_PRIV_LEVEL_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
+IpmiRouteRec route;
+size_t   responseSize, payloadSize = IPMI_RPLY_IMSG2_SET_PRIV_LEVEL_LENGTH; 
+int      rval;
 
-	mchSetSizeOffs( ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+	mchRouteInit( &route, IPMI_MSG_ADDR_BMC, 0 );
+	mchRouteGet( ipmiSess, &route );
+	responseSize = MCH_ROUTE_RPLY_SIZE( &route, payloadSize );
 
-	if ( (rval = ipmiMsgSetPriv( mchSess, ipmiSess, response, &responseSize, level, roffs )) )
-		goto bail;
+	if ( (rval = ipmiMsgSetPriv( mchSess, ipmiSess, response, &responseSize, level, route.roffs )) )
+		return rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetPriv size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
-
-bail:
-	return rval;
+	return mchMsgPayload( "mchMsgSetPriv", &route, data, response, payloadSize );
 }
 
 /* Get Device ID -- this is called before we know device type -- need to update this
@@ -367,36 +620,20 @@ bail:
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgGetDeviceId(MchData mchData, uint8_t *data, int bridged, uint8_t rsAddr) // change this to either never be bridged or to implement device checking and offsets; handle rqAddr too
+int 
+mchMsgGetDeviceIdWrapper(MchData mchData, uint8_t *data, IpmiRoute route)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_DEVICE_ID_LENGTH; 
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
-
-	if ( (rval = ipmiMsgGetDeviceId( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs )) )
-		goto bail;
+	route        = mchRouteGet( mchData->ipmiSess, route );
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_DEVICE_ID, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetDeviceId size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetDeviceId( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
-}
-
-int 
-mchMsgGetDeviceIdWrapper(MchData mchData, uint8_t *data, uint8_t rsAddr) {
-int bridged = 0;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgGetDeviceId( mchData, data, bridged, rsAddr );
+	return mchMsgRply( "mchMsgGetDeviceId", route, IPMI_CMD_GET_DEVICE_ID, data, response, responseSize, 0 );
 }
 
  /* Broadcast Get Device ID -- this is called before we know device type -- need to update this
@@ -409,22 +646,16 @@ int bridged = 0;
  mchMsgBroadcastGetDeviceId(MchData mchData, uint8_t *data, int tmp, uint8_t tmp1 ) //int bridged, uint8_t rsAddr) // change this $
  {
  uint8_t  response[MSG_MAX_LENGTH] = { 0 };
- size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_DEVICE_ID_LENGTH;
- int      rval, bridged = 0;
- uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
+ IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+ size_t   responseSize;
+ int      rval;
 
-       mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
+       responseSize = mchMsgRplySize( route, IPMI_CMD_GET_DEVICE_ID, 0 );
  
-       if ( (rval = ipmiMsgBroadcastGetDeviceId( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs )) )
-               goto bail;
+       if ( (rval = ipmiMsgBroadcastGetDeviceId( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+               return rval;
   
-       if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-               printf("mchMsgBroadcastGetDeviceId size error\n");
-               goto bail;
-       }
-       memcpy( data, response + roffs, payloadSize );
-bail:
-      return rval;
+       return mchMsgRply( "mchMsgBroadcastGetDeviceId", route, IPMI_CMD_GET_DEVICE_ID, data, response, responseSize, 0 );
 }
 
 /* Close Session - test for NAT and determine reply offset*/
@@ -446,23 +677,16 @@ int
 mchMsgChassisControl(MchData mchData, uint8_t *data, uint8_t parm)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_CHAS_CTRL_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = ipmiMsgChassisControl( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, parm, &responseSize, roffs )) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_CHAS_CTRL, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgChassisControl size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgChassisControl( mchData->mchSess, mchData->ipmiSess, response, route, parm, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgChassisControl", route, IPMI_CMD_CHAS_CTRL, data, response, responseSize, 0 );
 }
 
 /* Get Chassis Status, supported by Supermicro and ATCA systems
@@ -475,64 +699,38 @@ int
 mchMsgGetChassisStatus(MchData mchData, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_CHAS_STATUS_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_CHAS_STATUS, 0 );
 
-	if ( (rval = ipmiMsgGetChassisStatus( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs )) )
-		goto bail;
+	if ( (rval = ipmiMsgGetChassisStatus( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetChassisStatus size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
-
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetChassisStatus", route, IPMI_CMD_GET_CHAS_STATUS, data, response, responseSize, 0 );
 }
 
-/* Get FRU Inventory Info, optionally bridged message. If not bridged, caller should set bridged arg to 0.
+/* Get FRU Inventory Info, bridged to FRU's controller if it is not the BMC
  *
  *   RETURNS: status from ipmiMsgGetFruInfo
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgGetFruInvInfo(MchData mchData, uint8_t *data, uint8_t id, int bridged, uint8_t rsAddr)
+int
+mchMsgGetFruInvInfoWrapper(MchData mchData, uint8_t *data, Fru fru)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_FRU_INV_INFO_LENGTH; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FRU_INFO, 0 );
 
-	if ( (rval = ipmiMsgGetFruInvInfo( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, id, &responseSize, roffs )) )
-		goto bail;
+	if ( (rval = ipmiMsgGetFruInvInfo( mchData->mchSess, mchData->ipmiSess, response, route, fru->sdr.fruId, &responseSize )) )
+		return rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFruInvInfo size error\n");
-		goto bail;
-	}
-
-	memcpy( data, response + roffs, payloadSize );
-
-bail:
-	return rval;
-}
-
-int
-mchMsgGetFruInvInfoWrapper(MchData mchData, uint8_t *data, Fru fru)
-{
-int bridged = 0;
-uint8_t rsAddr = fru->sdr.addr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgGetFruInvInfo( mchData, data, fru->sdr.fruId, bridged, rsAddr );
+	return mchMsgRply( "mchMsgGetFruInvInfo", route, IPMI_CMD_GET_FRU_INFO, data, response, responseSize, 0 );
 }
 
 /* Read FRU data 
@@ -541,39 +739,20 @@ uint8_t rsAddr = fru->sdr.addr;
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgReadFru(MchData mchData, uint8_t *data, uint8_t id, uint8_t *readOffset, uint8_t readSize, int bridged, uint8_t rsAddr)
+int
+mchMsgReadFruWrapper(MchData mchData, uint8_t *data, Fru fru, uint8_t *readOffset, uint8_t readSize)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_READ_FRU_DATA_BASE_LENGTH + readSize; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgReadFru( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, id, readOffset, readSize, &responseSize, roffs )) )
-		goto bail;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgReadFru size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_READ_FRU_DATA, readSize );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgReadFru( mchData->mchSess, mchData->ipmiSess, response, route, fru->sdr.fruId, readOffset, readSize, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
-}
-
-int
-mchMsgReadFruWrapper(MchData mchData, uint8_t *data, Fru fru, uint8_t *readOffset, uint8_t readSize)
-{
-int bridged = 0;
-uint8_t rsAddr = fru->sdr.addr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgReadFru( mchData, data, fru->sdr.fruId, readOffset, readSize, bridged, rsAddr );
+	return mchMsgRply( "mchMsgReadFru", route, IPMI_CMD_READ_FRU_DATA, data, response, responseSize, readSize );
 }
 
 /* Get SDR (Sensor Data Record) Repository Info 
@@ -582,160 +761,142 @@ uint8_t rsAddr = fru->sdr.addr;
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgGetSdrRepInfo(MchData mchData, uint8_t *data, uint8_t parm, int bridged, uint8_t rsAddr)
+int
+mchMsgGetSdrRepInfoWrapper(MchData mchData, uint8_t *data, uint8_t parm, IpmiRoute route)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0; 
-size_t   payloadSize = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_RPLY_IMSG2_GET_DEV_SDR_INFO_LENGTH : IPMI_RPLY_IMSG2_GET_SDRREP_INFO_LENGTH; 
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
+int      id = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_GET_DEV_SDR_INFO : IPMI_CMD_GET_SDRREP_INFO;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+	route        = mchRouteGet( mchData->ipmiSess, route );
+	responseSize = mchMsgRplySize( route, id, 0 );
 
 /* Set channel ? */
-	if ( (rval = ipmiMsgGetSdrRepInfo( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, parm )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetSdrRepInfo size error roffs %i payloadSize %i responseSize %i\n", (int)roffs, (int)payloadSize, (int)responseSize);
-		goto bail;
-	}
-
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetSdrRepInfo( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, parm )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetSdrRepInfo", route, id, data, response, responseSize, 0 );
 }
 
+/* Reserve SDR (Sensor Data Record) Repository
+ *
+ *   RETURNS: status from mchMsgWriteReadHelper
+ *            0 on success
+ *            non-zero for error
+ */
 int
-mchMsgGetSdrRepInfoWrapper(MchData mchData, uint8_t *data, uint8_t parm, uint8_t rsAddr)
+mchMsgReserveSdrRepWrapper(MchData mchData, uint8_t *data, uint8_t parm, IpmiRoute route)
 {
-int bridged = 0;
+uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
+size_t   responseSize;
+int      rval;
+int      id = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_RESERVE_DEV_SDRREP : IPMI_CMD_RESERVE_SDRREP;
 
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
+	route        = mchRouteGet( mchData->ipmiSess, route );
+	responseSize = mchMsgRplySize( route, id, 0 );
 
-	return mchMsgGetSdrRepInfo( mchData, data, parm, bridged, rsAddr );
+	if ( (rval = ipmiMsgReserveSdrRep( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, parm )) )
+		return rval;
+
+	return mchMsgRply( "mchMsgReserveSdrRep", route, id, data, response, responseSize, 0 );
 }
 
-/* Get Device Sensor Data Record (SDR) Info 
+/* 
+ * Get SDR (Sensor Data Record)
+ * 
+ * Offset and reservation ID are 0 unless doing partial read that begins at an 
+ * offset into the SDR other than 0.
+ *
+ * Used for both Get SDR (parm = 0) and Get Device SDR (parm = 1). 
+ * Only differences in the message are the network function and command code.
  *
  *   RETURNS: status from mchMsgWriteReadHelper
  *            0 on success
  *            non-zero for error
- *
+ */
 int
-mchMsgGetDevSdrInfo(MchData mchData, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t parm)
+mchMsgGetSdrWrapper(MchData mchData, uint8_t *data,  uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, uint8_t parm, IpmiRoute route)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_DEV_SDR_INFO_LENGTH; 
+uint8_t  sdrDataSize = ( readSize == 0xFF ) ? SDR_MAX_LENGTH : readSize;
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgGetDevSdrInfo( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, parm, &responseSize, roffs )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetDevSdrInfo size error\n");
-		goto bail;
-	}
+int      cmd = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_GET_DEV_SDR : IPMI_CMD_GET_SDR;
+    
+	route        = mchRouteGet( mchData->ipmiSess, route );
+	responseSize = mchMsgRplySize( route, cmd, sdrDataSize );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetSdr( mchData->mchSess, mchData->ipmiSess, response, route, id, res, offset, readSize, &responseSize, parm )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetSdr", route, cmd, data, response, responseSize, sdrDataSize );
 }
-*/
 
-/* Reserve SDR (Sensor Data Record) Repository
+/* Get SEL (System Event Log) Info from MCH
  *
  *   RETURNS: status from mchMsgWriteReadHelper
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgReserveSdrRep(MchData mchData, uint8_t *data, uint8_t parm, int bridged, uint8_t rsAddr)
+int
+mchMsgGetSelInfo(MchData mchData, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_RESERVE_SDRREP_LENGTH; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
 
-	if ( (rval = ipmiMsgReserveSdrRep( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, parm )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgReserveSdrRep size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_SEL_INFO, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetSelInfo( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetSelInfo", route, IPMI_CMD_GET_SEL_INFO, data, response, responseSize, 0 );
 }
 
-int
-mchMsgReserveSdrRepWrapper(MchData mchData, uint8_t *data, uint8_t parm, uint8_t rsAddr)
-{
-int bridged = 0;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgReserveSdrRep( mchData, data, parm, bridged, rsAddr );
-}
-
-/* 
- * Get SDR (Sensor Data Record)
- * 
- * Offset and reservation ID are 0 unless doing partial read that begins at an 
- * offset into the SDR other than 0.
- *
- * Used for both Get SDR (parm = 0) and Get Device SDR (parm = 1). 
- * Only differences in the message are the network function and command code.
+/* Reserve SEL (System Event Log) on MCH
  *
  *   RETURNS: status from mchMsgWriteReadHelper
  *            0 on success
  *            non-zero for error
  */
-static int
-mchMsgGetSdr(MchData mchData, uint8_t *data, uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, uint8_t parm, int bridged, uint8_t rsAddr)
+int
+mchMsgReserveSel(MchData mchData, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-uint8_t  sdrDataSize = ( readSize == 0xFF ) ? SDR_MAX_LENGTH : readSize;
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_SDR_BASE_LENGTH + sdrDataSize; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
 int      rval;
-uint8_t  rqAddr;
-    
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
 
-	if ( (rval = ipmiMsgGetSdr( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, id, res, offset, readSize, &responseSize, roffs, parm )) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_RESERVE_SEL, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetSdr size error\n");
-		goto bail;
-	}
- 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgReserveSel( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgReserveSel", route, IPMI_CMD_RESERVE_SEL, data, response, responseSize, 0 );
 }
 
+/* Get SEL (System Event Log) Entry from MCH
+ *
+ *   RETURNS: status from mchMsgWriteReadHelper
+ *            0 on success
+ *            non-zero for error
+ */
 int
-mchMsgGetSdrWrapper(MchData mchData, uint8_t *data,  uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, uint8_t parm, uint8_t rsAddr)
+mchMsgGetSelEntry(MchData mchData, uint8_t *data, uint8_t *id, uint8_t *res)
 {
-int bridged = 0;
+uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
+
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_SEL_ENTRY, 0 );
 
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgGetSdr( mchData, data, id, res, offset, readSize, parm, bridged, rsAddr );
+	if ( (rval = ipmiMsgGetSelEntry( mchData->mchSess, mchData->ipmiSess, response, route, id, res, &responseSize )) )
+		return rval;
+
+	return mchMsgRply( "mchMsgGetSelEntry", route, IPMI_CMD_GET_SEL_ENTRY, data, response, responseSize, 0 );
 }
 
 /* Get Sensor Reading. Caller specifies expected message response length. 
@@ -744,76 +905,62 @@ int bridged = 0;
  *            0 on success
  *            non-zero for error
  */
-int
-mchMsgReadSensor(MchData mchData, uint8_t *data, uint8_t sens, uint8_t lun, size_t *sensReadMsgSize, int bridged, uint8_t rsAddr)
+static int
+mchMsgReadSensor(MchData mchData, uint8_t *data, uint8_t sens, uint8_t lun, size_t *sensReadMsgSize, IpmiRoute route)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = *sensReadMsgSize; 
+size_t   responseSize = MCH_ROUTE_RPLY_SIZE( route, *sensReadMsgSize ), payloadSize; 
 int      rval;
-uint8_t  rqAddr;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgReadSensor( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, sens, lun, &responseSize, roffs )) )
-		goto bail;
+	if ( (rval = ipmiMsgReadSensor( mchData->mchSess, mchData->ipmiSess, response, route, sens, lun, &responseSize )) )
+		return rval;
 
-	payloadSize = *sensReadMsgSize = responseSize - roffs - FOOTER_LENGTH;
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
+	payloadSize = *sensReadMsgSize = responseSize - route->roffs - FOOTER_LENGTH;
+	if ( (rval = mchMsgCheckSizes( sizeof( response ), route->roffs, payloadSize )) ) {
 		/* printf("mchMsgReadSensor size error\n"); */
-		goto bail;
+		return rval;
 	}
 
-//printf("mchMsgReadSensor: responseSize %i roffs %i response+roffs %i payloadSize %i\n", (int)responseSize, (int)roffs, (int)(response + roffs), (int)payloadSize);
+	memcpy( data, response + route->roffs, payloadSize );
 
-	memcpy( data, response + roffs, payloadSize );
-
-bail:
-	return rval;
+	return 0;
 }
 
 int
 mchMsgReadSensorWrapper(MchData mchData, uint8_t *data, Sensor sens, size_t *sensReadMsgSize)
 {
-int bridged = 0;
-uint8_t rsAddr = sens->sdr.owner;
+MchSess   mchSess = mchData->mchSess;
+IpmiRoute route   = mchRouteGet( mchData->ipmiSess, &sens->route );
+int       rval;
+MchBrk    brk;
 
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgReadSensor( mchData, data, sens->sdr.number, (sens->sdr.lun & 0x3), sensReadMsgSize, bridged, rsAddr );
-}
+	if ( route->type == IPMI_ROUTE_DIRECT )
+		return mchMsgReadSensor( mchData, data, sens->sdr.number, (sens->sdr.lun & 0x3), sensReadMsgSize, route );
 
-static int
-mchMsgGetSensorThresholds(MchData mchData, uint8_t *data, uint8_t sens, uint8_t lun, int bridged, uint8_t rsAddr)
-{
-uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_SENSOR_THRESH_LENGTH; 
-int      rval;
-uint8_t  rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
-
-	if ( (rval = ipmiMsgGetSensorThresholds( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, sens, lun, &responseSize, roffs )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetSensorThresholds size error\n");
-		goto bail;
-	}
+	/* Don't spend a timeout on a target that has stopped answering */
+	brk = mchBrkFind( mchSess, route->addr, route->chan );
+	if ( !mchBrkAllow( mchSess, brk ) )
+		return -1;
 
-	memcpy( data, response + roffs, payloadSize );
+	mchSess->brkCur = brk;
+	rval = mchMsgReadSensor( mchData, data, sens->sdr.number, (sens->sdr.lun & 0x3), sensReadMsgSize, route );
+	mchSess->brkCur = 0;
 
-bail:
 	return rval;
 }
 
 int
-mchMsgGetSensorThresholdsWrapper(MchData mchData, uint8_t *data, Sensor sens){
+mchMsgGetSensorThresholdsWrapper(MchData mchData, uint8_t *data, Sensor sens)
+{
+uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &sens->route );
+size_t   responseSize;
+int      rval;
 
-int bridged = 0;
-uint8_t rsAddr = sens->sdr.owner;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_SENSOR_THRESH, 0 );
 
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-	return mchMsgGetSensorThresholds( mchData, data, sens->sdr.number, (sens->sdr.lun & 0x3), bridged, rsAddr );
-}
+	if ( (rval = ipmiMsgGetSensorThresholds( mchData->mchSess, mchData->ipmiSess, response, route, sens->sdr.number, (sens->sdr.lun & 0x3), &responseSize )) )
+		return rval;
 
+	return mchMsgRply( "mchMsgGetSensorThresholds", route, IPMI_CMD_GET_SENSOR_THRESH, data, response, responseSize, 0 );
+}
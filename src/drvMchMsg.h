@@ -18,7 +18,23 @@ extern "C" {
 
 /* IMPORTANT: For all routines below, caller must perform locking */
 
-void mchSetSizeOffs(IpmiSess ipmiSess, size_t payloadSize, size_t *roffs, size_t *responseSize, int *bridged, uint8_t *rsAddr, uint8_t *rqAddr);
+/* Session settings a route depends on; never 0 */
+#define MCH_ROUTE_KEY(s)         (0x80 | ((s)->authReq << 1) | ((s)->features & MCH_FEAT_SENDMSG_RPLY))
+
+/* Expected response size for payload of n bytes */
+#define MCH_ROUTE_RPLY_SIZE(r, n) ((r)->roffs + (n) + FOOTER_LENGTH)
+
+void mchRouteInit(IpmiRoute route, uint8_t addr, uint8_t chan);
+
+void mchRouteInitCm(IpmiRoute route, uint8_t addr);
+
+IpmiRoute mchRouteGet(IpmiSess ipmiSess, IpmiRoute route);
+
+int mchMsgPayload(const char *name, IpmiRoute route, uint8_t *data, uint8_t *response, size_t payloadSize);
+
+size_t mchMsgRplySize(IpmiRoute route, int id, size_t dataSize);
+
+int mchMsgRply(const char *name, IpmiRoute route, int id, uint8_t *data, uint8_t *response, size_t responseSize, size_t dataSize);
 
 int mchMsgCheckSizes(size_t destSize, int offset, size_t srcSize);
 
@@ -30,6 +46,14 @@ int mchMsgActSess(MchSess mchSess, IpmiSess ipmiSess, uint8_t *response);
 
 int mchMsgSetPriv(MchSess mchSess, IpmiSess ipmiSess, uint8_t *response, uint8_t level);
 
+int mchMsgRmcppOpen(MchSess mchSess, IpmiSess ipmiSess);
+
+MchBrk mchBrkFind(MchSess mchSess, uint8_t addr, uint8_t chan);
+
+int mchBrkAllow(MchSess mchSess, MchBrk brk);
+
+void mchBrkReset(MchSess mchSess);
+
 int mchMsgWriteReadHelper(MchSess mchSess, IpmiSess ipmiSess, uint8_t *message, size_t messageSize, uint8_t *response, size_t *responseSize, uint8_t cmd, uint8_t netfn, int codeOffs, int outSess);
 
 int mchMsgCloseSess(MchSess mchSess, IpmiSess ipmiSess, uint8_t *data);
@@ -42,11 +66,17 @@ int mchMsgGetFruInvInfoWrapper(MchData mchData, uint8_t *data, Fru fru);
 
 int mchMsgReadFruWrapper(MchData mchData, uint8_t *data, Fru fru, uint8_t *readOffset, uint8_t readSize);
 
-int mchMsgGetSdrRepInfoWrapper(MchData mchData, uint8_t *data, uint8_t parm, uint8_t addr);
+int mchMsgGetSdrRepInfoWrapper(MchData mchData, uint8_t *data, uint8_t parm, IpmiRoute route);
+
+int mchMsgReserveSdrRepWrapper(MchData mchData, uint8_t *data, uint8_t parm, IpmiRoute route);
+
+int mchMsgGetSdrWrapper(MchData mchData, uint8_t *data,  uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, uint8_t parm, IpmiRoute route);
+
+int mchMsgGetSelInfo(MchData mchData, uint8_t *data);
 
-int mchMsgReserveSdrRepWrapper(MchData mchData, uint8_t *data, uint8_t parm, uint8_t addr);
+int mchMsgReserveSel(MchData mchData, uint8_t *data);
 
-int mchMsgGetSdrWrapper(MchData mchData, uint8_t *data,  uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, uint8_t parm, uint8_t rsAddr);
+int mchMsgGetSelEntry(MchData mchData, uint8_t *data, uint8_t *id, uint8_t *res);
 
 //int mchMsgGetDevSdrInfo(MchData mchData, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t parm);
 				
@@ -54,7 +84,7 @@ int mchMsgReadSensorWrapper(MchData mchData, uint8_t *data, Sensor sens, size_t
 
 int mchMsgGetSensorThresholdsWrapper(MchData mchData, uint8_t *data, Sensor sens);
 
-int mchMsgGetDeviceIdWrapper(MchData mchData, uint8_t *data, uint8_t rsAddr);
+int mchMsgGetDeviceIdWrapper(MchData mchData, uint8_t *data, IpmiRoute route);
 
 #ifdef __cplusplus
 };
@@ -0,0 +1,417 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <errlog.h>
+#include <epicsExport.h>
+#include <epicsThread.h>
+#include <epicsMutex.h>
+#include <iocsh.h>
+#include <registry.h>
+#include <osiSock.h>
+
+#include <drvMch.h>
+#include <ipmiDef.h>
+#include <picmgDef.h>
+
+/*
+ * Receiver for IPMI LAN alerts (Platform Event Traps, PET): SNMPv1 traps that
+ * shelf managers send to their configured alert destination, with the event
+ * in a variable binding. Each alert is mapped to an MCH by its source address
+ * and to a sensor by generator address and sensor number; the affected sensors
+ * are refreshed at once (see mchSensorEvent) instead of at the next scan.
+ *
+ * Alerts are unacknowledged UDP and may be lost; the SEL reader still sees every event.
+ */
+
+#define PET_PORT_DEFAULT             162  /* SNMP trap port */
+#define PET_MSG_MAX_LENGTH           512
+
+/* BER tags used in an SNMPv1 Trap-PDU */
+#define BER_TAG_INTEGER              0x02
+#define BER_TAG_OCTET_STRING         0x04
+#define BER_TAG_OID                  0x06
+#define BER_TAG_SEQUENCE             0x30
+#define BER_TAG_IPADDRESS            0x40
+#define BER_TAG_TIMETICKS            0x43
+#define BER_TAG_TRAP_PDU             0xA4
+
+#define SNMP_VERSION_1               0
+#define SNMP_TRAP_ENTERPRISE_SPECIFIC 6
+
+/* PET variable binding, offsets per Platform Event Trap Format Specification v1.0 */
+#define PET_DATA_SENS_DEV_OFFSET     27   /* Sensor device: generator slave address */
+#define PET_DATA_SENS_NUM_OFFSET     28   /* Sensor number */
+#define PET_DATA_EVENT_DATA_OFFSET   31   /* Event data 1-8 */
+#define PET_DATA_MIN_LENGTH          39
+
+/* Specific trap number: [23:16] sensor type, [15:8] event type, [7] 1 = deassertion, [3:0] event offset */
+#define PET_TRAP_SENS_TYPE(x)        (((x) >> 16) & 0xFF)
+#define PET_TRAP_EVENT_TYPE(x)       (((x) >> 8) & 0x7F)
+#define PET_TRAP_DEASSERT(x)         ((x) & 0x80)
+
+/* Source address of alerts from each MCH, indexed by MCH instance */
+typedef struct PetSrcRec_ {
+	struct in_addr addr;
+	int            resolved;  /* 1 if addr is valid */
+	int            tried;     /* 1 if port name lookup was attempted */
+	int            user;      /* 1 if set with mchPetSource; otherwise resolved from port name */
+} PetSrcRec;
+
+static PetSrcRec     petSrc[MAX_MCH];
+static epicsMutexId  petMtx;
+static SOCKET        petSock = INVALID_SOCKET;
+static int           petPort = 0;    /* Port listened on; 0 if not listening */
+
+static uint32_t      petRecv;        /* Datagrams received */
+static uint32_t      petBad;         /* Datagrams that are not PETs */
+static uint32_t      petNoMch;       /* Alerts from unknown source */
+static uint32_t      petNoSens;      /* Alerts for sensors not in MCH configuration */
+static uint32_t      petEvents;      /* Alerts mapped to a sensor */
+
+/* Read BER tag and length at *pos. On success *pos is the start of the value
+ * and the tag must be as expected.
+ *
+ *   RETURNS: 0 on success, -1 if malformed or unexpected tag
+ */
+static int
+petBerNext(const uint8_t *buf, size_t len, size_t *pos, uint8_t tag, size_t *vlen)
+{
+size_t p = *pos, n;
+int    i;
+
+	if ( p + 2 > len || buf[p++] != tag )
+		return -1;
+
+	n = buf[p++];
+	if ( n & 0x80 ) {
+		i = n & 0x7F;
+		if ( i == 0 || i > 4 || p + i > len )
+			return -1;
+		for ( n = 0; i > 0; i-- )
+			n = (n << 8) | buf[p++];
+	}
+	if ( p + n > len )
+		return -1;
+
+	*pos  = p;
+	*vlen = n;
+	return 0;
+}
+
+/* Read BER integer of up to 32 bits (plus sign byte) at *pos and move past it
+ *
+ *   RETURNS: 0 on success, -1 if malformed
+ */
+static int
+petBerInt(const uint8_t *buf, size_t len, size_t *pos, uint8_t tag, uint32_t *val)
+{
+size_t vlen, i;
+
+	if ( petBerNext( buf, len, pos, tag, &vlen ) || vlen == 0 || vlen > 5 )
+		return -1;
+
+	for ( *val = 0, i = 0; i < vlen; i++ )
+		*val = (*val << 8) | buf[*pos + i];
+	*pos += vlen;
+	return 0;
+}
+
+/* Parse SNMPv1 enterprise-specific trap and return agent address (network order),
+ * specific trap number and PET variable binding
+ *
+ *   RETURNS: 0 on success, -1 if not a PET
+ */
+static int
+petParse(const uint8_t *buf, size_t len, uint32_t *agent, uint32_t *spec, const uint8_t **data, size_t *dataLen)
+{
+size_t   pos = 0, vlen;
+uint32_t val;
+
+	if ( petBerNext( buf, len, &pos, BER_TAG_SEQUENCE, &vlen ) )
+		return -1;
+
+	if ( petBerInt( buf, len, &pos, BER_TAG_INTEGER, &val ) || val != SNMP_VERSION_1 )
+		return -1;
+
+	/* Community */
+	if ( petBerNext( buf, len, &pos, BER_TAG_OCTET_STRING, &vlen ) )
+		return -1;
+	pos += vlen;
+
+	if ( petBerNext( buf, len, &pos, BER_TAG_TRAP_PDU, &vlen ) )
+		return -1;
+
+	/* Enterprise */
+	if ( petBerNext( buf, len, &pos, BER_TAG_OID, &vlen ) )
+		return -1;
+	pos += vlen;
+
+	if ( petBerNext( buf, len, &pos, BER_TAG_IPADDRESS, &vlen ) || vlen != 4 )
+		return -1;
+	memcpy( agent, buf + pos, 4 );
+	pos += vlen;
+
+	if ( petBerInt( buf, len, &pos, BER_TAG_INTEGER, &val ) || val != SNMP_TRAP_ENTERPRISE_SPECIFIC )
+		return -1;
+
+	if ( petBerInt( buf, len, &pos, BER_TAG_INTEGER, spec ) )
+		return -1;
+
+	if ( petBerInt( buf, len, &pos, BER_TAG_TIMETICKS, &val ) )
+		return -1;
+
+	/* Variable bindings; PET data is value of first one */
+	if ( petBerNext( buf, len, &pos, BER_TAG_SEQUENCE, &vlen ) || petBerNext( buf, len, &pos, BER_TAG_SEQUENCE, &vlen ) )
+		return -1;
+
+	if ( petBerNext( buf, len, &pos, BER_TAG_OID, &vlen ) )
+		return -1;
+	pos += vlen;
+
+	if ( petBerNext( buf, len, &pos, BER_TAG_OCTET_STRING, &vlen ) || vlen < PET_DATA_MIN_LENGTH )
+		return -1;
+
+	*data    = buf + pos;
+	*dataLen = vlen;
+	return 0;
+}
+
+/* Find MCH that alerts from addr come from. Source addresses not set
+ * with mchPetSource are resolved from the MCH port name when first needed.
+ *
+ *   RETURNS: MCH device, or NULL if none
+ */
+static MchDev
+petFindMch(struct in_addr addr)
+{
+MchDev mch;
+int    i;
+
+	epicsMutexLock( petMtx );
+
+	for ( i = 0; (mch = mchDevGet( i )); i++ ) {
+
+		if ( !petSrc[i].tried && !petSrc[i].user ) {
+			petSrc[i].resolved = !hostToIPAddr( mch->name, &petSrc[i].addr );
+			petSrc[i].tried    = 1;
+		}
+
+		if ( petSrc[i].resolved && petSrc[i].addr.s_addr == addr.s_addr )
+			break;
+	}
+
+	epicsMutexUnlock( petMtx );
+
+	return mch;
+}
+
+static void
+mchPetTask(void *arg)
+{
+uint8_t        buf[PET_MSG_MAX_LENGTH];
+osiSockAddr    from;
+osiSocklen_t   fromLen;
+struct in_addr agent;
+const uint8_t *data;
+size_t         dataLen;
+uint32_t       spec;
+MchDev         mch;
+MchData        mchData;
+Sensor         sens;
+uint8_t        etype;
+int            n, inst;
+
+	while ( 1 ) {
+
+		fromLen = sizeof( from );
+		n = recvfrom( petSock, (char *)buf, sizeof( buf ), 0, &from.sa, &fromLen );
+
+		if ( n < 0 ) {
+			errlogPrintf("mchPetTask: receive error %i\n", (int)SOCKERRNO);
+			epicsThreadSleep( 1.0 );
+			continue;
+		}
+
+		petRecv++;
+
+		if ( petParse( buf, n, &agent.s_addr, &spec, &data, &dataLen ) ) {
+			petBad++;
+			continue;
+		}
+
+		/* Map by source address; agent address in trap if sent through a relay */
+		if ( !(mch = petFindMch( from.ia.sin_addr )) && !(mch = petFindMch( agent )) ) {
+			petNoMch++;
+			continue;
+		}
+
+		mchData = mch->udata;
+		inst    = mchData->mchSess->instance;
+		etype   = PET_TRAP_EVENT_TYPE( spec ) | PET_TRAP_DEASSERT( spec );
+
+		/* PET does not carry owner channel/LUN; match any */
+		epicsMutexLock( mch->mutex );
+		sens = mchSensorEvent( mchData, data[PET_DATA_SENS_DEV_OFFSET], 0, 0, data[PET_DATA_SENS_NUM_OFFSET],
+		    PET_TRAP_SENS_TYPE( spec ), etype );
+		epicsMutexUnlock( mch->mutex );
+
+		if ( sens )
+			petEvents++;
+		else
+			petNoSens++;
+
+		if ( MCH_DBG( mchStat[inst] ) )
+			printf("%s LAN alert: sensor owner 0x%02x number %u type 0x%02x event type 0x%02x offset %u %s%s\n",
+			    mch->name, data[PET_DATA_SENS_DEV_OFFSET], data[PET_DATA_SENS_NUM_OFFSET], PET_TRAP_SENS_TYPE( spec ),
+			    PET_TRAP_EVENT_TYPE( spec ), IPMI_SEL_EVENT_OFFSET( data[PET_DATA_EVENT_DATA_OFFSET] ),
+			    PET_TRAP_DEASSERT( spec ) ? "deasserted" : "asserted", sens ? "" : " (sensor not found)");
+	}
+}
+
+/* Start LAN alert receiver on UDP port; 0 selects the SNMP trap port, 162.
+ * A different port can be used with a local test sender or a trap forwarder.
+ */
+static void
+mchPetListen(int port)
+{
+osiSockAddr addr;
+
+	if ( petPort ) {
+		printf("mchPetListen: already listening on port %i\n", petPort);
+		return;
+	}
+
+	if ( port <= 0 )
+		port = PET_PORT_DEFAULT;
+
+	if ( INVALID_SOCKET == (petSock = epicsSocketCreate( AF_INET, SOCK_DGRAM, 0 )) ) {
+		printf("mchPetListen: failed to create socket\n");
+		return;
+	}
+
+	memset( &addr, 0, sizeof( addr ) );
+	addr.ia.sin_family      = AF_INET;
+	addr.ia.sin_addr.s_addr = htonl( INADDR_ANY );
+	addr.ia.sin_port        = htons( port );
+
+	if ( bind( petSock, &addr.sa, sizeof( addr.ia ) ) ) {
+		printf("mchPetListen: failed to bind to UDP port %i (error %i)\n", port, (int)SOCKERRNO);
+		epicsSocketDestroy( petSock );
+		petSock = INVALID_SOCKET;
+		return;
+	}
+
+	petPort = port;
+
+	epicsThreadMustCreate( "mchPet", epicsThreadPriorityHigh, epicsThreadGetStackSize( epicsThreadStackMedium ),
+	    mchPetTask, 0 );
+}
+
+/* Set address LAN alerts from an MCH come from, if not that of its port name */
+static void
+mchPetSource(const char *name, const char *host)
+{
+MchDev         mch;
+struct in_addr addr;
+int            inst;
+
+	if ( !name || !(mch = devMchFind( name )) ) {
+		printf("mchPetSource: MCH %s not found; call mchInit first\n", name ? name : "");
+		return;
+	}
+
+	if ( !host || hostToIPAddr( host, &addr ) ) {
+		printf("mchPetSource: cannot resolve host %s\n", host ? host : "");
+		return;
+	}
+
+	inst = ((MchData)mch->udata)->mchSess->instance;
+
+	epicsMutexLock( petMtx );
+	petSrc[inst].addr     = addr;
+	petSrc[inst].resolved = 1;
+	petSrc[inst].user     = 1;
+	epicsMutexUnlock( petMtx );
+}
+
+static void
+mchPetShow(void)
+{
+MchDev             mch;
+struct sockaddr_in sa;
+char               str[32];
+int                i;
+
+	if ( !petPort ) {
+		printf("LAN alert receiver not started (see mchPetListen)\n");
+		return;
+	}
+
+	printf("LAN alert receiver on UDP port %i: %u received, %u not PET, %u unknown source, %u unknown sensor, %u events\n",
+	    petPort, (unsigned)petRecv, (unsigned)petBad, (unsigned)petNoMch, (unsigned)petNoSens, (unsigned)petEvents);
+
+	epicsMutexLock( petMtx );
+	for ( i = 0; (mch = mchDevGet( i )); i++ ) {
+		if ( petSrc[i].resolved ) {
+			memset( &sa, 0, sizeof( sa ) );
+			sa.sin_family = AF_INET;
+			sa.sin_addr   = petSrc[i].addr;
+			ipAddrToDottedIP( &sa, str, sizeof( str ) );
+		}
+		else
+			strcpy( str, "unresolved" );
+		printf("  %s: source %s%s\n", mch->name, str, petSrc[i].user ? " (mchPetSource)" : "");
+	}
+	epicsMutexUnlock( petMtx );
+}
+
+static const iocshArg mchPetListenArg0        = { "UDP port (0 for 162)",iocshArgInt};
+static const iocshArg *mchPetListenArgs[1]    = { &mchPetListenArg0 };
+static const iocshFuncDef mchPetListenFuncDef = { "mchPetListen", 1, mchPetListenArgs };
+
+static void
+mchPetListenCallFunc(const iocshArgBuf *args)
+{
+	mchPetListen(args[0].ival);
+}
+
+static const iocshArg mchPetSourceArg0        = { "port name",iocshArgString};
+static const iocshArg mchPetSourceArg1        = { "alert source host",iocshArgString};
+static const iocshArg *mchPetSourceArgs[2]    = { &mchPetSourceArg0, &mchPetSourceArg1 };
+static const iocshFuncDef mchPetSourceFuncDef = { "mchPetSource", 2, mchPetSourceArgs };
+
+static void
+mchPetSourceCallFunc(const iocshArgBuf *args)
+{
+	mchPetSource(args[0].sval, args[1].sval);
+}
+
+static const iocshFuncDef mchPetShowFuncDef   = { "mchPetShow", 0, 0 };
+
+static void
+mchPetShowCallFunc(const iocshArgBuf *args)
+{
+	mchPetShow();
+}
+
+static void
+drvMchPetRegistrar(void)
+{
+	petMtx = epicsMutexMustCreate();
+
+	iocshRegister(&mchPetListenFuncDef, mchPetListenCallFunc);
+	iocshRegister(&mchPetSourceFuncDef, mchPetSourceCallFunc);
+	iocshRegister(&mchPetShowFuncDef, mchPetShowCallFunc);
+}
+
+epicsExportRegistrar(drvMchPetRegistrar);
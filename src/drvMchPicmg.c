@@ -43,25 +43,16 @@ int
 mchMsgGetAddressInfoIpmb0(MchData mchData, uint8_t *data, uint8_t fruId, uint8_t key)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = PICMG_RPLY_GET_ADDR_INFO_LENGTH;
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = ipmiMsgGetAddressInfoIpmb0( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, 
-						     fruId, key)) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_ADDR_INFO, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetAddressInfoIpmb0 size error\n");
-		goto bail;
-	}
-
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetAddressInfoIpmb0( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fruId, key )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetAddressInfoIpmb0", route, IPMI_CMD_GET_ADDR_INFO, data, response, responseSize, 0 );
 }
 
 /* Get Address Info - this is version that attempts to get physical location 
@@ -76,25 +67,16 @@ int
 mchMsgGetAddressInfoHwAddr(MchData mchData, uint8_t *data, uint8_t fru, uint8_t keytype, uint8_t key, uint8_t sitetype)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = PICMG_RPLY_GET_ADDR_INFO_LENGTH;
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = ipmiMsgGetAddressInfoHwAddr( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, 
-						     fru, keytype, key, sitetype )) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_ADDR_INFO, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetAddressInfoHwAddr size error\n");
-		goto bail;
-	}
-
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetAddressInfoHwAddr( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru, keytype, key, sitetype )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetAddressInfoHwAddr", route, IPMI_CMD_GET_ADDR_INFO, data, response, responseSize, 0 );
 }
 
 /* Get Address Info - this is version that does not seek information
@@ -110,24 +92,16 @@ int
 mchMsgGetAddressInfoIpmc(MchData mchData, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_PICMG_PROP_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgGetAddressInfoIpmc( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs )) )
-		goto bail;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetAddressInfoIpmc size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_ADDR_INFO_IPMC, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetAddressInfoIpmc( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetAddressInfoIpmc", route, IPMI_CMD_GET_ADDR_INFO_IPMC, data, response, responseSize, 0 );
 }
 
 static void
@@ -495,24 +469,16 @@ int
 mchMsgGetPicmgProp(MchData mchData, uint8_t *data)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_IMSG2_GET_PICMG_PROP_LENGTH; 
-int      rval, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgGetPicmgProp( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs )) )
-		goto bail;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetPicmgProp size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_PICMG_PROP, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetPicmgProp( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetPicmgProp", route, IPMI_CMD_GET_PICMG_PROP, data, response, responseSize, 0 );
 }
 
 /* Set FRU Activation - For NAT MCH, used to deactivate/activate FRU
@@ -615,28 +581,17 @@ int
 mchMsgSetFruActAtca(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t parm)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = PICMG_RPLY_SET_FRU_ACT_LENGTH;
-int      rval, bridged = 0;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = fru->sdr.addr, rqAddr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgSetFruAct( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, fru->sdr.fruId, parm )) )
-		goto bail;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetFruActAtca size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_SET_FRU_ACT, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgSetFruAct( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru->sdr.fruId, parm )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgSetFruActAtca", route, IPMI_CMD_SET_FRU_ACT, data, response, responseSize, 0 );
 }
 
 /* Get FRU Activation Policy using Vadatech MCH; message contains 1 bridged message -> needs updating 3/23/16
@@ -687,46 +642,26 @@ int
 mchMsgGetFruActPolicyNat(MchData mchData, uint8_t *data, uint8_t fru)
 {
 uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-size_t   imsg2Size    = sizeof( SEND_MSG_MSG );
-size_t   b1msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b1msg2Size   = sizeof( SEND_MSG_MSG );
-size_t   b2msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b2msg2Size   = sizeof( GET_FRU_POLICY_MSG );
+size_t   imsg2Size    = sizeof( GET_FRU_POLICY_MSG );
 uint8_t  imsg2[imsg2Size];
-uint8_t  b1msg1[b1msg1Size];
-uint8_t  b1msg2[b1msg2Size];
-uint8_t  b2msg1[b2msg1Size];
-uint8_t  b2msg2[b2msg2Size];
 size_t   messageSize;
-size_t   roffs;
-size_t   payloadSize  = IPMI_RPLY_GET_FRU_POLICY_LENGTH;
-size_t   responseSize = 2*IPMI_MSG1_LENGTH + 2*IPMI_RPLY_IMSG2_SEND_MSG_LENGTH;
+IpmiRouteRec routeRec;
+IpmiRoute route;
+size_t   responseSize;
 uint8_t  cmd          = IPMI_MSG_CMD_GET_FRU_POLICY;
 uint8_t  netfn        = IPMI_MSG_NETFN_PICMG;
-int      bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+	mchRouteInitCm( &routeRec, FRU_I2C_ADDR[fru] );
+	route = mchRouteGet( mchData->ipmiSess, &routeRec );
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FRU_POLICY, 0 );
 
-	memcpy( imsg2,  SEND_MSG_MSG , imsg2Size  );
-	memcpy( b1msg1, IPMI_MSG1    , b1msg1Size );
+	memcpy( imsg2, GET_FRU_POLICY_MSG, imsg2Size );
 
-	imsg2[IPMI_MSG2_CHAN_OFFSET]    = IPMI_MSG_CHAN_IPMB0 + IPMI_MSG_TRACKING;
-	b1msg1[IPMI_MSG1_RSADDR_OFFSET] = IPMI_MSG_ADDR_CM;
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
 
-	memcpy( b1msg2, SEND_MSG_MSG     , b1msg2Size );
-	memcpy( b2msg1, IPMI_MSG1        , b2msg1Size );
-	memcpy( b2msg2, GET_FRU_POLICY_MSG , b2msg2Size );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
-	b1msg2[IPMI_MSG2_RQADDR_OFFSET]   = IPMI_MSG_ADDR_BMC;
-	b2msg1[IPMI_MSG1_NETFNLUN_OFFSET] = netfn << 2;
-	b1msg2[IPMI_MSG2_CHAN_OFFSET]     = IPMI_MSG_CHAN_IPMBL + IPMI_MSG_TRACKING;
-	b2msg1[IPMI_MSG1_RSADDR_OFFSET]   = FRU_I2C_ADDR[fru];
-	b2msg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
-
-       	messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, b1msg2, b1msg2Size, b2msg1, b2msg2, b2msg2Size );
-
-	return mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, data, &responseSize, cmd, netfn, roffs, 0);
+	return mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, data, &responseSize, cmd, netfn, route->roffs, 0);
 }
 
 int
@@ -753,36 +688,37 @@ uint8_t  imsg2Size = sizeof( GET_FAN_PROP_MSG );
 uint8_t  imsg2[imsg2Size];
 size_t   messageSize;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize, payloadSize = IPMI_RPLY_GET_FAN_PROP_LENGTH; 
-int      rval, offs=0, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr, fruId = fru->sdr.fruId;
+size_t   responseSize;
+int      rval, offs=0;
 uint8_t  cmd   = IPMI_MSG_CMD_GET_FAN_PROP;
 uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_PROP, 0 );
 
 	memcpy( imsg2, GET_FAN_PROP_MSG, imsg2Size );
 
-	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fru->sdr.fruId;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( mchData->ipmiSess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
 	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, offs/*need to set codeoffs*/, 0 )) )
-		goto bail;
+		return rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanPropVt size error\n");
-		goto bail;
-	}
+	return mchMsgRply( "mchMsgGetFanPropVt", route, IPMI_CMD_GET_FAN_PROP, data, response, responseSize, 0 );
+}
 
-	memcpy( data, response + roffs, payloadSize );
+/* NAT MCH reaches fan trays through the carrier manager (twice-bridged).
+ * The route is kept apart from fru->route, which is used by the ATCA versions.
+ */
+static IpmiRoute
+mchNatRoute(MchData mchData, Fru fru)
+{
+	if ( fru->cmRoute.type != IPMI_ROUTE_BRIDGED_CM )
+		mchRouteInitCm( &fru->cmRoute, FRU_I2C_ADDR[fru->sdr.fruId] );
 
-bail:
-	return rval;
+	return mchRouteGet( mchData->ipmiSess, &fru->cmRoute );
 }
 
 /* Get Fan Speed Properties using NAT MCH; message contains 2 bridged messages
@@ -796,58 +732,26 @@ mchMsgGetFanPropNat(MchData mchData, uint8_t *data, uint8_t fruIndex)
 {
 uint8_t  message[MSG_MAX_LENGTH]  = { 0 };
 uint8_t  response[MSG_MAX_LENGTH] = { 0 };
-size_t   imsg2Size    = sizeof( SEND_MSG_MSG );
-size_t   b1msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b1msg2Size   = sizeof( SEND_MSG_MSG );
-size_t   b2msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b2msg2Size   = sizeof( GET_FAN_PROP_MSG );
+size_t   imsg2Size    = sizeof( GET_FAN_PROP_MSG );
 uint8_t  imsg2[imsg2Size];
-uint8_t  b1msg1[b1msg1Size];
-uint8_t  b1msg2[b1msg2Size];
-uint8_t  b2msg1[b2msg1Size];
-uint8_t  b2msg2[b2msg2Size];
 size_t   messageSize;
-size_t   roffs;
-size_t   payloadSize  = IPMI_RPLY_GET_FAN_PROP_LENGTH;
-size_t   responseSize = 2*IPMI_MSG1_LENGTH + 2*IPMI_RPLY_IMSG2_SEND_MSG_LENGTH;
+Fru      fru = &mchData->mchSys->fru[fruIndex];
+IpmiRoute route       = mchNatRoute( mchData, fru );
+size_t   responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_PROP, 0 );
 uint8_t  cmd          = IPMI_MSG_CMD_GET_FAN_PROP;
 uint8_t  netfn        = IPMI_MSG_NETFN_PICMG;
-int      rval, bridged = 0;
-Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr, fruId = fru->sdr.fruId;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	memcpy( imsg2,  SEND_MSG_MSG , imsg2Size  );
-	memcpy( b1msg1, IPMI_MSG1    , b1msg1Size );
-
-	imsg2[IPMI_MSG2_CHAN_OFFSET]    = IPMI_MSG_CHAN_IPMB0 + IPMI_MSG_TRACKING;
-	b1msg1[IPMI_MSG1_RSADDR_OFFSET] = IPMI_MSG_ADDR_CM;
-
-	memcpy( b1msg2, SEND_MSG_MSG      , b1msg2Size );
-	memcpy( b2msg1, IPMI_MSG1         , b2msg1Size );
-	memcpy( b2msg2, GET_FAN_PROP_MSG , b2msg2Size );
+int      rval;
 
-	b1msg2[IPMI_MSG2_RQADDR_OFFSET]   = IPMI_MSG_ADDR_BMC;
-	b2msg1[IPMI_MSG1_NETFNLUN_OFFSET] = netfn << 2;
-	b1msg2[IPMI_MSG2_CHAN_OFFSET]     = IPMI_MSG_CHAN_IPMBL + IPMI_MSG_TRACKING;
-	b2msg1[IPMI_MSG1_RSADDR_OFFSET]   = FRU_I2C_ADDR[fruId];
-	b2msg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
+	memcpy( imsg2, GET_FAN_PROP_MSG, imsg2Size );
 
-       	messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, b1msg2, b1msg2Size, b2msg1, b2msg2, b2msg2Size );
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
 
-	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, roffs, 0 )) )
-		goto bail;
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanPropNat size error\n");
-		goto bail;
-	}
+	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, route->roffs, 0 )) )
+		return rval;
 
-	memcpy( data, response + roffs, payloadSize );
-    
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetFanPropNat", route, IPMI_CMD_GET_FAN_PROP, data, response, responseSize, 0 );
 }
 
 /* Get Fan Properties - For ATCA
@@ -861,28 +765,17 @@ int
 mchMsgGetFanPropAtca(MchData mchData, uint8_t *data, uint8_t fruIndex)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_GET_FAN_PROP_LENGTH; 
-int      rval, bridged = 0;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = fru->sdr.addr, rqAddr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgGetFanProp( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, fru->sdr.fruId )) )
-		goto bail;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanPropAtca size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_PROP, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetFanProp( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru->sdr.fruId )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetFanPropAtca", route, IPMI_CMD_GET_FAN_PROP, data, response, responseSize, 0 );
 }
 
 /* Details of this algorithm specified in PICMG 3.0 Rev 3.0 ATCA Base Spec, Table 3-87 */
@@ -924,39 +817,30 @@ uint8_t  imsg2Size = sizeof( GET_FAN_LEVEL_MSG );
 uint8_t  imsg2[imsg2Size];
 size_t   messageSize;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize, payloadSize = IPMI_RPLY_GET_FAN_LEVEL_LENGTH; 
-int      rval, offs=0, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr, fruId = fru->sdr.fruId;
+size_t   responseSize;
+int      rval, offs=0;
 uint8_t  cmd   = IPMI_MSG_CMD_GET_FAN_LEVEL;
 uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_LEVEL, 0 );
 
 	memcpy( imsg2, GET_FAN_LEVEL_MSG, imsg2Size );
 
-	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fru->sdr.fruId;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( mchData->ipmiSess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
 	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, offs/*need to set codeoffs*/, 0 )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanLevelVt size error\n");
-		goto bail;
-	}
+		return rval;
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = mchMsgRply( "mchMsgGetFanLevelVt", route, IPMI_CMD_GET_FAN_LEVEL, data, response, responseSize, 0 )) )
+		return rval;
 
 	mchGetFanLevel( data, level, fru->fanProp );
 
-bail:
-	return rval;
+	return 0;
 }
 
 /* Get Fan Level using NAT MCH; message contains 2 bridged messages 
@@ -970,60 +854,31 @@ mchMsgGetFanLevelNat(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t *
 {
 uint8_t  message[MSG_MAX_LENGTH]  = { 0 };
 uint8_t  response[MSG_MAX_LENGTH] = { 0 };
-size_t   imsg2Size    = sizeof( SEND_MSG_MSG );
-size_t   b1msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b1msg2Size   = sizeof( SEND_MSG_MSG );
-size_t   b2msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b2msg2Size   = sizeof( GET_FAN_LEVEL_MSG );
+size_t   imsg2Size    = sizeof( GET_FAN_LEVEL_MSG );
 uint8_t  imsg2[imsg2Size];
-uint8_t  b1msg1[b1msg1Size];
-uint8_t  b1msg2[b1msg2Size];
-uint8_t  b2msg1[b2msg1Size];
-uint8_t  b2msg2[b2msg2Size];
 size_t   messageSize;
-size_t   roffs;
-size_t   payloadSize  = IPMI_RPLY_GET_FAN_LEVEL_LENGTH;
-size_t   responseSize = 2*IPMI_MSG1_LENGTH + 2*IPMI_RPLY_IMSG2_SEND_MSG_LENGTH;
+Fru      fru = &mchData->mchSys->fru[fruIndex];
+IpmiRoute route       = mchNatRoute( mchData, fru );
+size_t   responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_LEVEL, 0 );
 uint8_t  cmd          = IPMI_MSG_CMD_GET_FAN_LEVEL;
 uint8_t  netfn        = IPMI_MSG_NETFN_PICMG;
-int      rval, bridged = 0;
-Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr, fruId = fru->sdr.fruId;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	memcpy( imsg2,  SEND_MSG_MSG , imsg2Size  );
-	memcpy( b1msg1, IPMI_MSG1    , b1msg1Size );
-
-	imsg2[IPMI_MSG2_CHAN_OFFSET]    = IPMI_MSG_CHAN_IPMB0 + IPMI_MSG_TRACKING;
-	b1msg1[IPMI_MSG1_RSADDR_OFFSET] = IPMI_MSG_ADDR_CM;
-
-	memcpy( b1msg2, SEND_MSG_MSG      , b1msg2Size );
-	memcpy( b2msg1, IPMI_MSG1         , b2msg1Size );
-	memcpy( b2msg2, GET_FAN_LEVEL_MSG , b2msg2Size );
+int      rval;
 
-	b1msg2[IPMI_MSG2_RQADDR_OFFSET]   = IPMI_MSG_ADDR_BMC;
-	b2msg1[IPMI_MSG1_NETFNLUN_OFFSET] = netfn << 2;
-	b1msg2[IPMI_MSG2_CHAN_OFFSET]     = IPMI_MSG_CHAN_IPMBL + IPMI_MSG_TRACKING;
-	b2msg1[IPMI_MSG1_RSADDR_OFFSET]   = FRU_I2C_ADDR[fruId];
-	b2msg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
+	memcpy( imsg2, GET_FAN_LEVEL_MSG, imsg2Size );
 
-       	messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, b1msg2, b1msg2Size, b2msg1, b2msg2, b2msg2Size );
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
 
-	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, roffs, 0 )) )
-		goto bail;
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanLevelNat size error\n");
-		goto bail;
-	}
+	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, route->roffs, 0 )) )
+		return rval;
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = mchMsgRply( "mchMsgGetFanLevelNat", route, IPMI_CMD_GET_FAN_LEVEL, data, response, responseSize, 0 )) )
+		return rval;
 
 	mchGetFanLevel( data, level, fru->fanProp );
 
-bail:    
-	return rval;
+	return 0;
 }
 
 /* Get Fan Level - For ATCA
@@ -1037,30 +892,22 @@ int
 mchMsgGetFanLevelAtca(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t *level)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_GET_FAN_LEVEL_LENGTH; 
-int      rval, bridged = 0;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = fru->sdr.addr, rqAddr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = ipmiMsgGetFanLevel( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, fru->sdr.fruId )) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_FAN_LEVEL, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetFanLevelAtca size error\n");
-		goto bail;
-	}
+	if ( (rval = ipmiMsgGetFanLevel( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru->sdr.fruId )) )
+		return rval;
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = mchMsgRply( "mchMsgGetFanLevelAtca", route, IPMI_CMD_GET_FAN_LEVEL, data, response, responseSize, 0 )) )
+		return rval;
 
 	mchGetFanLevel( data, level, fru->fanProp );
 
-bail:
-	return rval;
+	return 0;
 }
 
 /* Set Fan Level using Vadatech MCH; message contains 1 bridged message  -> needs updating 3/23/16
@@ -1076,37 +923,27 @@ uint8_t  message[MSG_MAX_LENGTH] = { 0 };
 uint8_t  imsg2Size = sizeof( SET_FAN_LEVEL_MSG );
 uint8_t  imsg2[imsg2Size];
 size_t   messageSize;
-
+Fru      fru = &mchData->mchSys->fru[fruIndex];
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize, payloadSize = IPMI_RPLY_SET_FAN_LEVEL_LENGTH; 
-int      rval, offs=0, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr, fruId = mchData->mchSys->fru[fruIndex].sdr.fruId;
+size_t   responseSize;
+int      rval, offs=0;
 uint8_t  cmd   = IPMI_MSG_CMD_SET_FAN_LEVEL;
 uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
+	responseSize = mchMsgRplySize( route, IPMI_CMD_SET_FAN_LEVEL, 0 );
 
 	memcpy( imsg2, SET_FAN_LEVEL_MSG, imsg2Size );
 
-	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fru->sdr.fruId;
 	imsg2[IPMI_MSG2_SET_FAN_LEVEL_OFFSET]   = level;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( mchData->ipmiSess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
 	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, offs/*need to set codeoffs*/, 0 )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetFanLevelVt size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgSetFanLevelVt", route, IPMI_CMD_SET_FAN_LEVEL, data, response, responseSize, 0 );
 }
 
 /* Set Fan Level using NAT MCH; message contains 2 bridged messages
@@ -1120,56 +957,27 @@ mchMsgSetFanLevelNat(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t l
 {
 uint8_t  message[MSG_MAX_LENGTH]  = { 0 };
 uint8_t  response[MSG_MAX_LENGTH] = { 0 };
-size_t   imsg2Size    = sizeof( SEND_MSG_MSG );
-size_t   b1msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b1msg2Size   = sizeof( SEND_MSG_MSG );
-size_t   b2msg1Size   = sizeof( IPMI_MSG1 );
-size_t   b2msg2Size   = sizeof( GET_FAN_LEVEL_MSG );
+size_t   imsg2Size    = sizeof( SET_FAN_LEVEL_MSG );
 uint8_t  imsg2[imsg2Size];
-uint8_t  b1msg1[b1msg1Size];
-uint8_t  b1msg2[b1msg2Size];
-uint8_t  b2msg1[b2msg1Size];
-uint8_t  b2msg2[b2msg2Size];
 size_t   messageSize;
-size_t   offs         = IPMI_RPLY_2ND_BRIDGED_OFFSET_NAT;
-size_t   roffs        = IPMI_RPLY_HEADER_LENGTH + 3 + offs;
-size_t   payloadSize  = IPMI_RPLY_SET_FAN_LEVEL_LENGTH;
-size_t   responseSize = roffs + payloadSize + FOOTER_LENGTH;
+Fru      fru = &mchData->mchSys->fru[fruIndex];
+IpmiRoute route       = mchNatRoute( mchData, fru );
+size_t   responseSize = mchMsgRplySize( route, IPMI_CMD_SET_FAN_LEVEL, 0 );
 uint8_t  cmd          = IPMI_MSG_CMD_SET_FAN_LEVEL;
 uint8_t  netfn        = IPMI_MSG_NETFN_PICMG;
 int      rval;
-uint8_t  fruId = mchData->mchSys->fru[fruIndex].sdr.fruId;
 
-	memcpy( imsg2,  SEND_MSG_MSG , imsg2Size  );
-	memcpy( b1msg1, IPMI_MSG1    , b1msg1Size );
-
-	imsg2[IPMI_MSG2_CHAN_OFFSET]    = IPMI_MSG_CHAN_IPMB0 + IPMI_MSG_TRACKING;
-	b1msg1[IPMI_MSG1_RSADDR_OFFSET] = IPMI_MSG_ADDR_CM;
-
-	memcpy( b1msg2, SEND_MSG_MSG      , b1msg2Size );
-	memcpy( b2msg1, IPMI_MSG1         , b2msg1Size );
-	memcpy( b2msg2, SET_FAN_LEVEL_MSG , b2msg2Size );
+	memcpy( imsg2, SET_FAN_LEVEL_MSG, imsg2Size );
 
-	b1msg2[IPMI_MSG2_RQADDR_OFFSET]   = IPMI_MSG_ADDR_BMC;
-	b2msg1[IPMI_MSG1_NETFNLUN_OFFSET] = netfn << 2;
-	b1msg2[IPMI_MSG2_CHAN_OFFSET]     = IPMI_MSG_CHAN_IPMBL + IPMI_MSG_TRACKING;
-	b2msg1[IPMI_MSG1_RSADDR_OFFSET]   = FRU_I2C_ADDR[fruId];
-	b2msg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
-	b2msg2[IPMI_MSG2_SET_FAN_LEVEL_OFFSET] = level;
+	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = 0;
+	imsg2[IPMI_MSG2_SET_FAN_LEVEL_OFFSET]   = level;
 
-       	messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, b1msg2, b1msg2Size, b2msg1, b2msg2, b2msg2Size );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
-	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, offs/*need to set codeoffs*/, 0 )) )
-		goto bail;
+	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, route->roffs, 0 )) )
+		return rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetFanLevelNat size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
-    
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgSetFanLevelNat", route, IPMI_CMD_SET_FAN_LEVEL, data, response, responseSize, 0 );
 }
 
 /* Set Fan Level - For ATCA
@@ -1183,28 +991,17 @@ int
 mchMsgSetFanLevelAtca(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t level)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_SET_FAN_LEVEL_LENGTH; 
-int      rval, bridged = 0;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = fru->sdr.addr, rqAddr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = ipmiMsgSetFanLevel( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, fru->sdr.fruId, level )) )
-		goto bail;
+	responseSize = mchMsgRplySize( route, IPMI_CMD_SET_FAN_LEVEL, 0 );
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetFanLevelAtca size error\n");
-		goto bail;
-	}
-
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgSetFanLevel( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru->sdr.fruId, level )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgSetFanLevelAtca", route, IPMI_CMD_SET_FAN_LEVEL, data, response, responseSize, 0 );
 }
 
 /*  -> needs updating 3/23/16 */
@@ -1216,37 +1013,26 @@ uint8_t  imsg2Size = sizeof( GET_POWER_LEVEL_MSG );
 uint8_t  imsg2[imsg2Size];
 size_t   messageSize;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &mchData->mchSys->route );
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize, payloadSize = IPMI_RPLY_GET_POWER_LEVEL_LENGTH; 
-int      rval, offs=0, bridged = 0;
-uint8_t  rsAddr = IPMI_MSG_ADDR_BMC, rqAddr;
+size_t   responseSize;
+int      rval, offs=0;
 uint8_t  cmd   = IPMI_MSG_CMD_GET_POWER_LEVEL;
 uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
 
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr);
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_POWER_LEVEL, 0 );
 
 	memcpy( imsg2, GET_POWER_LEVEL_MSG, imsg2Size );
 
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET]      = fru->sdr.fruId;
 	imsg2[PICMG_RPLY_IMSG2_GET_POWER_LEVEL_TYPE_OFFSET] = parm;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( mchData->ipmiSess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( mchData->ipmiSess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	messageSize = ipmiMsgBuildRouted( mchData->ipmiSess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
 	if ( (rval = mchMsgWriteReadHelper( mchData->mchSess, mchData->ipmiSess, message, messageSize, response, &responseSize, cmd, netfn, offs/*need to set codeoffs*/, 0 )) )
-		goto bail;
-
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgGetPowerLevelVt size error\n");
-		goto bail;
-	}
-	memcpy( data, response + roffs, payloadSize );
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetPowerLevelVt", route, IPMI_CMD_GET_POWER_LEVEL, data, response, responseSize, 0 );
 }
 
 /* Set Fan Level - For ATCA
@@ -1260,28 +1046,17 @@ int
 mchMsgGetPowerLevelAtca(MchData mchData, uint8_t *data, uint8_t fruIndex, uint8_t parm)
 {
 uint8_t  response[MSG_MAX_LENGTH] = { 0 }; 
-size_t   roffs, responseSize = 0, payloadSize = IPMI_RPLY_GET_POWER_LEVEL_LENGTH; 
-int      rval, bridged = 0;
 Fru      fru = &mchData->mchSys->fru[fruIndex];
-uint8_t  rsAddr = fru->sdr.addr, rqAddr;
-
-	if ( rsAddr != IPMI_MSG_ADDR_BMC )
-		bridged = 1;
-
-	mchSetSizeOffs( mchData->ipmiSess, payloadSize, &roffs, &responseSize, &bridged, &rsAddr, &rqAddr );
-
-	if ( (rval = ipmiMsgGetPowerLevel( mchData->mchSess, mchData->ipmiSess, response, bridged, rsAddr, rqAddr, &responseSize, roffs, fru->sdr.fruId, parm )) )
-		goto bail;
+IpmiRoute route = mchRouteGet( mchData->ipmiSess, &fru->route );
+size_t   responseSize;
+int      rval;
 
-	if ( (rval = mchMsgCheckSizes( sizeof( response ), roffs, payloadSize )) ) {
-		printf("mchMsgSetFanLevelAtca size error\n");
-		goto bail;
-	}
+	responseSize = mchMsgRplySize( route, IPMI_CMD_GET_POWER_LEVEL, 0 );
 
-	memcpy( data, response + roffs, payloadSize );
+	if ( (rval = ipmiMsgGetPowerLevel( mchData->mchSess, mchData->ipmiSess, response, route, &responseSize, fru->sdr.fruId, parm )) )
+		return rval;
 
-bail:
-	return rval;
+	return mchMsgRply( "mchMsgGetPowerLevelAtca", route, IPMI_CMD_GET_POWER_LEVEL, data, response, responseSize, 0 );
 }
 
 
@@ -39,6 +39,7 @@ static void
 assign_fru_lkup_supermicro(MchData mchData)
 {
 uint8_t id, index;
+Fru     fru;
 
 	/* Supermicro does not use FRU device locator records, so no means to read a FRU ID
 	 * Associate all Supermicro and Advantech sensors with single FRU, arbitrarily choose 0
@@ -46,8 +47,13 @@ uint8_t id, index;
 	 * Force FRU count to be 1
 	 */
 	id = index = 0;
-	mchData->mchSys->fru[index].id = id;
-	mchData->mchSys->fru[index].sdr.addr = IPMI_MSG_ADDR_BMC;
+	if ( mchData->mchSys->fruCount > 0 )
+		fru = &mchData->mchSys->fru[index];
+	else if ( !(fru = mchFruAdd( mchData )) )
+		return;
+	fru->id = id;
+	fru->sdr.addr = IPMI_MSG_ADDR_BMC;
+	mchRouteInit( &fru->route, fru->sdr.addr, fru->sdr.chan );
 	mchData->mchSys->fruLkup[id] = index;
 	mchData->mchSys->fruCount = 1;
 
@@ -87,11 +93,12 @@ Fru fru;
 		}
 	}
 	if ( found == 0 ) { /* If FRU 0 not already in the data structure, add it */
-		fru = &mchData->mchSys->fru[mchData->mchSys->fruCount];
+		if ( !(fru = mchFruAdd( mchData )) )
+			return;
 		fru->id = 0;
 		mchData->mchSys->fruLkup[fru->id] = i;
 		fru->sdr.addr = IPMI_MSG_ADDR_BMC;
-		mchData->mchSys->fruCount++;		
+		mchRouteInit( &fru->route, fru->sdr.addr, fru->sdr.chan );
 	}
 
 }
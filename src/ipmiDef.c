@@ -148,6 +148,16 @@ uint8_t GET_SDR_MSG[]  =  { IPMI_MSG_ADDR_SW,            /* Requester's address
                             0,                           /* Bytes to read (0xFF for entire record) */
                             0 };                         /* For checksum */
 
+/* Get SEL Entry */
+uint8_t GET_SEL_ENTRY_MSG[] = { IPMI_MSG_ADDR_SW,       /* Requester's address */            
+                            0,                           /* Message sequence number */         
+                            IPMI_MSG_CMD_GET_SEL_ENTRY,  /* Command code */         
+			    0, 0,                        /* Reservation ID, LS byte first */
+			    0, 0,                        /* Record ID, LS byte first */
+			    0,                           /* Offset into record to begin read */
+                            0,                           /* Bytes to read (0xFF for entire record) */
+                            0 };                         /* For checksum */
+
 /* Get Device SDR Info   */
 uint8_t GET_DEV_SDR_INFO_MSG[] = { IPMI_MSG_ADDR_SW,      /* Requester's address */            
                             0,                             /* Message sequence number */         
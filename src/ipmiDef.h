@@ -73,9 +73,40 @@ typedef struct IpmiSessRec_ {
 	uint8_t       features;      /* Mask to describe vendor-specific behavior */
 	double        timeout;       /* Asyn read timeout */
         IpmiWriteReadHelper wrf;     /* Callback to driver write/read function */
+	struct IpmiRmcppRec_ *rmcpp; /* RMCP+ (IPMI v2.0) session state, see ipmiRmcpp.h; NULL if never used */
 } IpmiSessRec;
 
-	
+/* How a request reaches its target */
+#define IPMI_ROUTE_DIRECT        0 /* Sent to BMC */
+#define IPMI_ROUTE_BRIDGED       1 /* Embedded in Send Message to target on IPMB-0 */
+#define IPMI_ROUTE_BRIDGED_CM    2 /* Embedded twice: Send Message to carrier manager, which forwards to target on IPMB-L (NAT) */
+
+/* Number of commands per target whose learned reply length can be remembered;
+ * only lengths that differ from the command table are stored
+ */
+#define IPMI_ROUTE_RPLY_SLOTS    4
+
+/* Route to a message target (BMC, carrier manager, AMC/RTM controller).
+ * Built once per target by the driver and consumed by the ipmiMsg* builders,
+ * so that addressing and reply offsets are not recomputed for every message.
+ * Depends on session authentication type and BMC features; key records
+ * which ones it was built for so that it can be rebuilt when they change.
+ */
+typedef struct IpmiRouteRec_ {
+	uint8_t       key;           /* Authentication type/features route was built for; 0 if not yet built */
+	uint8_t       addr;          /* Target IPMB address */
+	uint8_t       chan;          /* Target channel */
+	uint8_t       type;          /* Requested path, IPMI_ROUTE_xxx; set with target */
+	uint8_t       bridged;       /* Path used in this session, IPMI_ROUTE_xxx (BMC may require bridging of all requests) */
+	uint8_t       rsAddr;        /* Responder address of first embedded message */
+	uint8_t       rqAddr;        /* Requester address of embedded message */
+	uint8_t       sendChan;      /* Send Message channel, including tracking bit */
+	uint8_t       roffs;         /* Offset of reply payload (completion code) in response */
+	uint8_t       rplyId[IPMI_ROUTE_RPLY_SLOTS];  /* Commands (IPMI_CMD_xxx + 1) whose reply length differs from command table; 0 if slot unused */
+	uint8_t       rplyLen[IPMI_ROUTE_RPLY_SLOTS]; /* Reply payload length learned from target for rplyId */
+} IpmiRouteRec, *IpmiRoute;
+
+
 /* Data structure for Sensor Data Record (one per sensor) IPMI v2.0 Section 43.1
  * Used for both Full and Compact SDRs
  * In this implementation, we don't support all of the Full SDR fields
@@ -269,6 +300,7 @@ extern uint8_t SENS_READ_MSG[5];
 extern uint8_t GET_SENSOR_THRESH_MSG[5];
 extern uint8_t FRU_READ_MSG[8];
 extern uint8_t GET_SDR_MSG[10];
+extern uint8_t GET_SEL_ENTRY_MSG[10];
 extern uint8_t CLOSE_SESS_MSG[8];
 extern uint8_t CHAS_CTRL_MSG[5];
 extern uint8_t GET_DEV_SDR_INFO_MSG[5];            
@@ -357,6 +389,8 @@ extern size_t IPMI_MSG1_LENGTH;
 #define IPMI_MSG2_CHAN_OFFSET                3    /* Channel to send message over (0 for IPMB) */
 #define IPMI_MSG2_SENSOR_OFFSET              3    /* Sensor number */
 #define IPMI_MSG2_AUTH_TYPE_OFFSET           3    /* For Get Session Challenge and Activate Session */
+#define IPMI_MSG2_USER_OFFSET                4    /* Get Session Challenge user name */
+#define IPMI_MSG2_USER_LENGTH                16
 #define IPMI_MSG2_PRIV_LEVEL_OFFSET          3
 #define IPMI_MSG2_READ_FRU_ID_OFFSET         3    
 #define IPMI_MSG2_READ_FRU_LSB_OFFSET        4    /* FRU Inventory Offset to read, LS Byte */
@@ -369,6 +403,12 @@ extern size_t IPMI_MSG1_LENGTH;
 #define IPMI_MSG2_GET_SDR_OFFSET_OFFSET      7    /* Offset into record to start read */
 #define IPMI_MSG2_GET_SDR_CNT_OFFSET         8    /* Count to read in bytes (0xFF means entire record) */
 #define IPMI_MSG2_GET_DEV_SDR_INFO_OP_OFFSET 3    /* 1 get SDR count, 0 get sensor count */
+#define IPMI_MSG2_GET_SEL_RES_LSB_OFFSET     3    /* SEL Reservation ID, LS Byte */
+#define IPMI_MSG2_GET_SEL_RES_MSB_OFFSET     4    /* SEL Reservation ID, MS Byte */
+#define IPMI_MSG2_GET_SEL_ID_LSB_OFFSET      5    /* SEL Record ID, LS Byte */
+#define IPMI_MSG2_GET_SEL_ID_MSB_OFFSET      6    /* SEL Record ID, MS Byte */
+#define IPMI_MSG2_GET_SEL_OFFSET_OFFSET      7    /* Offset into record to start read */
+#define IPMI_MSG2_GET_SEL_CNT_OFFSET         8    /* Count to read in bytes (0xFF means entire record) */
 
 /* IPMI message command codes (cmd) */
 #define IPMI_MSG_CMD_GET_CHAN_AUTH           0x38
@@ -391,6 +431,9 @@ extern size_t IPMI_MSG1_LENGTH;
 #define IPMI_MSG_CMD_GET_DEV_SDR_INFO        0x20
 #define IPMI_MSG_CMD_GET_DEV_SDR             0x21
 #define IPMI_MSG_CMD_RESERVE_DEV_SDRREP      0x22
+#define IPMI_MSG_CMD_GET_SEL_INFO            0x40
+#define IPMI_MSG_CMD_RESERVE_SEL             0x42
+#define IPMI_MSG_CMD_GET_SEL_ENTRY           0x43
 #define IPMI_MSG_CMD_COLD_RESET              0x02
 #define IPMI_MSG_CMD_SET_FRU_POLICY          0x0A
 #define IPMI_MSG_CMD_GET_FRU_POLICY          0x0B
@@ -436,6 +479,9 @@ extern size_t IPMI_MSG1_LENGTH;
 #define IPMI_RPLY_IMSG2_GET_DEV_SDR_INFO_LENGTH        7
 #define IPMI_RPLY_IMSG2_GET_DEV_SDR_LENGTH             0  /* varies; base length is 3 */
 #define IPMI_RPLY_IMSG2_COLD_RESET_LENGTH              1
+#define IPMI_RPLY_IMSG2_GET_SEL_INFO_LENGTH            15
+#define IPMI_RPLY_IMSG2_RESERVE_SEL_LENGTH             3
+#define IPMI_RPLY_IMSG2_GET_SEL_ENTRY_LENGTH           19 /* next record ID + 16-byte record */
 #define IPMI_RPLY_IMSG2_SEND_MSG_LENGTH                4
 #define IPMI_RPLY_IMSG2_CLOSE_SESSION_LENGTH         1
 #define IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH       5 /* length varies */
@@ -527,6 +573,42 @@ extern size_t IPMI_MSG1_LENGTH;
 #define IPMI_RPLY_IMSG2_GET_SDR_RES_LSB_OFFSET         1     /* Reservation ID returned by Reserve SDR Rep */
 #define IPMI_RPLY_IMSG2_GET_SDR_RES_MSB_OFFSET         2     /* Reservation ID returned by Reserve SDR Rep */
 
+/* Get SEL Info message */
+#define IPMI_RPLY_IMSG2_SEL_VER_OFFSET                 1     /* SEL version */
+#define IPMI_RPLY_IMSG2_SEL_CNT_LSB_OFFSET             2     /* Number of entries in SEL, LSB */
+#define IPMI_RPLY_IMSG2_SEL_CNT_MSB_OFFSET             3     /* Number of entries in SEL, MSB */
+#define IPMI_RPLY_IMSG2_SEL_ADD_TS_OFFSET              6     /* Timestamp of most recent addition, LSB first */
+#define IPMI_RPLY_IMSG2_SEL_ERASE_TS_OFFSET            10    /* Timestamp of most recent erase, LSB first */
+#define IPMI_RPLY_IMSG2_SEL_OP_OFFSET                  14    /* Operation support, [1] Reserve SEL supported */
+#define IPMI_SEL_OP_RESERVE(x)                         ((x) & (1<<1))
+
+/* Reserve SEL message */
+#define IPMI_RPLY_IMSG2_SEL_RES_LSB_OFFSET             1     /* Reservation ID returned by Reserve SEL */
+#define IPMI_RPLY_IMSG2_SEL_RES_MSB_OFFSET             2     /* Reservation ID returned by Reserve SEL */
+
+/* Get SEL Entry message */
+#define IPMI_RPLY_IMSG2_SEL_NEXT_ID_LSB_OFFSET         1     /* ID of next entry in SEL, LSB; 0xFFFF if this is the last */
+#define IPMI_RPLY_IMSG2_SEL_NEXT_ID_MSB_OFFSET         2     /* ID of next entry in SEL, MSB */
+#define IPMI_RPLY_IMSG2_SEL_DATA_OFFSET                3     /* Requested SEL record */
+#define IPMI_SEL_ID_FIRST                              0x0000
+#define IPMI_SEL_ID_LAST                               0xFFFF
+
+/* SEL event record, offsets into record returned by Get SEL Entry */
+#define IPMI_SEL_REC_ID_OFFSET                         0     /* Record ID, LSB first */
+#define IPMI_SEL_REC_TYPE_OFFSET                       2     /* Record type */
+#define IPMI_SEL_REC_TS_OFFSET                         3     /* Timestamp, LSB first */
+#define IPMI_SEL_REC_GEN_ADDR_OFFSET                   7     /* Generator ID, [7:1] slave address or software ID; [0] 0 = IPMB, 1 = system software */
+#define IPMI_SEL_REC_GEN_LUN_OFFSET                    8     /* Generator ID, [7:4] channel number; [1:0] LUN */
+#define IPMI_SEL_REC_SENS_TYPE_OFFSET                  10    /* Sensor type code */
+#define IPMI_SEL_REC_SENS_NUM_OFFSET                   11    /* Sensor number */
+#define IPMI_SEL_REC_EVENT_TYPE_OFFSET                 12    /* [7] 0 = assertion, 1 = deassertion; [6:0] event/reading type code */
+#define IPMI_SEL_REC_EVENT_DATA_OFFSET                 13    /* Event data 1-3 */
+#define IPMI_SEL_REC_TYPE_SYSTEM                       0x02  /* System event record */
+#define IPMI_SEL_EVENT_DEASSERT(x)                     ((x) & 0x80)
+#define IPMI_SEL_EVENT_TYPE(x)                         ((x) & 0x7F)
+#define IPMI_SEL_EVENT_OFFSET(x)                       ((x) & 0x0F) /* Event data 1 [3:0], event offset */
+#define IPMI_EVENT_TYPE_THRESHOLD                      0x01  /* Event/reading type code for threshold sensors */
+
 /* Get FRU Inventory Area Info message */
 #define IPMI_RPLY_IMSG2_FRU_AREA_SIZE_LSB_OFFSET       1     /* FRU inventory area size in bytes, LSB */
 #define IPMI_RPLY_IMSG2_FRU_AREA_SIZE_MSB_OFFSET       2     /* FRU inventory area size in bytes, MSB */
@@ -894,14 +976,19 @@ extern size_t IPMI_MSG1_LENGTH;
 #define FRU_FIELD_LENGTH_TYPE_RAW       0
 #define FRU_FIELD_LENGTH_TYPE_CONVERTED 1
 
+/* Field data are stored out of line (see driver); fields with length 0 have no data */
 typedef struct FruFieldRec_ {
 	uint8_t     type;         /* Type of data */
 	uint8_t     rlength;      /* Length of raw data (bytes) */
-	uint8_t     rdata[MAX_FRU_FIELD_RAW_LENGTH]; /* Raw data */
 	uint8_t     length;       /* Length of data after converted to ASCII (bytes) */
-	uint8_t     data[MAX_FRU_FIELD_LENGTH]; /* Data */
+	uint8_t    *rdata;        /* Raw data, rlength bytes */
+	uint8_t    *data;         /* Data, length bytes plus terminating null */
 } FruFieldRec, *FruField;
 
+/* Size of a FRU field when raw and converted data were stored in-line */
+#define FRU_FIELD_INLINE_SIZE (3 + MAX_FRU_FIELD_RAW_LENGTH + MAX_FRU_FIELD_LENGTH)
+#define FRU_FIELD_COUNT       11 /* Fields per FRU: chassis 2, board 4, product 5 */
+
 /* Chassis area doesn't have a language field
  * Serial number always encoded in English
  */
@@ -410,6 +410,18 @@ codeDone:
 				case IPMI_MSG_CMD_GET_SDR:               
 					sprintf( cmdStr, "Get SDR" );
 					break;
+
+				case IPMI_MSG_CMD_GET_SEL_INFO:          
+					sprintf( cmdStr, "Get SEL Info" );
+					break;
+
+				case IPMI_MSG_CMD_RESERVE_SEL:           
+					sprintf( cmdStr, "Reserve SEL" );
+					break;
+
+				case IPMI_MSG_CMD_GET_SEL_ENTRY:         
+					sprintf( cmdStr, "Get SEL Entry" );
+					break;
 			}
 			break;
 
@@ -693,6 +705,76 @@ asynUser  *pasynUser;
 	return status;
 }
 
+/*
+ * In-session requests, indexed by IPMI_CMD_xxx (see ipmiMsg.h).
+ * Reply lengths are those given by the specs; a target whose replies are
+ * shorter has its own length learned by the driver (see mchMsgRplySize).
+ */
+const IpmiCmdRec ipmiCmdTable[IPMI_CMD_COUNT] = {
+	[IPMI_CMD_CHAS_CTRL]          = { IPMI_MSG_NETFN_CHASSIS,      IPMI_MSG_CMD_CHAS_CTRL,          CHAS_CTRL_MSG,         sizeof( CHAS_CTRL_MSG ),         IPMI_RPLY_IMSG2_CHAS_CTRL_LENGTH,         0, 0 },
+	[IPMI_CMD_GET_CHAS_STATUS]    = { IPMI_MSG_NETFN_CHASSIS,      IPMI_MSG_CMD_GET_CHAS_STATUS,    BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_GET_CHAS_STATUS_LENGTH,   0, 0 },
+	[IPMI_CMD_GET_FRU_INFO]       = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_GET_FRU_INFO,       SENS_READ_MSG,         sizeof( SENS_READ_MSG ),         IPMI_RPLY_IMSG2_GET_FRU_INV_INFO_LENGTH,  0, 0 },
+	[IPMI_CMD_READ_FRU_DATA]      = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_READ_FRU_DATA,      FRU_READ_MSG,          sizeof( FRU_READ_MSG ),          IPMI_RPLY_IMSG2_READ_FRU_DATA_BASE_LENGTH, 0, IPMI_CMD_RPLY_VAR },
+	[IPMI_CMD_GET_SDRREP_INFO]    = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_GET_SDRREP_INFO,    BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_GET_SDRREP_INFO_LENGTH,   0, 0 },
+	[IPMI_CMD_RESERVE_SDRREP]     = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_RESERVE_SDRREP,     BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_RESERVE_SDRREP_LENGTH,    0, 0 },
+	[IPMI_CMD_GET_SDR]            = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_GET_SDR,            GET_SDR_MSG,           sizeof( GET_SDR_MSG ),           IPMI_RPLY_IMSG2_GET_SDR_BASE_LENGTH,      0, IPMI_CMD_RPLY_VAR },
+	[IPMI_CMD_GET_DEV_SDR_INFO]   = { IPMI_MSG_NETFN_SENSOR_EVENT, IPMI_MSG_CMD_GET_DEV_SDR_INFO,   GET_DEV_SDR_INFO_MSG,  sizeof( GET_DEV_SDR_INFO_MSG ),  IPMI_RPLY_IMSG2_GET_DEV_SDR_INFO_LENGTH,  0, 0 },
+	[IPMI_CMD_RESERVE_DEV_SDRREP] = { IPMI_MSG_NETFN_SENSOR_EVENT, IPMI_MSG_CMD_RESERVE_DEV_SDRREP, BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_RESERVE_SDRREP_LENGTH,    0, 0 },
+	[IPMI_CMD_GET_DEV_SDR]        = { IPMI_MSG_NETFN_SENSOR_EVENT, IPMI_MSG_CMD_GET_DEV_SDR,        GET_SDR_MSG,           sizeof( GET_SDR_MSG ),           IPMI_RPLY_IMSG2_GET_SDR_BASE_LENGTH,      0, IPMI_CMD_RPLY_VAR },
+	[IPMI_CMD_GET_SEL_INFO]       = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_GET_SEL_INFO,       BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_GET_SEL_INFO_LENGTH,      0, 0 },
+	[IPMI_CMD_RESERVE_SEL]        = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_RESERVE_SEL,        BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_RESERVE_SEL_LENGTH,       0, 0 },
+	[IPMI_CMD_GET_SEL_ENTRY]      = { IPMI_MSG_NETFN_STORAGE,      IPMI_MSG_CMD_GET_SEL_ENTRY,      GET_SEL_ENTRY_MSG,     sizeof( GET_SEL_ENTRY_MSG ),     IPMI_RPLY_IMSG2_GET_SEL_ENTRY_LENGTH,     0, 0 },
+	[IPMI_CMD_SENSOR_READ]        = { IPMI_MSG_NETFN_SENSOR_EVENT, IPMI_MSG_CMD_SENSOR_READ,        SENS_READ_MSG,         sizeof( SENS_READ_MSG ),         IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH,   0, 0 },
+	[IPMI_CMD_GET_SENSOR_THRESH]  = { IPMI_MSG_NETFN_SENSOR_EVENT, IPMI_MSG_CMD_GET_SENSOR_THRESH,  GET_SENSOR_THRESH_MSG, sizeof( GET_SENSOR_THRESH_MSG ), IPMI_RPLY_IMSG2_GET_SENSOR_THRESH_LENGTH, 0, 0 },
+	[IPMI_CMD_GET_DEVICE_ID]      = { IPMI_MSG_NETFN_APP_REQUEST,  IPMI_MSG_CMD_GET_DEVICE_ID,      BASIC_MSG,             sizeof( BASIC_MSG ),             IPMI_RPLY_IMSG2_GET_DEVICE_ID_LENGTH,     0, 0 },
+	[IPMI_CMD_GET_ADDR_INFO]      = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_ADDR_INFO,      GET_ADDR_INFO_MSG,     sizeof( GET_ADDR_INFO_MSG ),     PICMG_RPLY_GET_ADDR_INFO_LENGTH,          0, 0 },
+	[IPMI_CMD_GET_ADDR_INFO_IPMC] = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_ADDR_INFO,      GET_PICMG_PROP_MSG,    sizeof( GET_PICMG_PROP_MSG ),    PICMG_RPLY_GET_ADDR_INFO_LENGTH,          0, 0 },
+	[IPMI_CMD_GET_PICMG_PROP]     = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_PICMG_PROP,     GET_PICMG_PROP_MSG,    sizeof( GET_PICMG_PROP_MSG ),    IPMI_RPLY_IMSG2_GET_PICMG_PROP_LENGTH,    0, 0 },
+	[IPMI_CMD_GET_POWER_LEVEL]    = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_POWER_LEVEL,    GET_POWER_LEVEL_MSG,   sizeof( GET_POWER_LEVEL_MSG ),   IPMI_RPLY_GET_POWER_LEVEL_LENGTH,         0, 0 },
+	[IPMI_CMD_GET_FAN_PROP]       = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_FAN_PROP,       GET_FAN_PROP_MSG,      sizeof( GET_FAN_PROP_MSG ),      IPMI_RPLY_GET_FAN_PROP_LENGTH,            0, 0 },
+	[IPMI_CMD_GET_FAN_LEVEL]      = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_FAN_LEVEL,      GET_FAN_LEVEL_MSG,     sizeof( GET_FAN_LEVEL_MSG ),     IPMI_RPLY_GET_FAN_LEVEL_LENGTH,           0, 0 },
+	[IPMI_CMD_SET_FAN_LEVEL]      = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_SET_FAN_LEVEL,      SET_FAN_LEVEL_MSG,     sizeof( SET_FAN_LEVEL_MSG ),     IPMI_RPLY_SET_FAN_LEVEL_LENGTH,           0, 0 },
+	[IPMI_CMD_SET_FRU_ACT]        = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_SET_FRU_ACT,        SET_FRU_ACT_MSG,       sizeof( SET_FRU_ACT_MSG ),       PICMG_RPLY_SET_FRU_ACT_LENGTH,            0, 0 },
+	[IPMI_CMD_GET_FRU_POLICY]     = { IPMI_MSG_NETFN_PICMG,        IPMI_MSG_CMD_GET_FRU_POLICY,     GET_FRU_POLICY_MSG,    sizeof( GET_FRU_POLICY_MSG ),    IPMI_RPLY_GET_FRU_POLICY_LENGTH,          0, 0 },
+};
+
+/*
+ * Copy request template of command to imsg2 (MSG_MAX_LENGTH bytes) 
+ * and set its command code.
+ *
+ *   RETURNS: size of request
+ */
+size_t
+ipmiMsgCmdInit(int id, uint8_t *imsg2)
+{
+const IpmiCmdRec *c = &ipmiCmdTable[id];
+
+	memcpy( imsg2, c->msg, c->msgSize );
+	imsg2[IPMI_MSG2_CMD_OFFSET] = c->cmd;
+
+	return c->msgSize;
+}
+
+/*
+ * Build in-session request from command descriptor and request imsg2 
+ * (see ipmiMsgCmdInit), send it to target described by route and read reply.
+ *
+ *   RETURNS: status from sess->wrf
+ *            0 on success
+ *            non-zero for error
+ */
+int
+ipmiMsgCmd(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, int id, uint8_t *imsg2, uint8_t lun, size_t *responseSize)
+{
+uint8_t  message[MSG_MAX_LENGTH] = { 0 };
+const IpmiCmdRec *c = &ipmiCmdTable[id];
+size_t   messageSize;
+
+	messageSize = ipmiMsgBuildRouted( sess, message, c->cmd, c->netfn, route, imsg2, c->msgSize, lun );
+
+	return sess->wrf( device, sess, message, messageSize, data, responseSize, c->cmd, c->netfn, route->roffs + c->codeOffs, 0 );
+}
+
 /*
  * To start a session, perform the following sequence of messages:
  * 
@@ -818,26 +900,15 @@ uint8_t  cmd = IPMI_MSG_CMD_COLD_RESET;
  *            non-zero for error
  */
 int
-ipmiMsgChassisControl(void *device, IpmiSess sess,  uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t parm, size_t *responseSize, int roffs)
+ipmiMsgChassisControl(void *device, IpmiSess sess,  uint8_t *data, IpmiRoute route, uint8_t parm, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( CHAS_CTRL_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_CHAS_CTRL;
-uint8_t  netfn = IPMI_MSG_NETFN_CHASSIS;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, CHAS_CTRL_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_CHAS_CTRL, imsg2 );
 
 	imsg2[IPMI_MSG2_SENSOR_OFFSET] = parm;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_CHAS_CTRL, imsg2, 0, responseSize );
 }
 
 /* Get Chassis Status
@@ -847,24 +918,13 @@ uint8_t  netfn = IPMI_MSG_NETFN_CHASSIS;
  *            non-zero for error
  */
 int
-ipmiMsgGetChassisStatus(void *device, IpmiSess sess,  uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs)
+ipmiMsgGetChassisStatus(void *device, IpmiSess sess,  uint8_t *data, IpmiRoute route, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( BASIC_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_CHAS_STATUS;
-uint8_t  netfn = IPMI_MSG_NETFN_CHASSIS;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, BASIC_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_CHAS_STATUS, imsg2 );
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_CHAS_STATUS, imsg2, 0, responseSize );
 }
 
 /* Get FRU Inventory Info 
@@ -874,26 +934,15 @@ uint8_t  netfn = IPMI_MSG_NETFN_CHASSIS;
  *            non-zero for error
  */
 int
-ipmiMsgGetFruInvInfo(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t id, size_t *responseSize, int roffs)
+ipmiMsgGetFruInvInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t id, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( SENS_READ_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_FRU_INFO;
-uint8_t  netfn = IPMI_MSG_NETFN_STORAGE;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, SENS_READ_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_FRU_INFO, imsg2 );
 
 	imsg2[IPMI_MSG2_SENSOR_OFFSET] = id;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_FRU_INFO, imsg2, 0, responseSize );
 }
 
 /* Read FRU data 
@@ -903,30 +952,18 @@ uint8_t  netfn = IPMI_MSG_NETFN_STORAGE;
  *            non-zero for error
  */
 int
-ipmiMsgReadFru(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t id, uint8_t *readOffset, uint8_t readSize, size_t *responseSize, int roffs)
+ipmiMsgReadFru(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t id, uint8_t *readOffset, uint8_t readSize, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( FRU_READ_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_READ_FRU_DATA;
-uint8_t  netfn = IPMI_MSG_NETFN_STORAGE;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, FRU_READ_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_READ_FRU_DATA, imsg2 );
 
-	imsg2[IPMI_MSG2_CMD_OFFSET]          = cmd;
 	imsg2[IPMI_MSG2_READ_FRU_ID_OFFSET]  = id;
 	imsg2[IPMI_MSG2_READ_FRU_LSB_OFFSET] = readOffset[0];
 	imsg2[IPMI_MSG2_READ_FRU_MSB_OFFSET] = readOffset[1];
 	imsg2[IPMI_MSG2_READ_FRU_CNT_OFFSET] = readSize;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_READ_FRU_DATA, imsg2, 0, responseSize );
 }
 
 /* Get device, sess Sensor Data Record (SDR) Info 
@@ -936,7 +973,7 @@ uint8_t  netfn = IPMI_MSG_NETFN_STORAGE;
  *            non-zero for error
  *
 int
-ipmiMsgGetDevSdrInfo(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t parm, size_t *responseSize, int roffs)
+ipmiMsgGetDevSdrInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t parm, size_t *responseSize)
 {
 uint8_t  message[MSG_MAX_LENGTH] = { 0 };
 uint8_t  imsg2Size = sizeof( GET_DEV_SDR_INFO_MSG );
@@ -948,12 +985,9 @@ uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
 	memcpy( imsg2, GET_DEV_SDR_INFO_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
 
-	if ( bridged ) / may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	messageSize = ipmiMsgBuildRouted( sess, message, cmd, netfn, route, imsg2, imsg2Size, 0 );
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, route->roffs, 0 );
 }
 */
 
@@ -967,27 +1001,14 @@ uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
  *            non-zero for error
  */
 int
-ipmiMsgGetSdrRepInfo(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t parm)
+ipmiMsgGetSdrRepInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t parm)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = (parm == IPMI_SDRREP_PARM_GET_DEV_SDR) ? sizeof( GET_DEV_SDR_INFO_MSG ) : sizeof( BASIC_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_CMD_GET_DEV_SDR_INFO : IPMI_MSG_CMD_GET_SDRREP_INFO;
-uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EVENT   : IPMI_MSG_NETFN_STORAGE;
-
-	if ( parm == IPMI_SDRREP_PARM_GET_DEV_SDR )
-		memcpy( imsg2, GET_DEV_SDR_INFO_MSG, imsg2Size );
-	else
-		memcpy( imsg2, BASIC_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+int      id = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_GET_DEV_SDR_INFO : IPMI_CMD_GET_SDRREP_INFO;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	ipmiMsgCmdInit( id, imsg2 );
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, id, imsg2, 0, responseSize );
 }
 
 /* Reserve SDR (Sensor Data Record) Repository 
@@ -1000,24 +1021,14 @@ uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EV
  *            non-zero for error
  */
 int
-ipmiMsgReserveSdrRep(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t parm)
+ipmiMsgReserveSdrRep(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t parm)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( BASIC_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_CMD_RESERVE_DEV_SDRREP : IPMI_MSG_CMD_RESERVE_SDRREP;
-uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EVENT     : IPMI_MSG_NETFN_STORAGE;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+int      id = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_RESERVE_DEV_SDRREP : IPMI_CMD_RESERVE_SDRREP;
 
-	memcpy( imsg2, BASIC_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( id, imsg2 );
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, id, imsg2, 0, responseSize );
 }
 
 /* 
@@ -1034,19 +1045,13 @@ uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EV
  *            non-zero for error
  */
 int
-ipmiMsgGetSdr(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, size_t *responseSize, int roffs, uint8_t parm)
+ipmiMsgGetSdr(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, size_t *responseSize, uint8_t parm)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_SDR_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_CMD_GET_DEV_SDR    : IPMI_MSG_CMD_GET_SDR;
-uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EVENT : IPMI_MSG_NETFN_STORAGE;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+int      cmd = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_CMD_GET_DEV_SDR : IPMI_CMD_GET_SDR;
 
-	memcpy( imsg2, GET_SDR_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( cmd, imsg2 );
 
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
 	imsg2[IPMI_MSG2_GET_SDR_RES_LSB_OFFSET] = res[0];
 	imsg2[IPMI_MSG2_GET_SDR_RES_MSB_OFFSET] = res[1];
 	imsg2[IPMI_MSG2_GET_SDR_ID_LSB_OFFSET]  = id[0];
@@ -1054,12 +1059,66 @@ uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EV
 	imsg2[IPMI_MSG2_GET_SDR_OFFSET_OFFSET]  = offset;
 	imsg2[IPMI_MSG2_GET_SDR_CNT_OFFSET]     = readSize;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	return ipmiMsgCmd( device, sess, data, route, cmd, imsg2, 0, responseSize );
+}
+
+/* Get SEL (System Event Log) Info 
+ *
+ *   RETURNS: status from sess->wrf
+ *            0 on success
+ *            non-zero for error
+ */
+int
+ipmiMsgGetSelInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
+{
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_SEL_INFO, imsg2 );
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_SEL_INFO, imsg2, 0, responseSize );
+}
+
+/* Reserve SEL (System Event Log) 
+ *
+ *   RETURNS: status from sess->wrf
+ *            0 on success
+ *            non-zero for error
+ */
+int
+ipmiMsgReserveSel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
+{
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_RESERVE_SEL, imsg2 );
+
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_RESERVE_SEL, imsg2, 0, responseSize );
+}
+
+/* 
+ * Get SEL (System Event Log) Entry
+ * 
+ * Always reads entire record. Record ID 0x0000 is the first entry in the SEL,
+ * 0xFFFF the last. Reservation ID may be 0 for a read of the entire record.
+ *
+ *   RETURNS: status from sess->wrf
+ *            0 on success
+ *            non-zero for error
+ */
+int
+ipmiMsgGetSelEntry(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t *id, uint8_t *res, size_t *responseSize)
+{
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_SEL_ENTRY, imsg2 );
+
+	imsg2[IPMI_MSG2_GET_SEL_RES_LSB_OFFSET] = res[0];
+	imsg2[IPMI_MSG2_GET_SEL_RES_MSB_OFFSET] = res[1];
+	imsg2[IPMI_MSG2_GET_SEL_ID_LSB_OFFSET]  = id[0];
+	imsg2[IPMI_MSG2_GET_SEL_ID_MSB_OFFSET]  = id[1];
+	imsg2[IPMI_MSG2_GET_SEL_OFFSET_OFFSET]  = 0;
+	imsg2[IPMI_MSG2_GET_SEL_CNT_OFFSET]     = 0xFF;
+
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_SEL_ENTRY, imsg2, 0, responseSize );
 }
 	
 /* Get Sensor Reading. Caller specifies expected message response length. 
@@ -1069,26 +1128,15 @@ uint8_t  netfn = (parm==IPMI_SDRREP_PARM_GET_DEV_SDR) ? IPMI_MSG_NETFN_SENSOR_EV
  *            non-zero for error
  */
 int
-ipmiMsgReadSensor(void *device, IpmiSess sess, uint8_t *data, uint8_t bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t sens, uint8_t lun, size_t *responseSize, int roffs)
+ipmiMsgReadSensor(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t sens, uint8_t lun, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( SENS_READ_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_SENSOR_READ;
-uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, SENS_READ_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_SENSOR_READ, imsg2 );
 
 	imsg2[IPMI_MSG2_SENSOR_OFFSET] = sens;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, lun );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_SENSOR_READ, imsg2, lun, responseSize );
 }
 
 /* Get Sensor Thresholds 
@@ -1097,27 +1145,16 @@ uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
  *            0 on success
  *            non-zero for error
  */
-int 
-ipmiMsgGetSensorThresholds(void *device, IpmiSess sess, uint8_t *data, uint8_t bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t sens, uint8_t lun, size_t *responseSize, int roffs)
+int
+ipmiMsgGetSensorThresholds(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t sens, uint8_t lun, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_SENSOR_THRESH_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_SENSOR_THRESH;
-uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, GET_SENSOR_THRESH_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_SENSOR_THRESH, imsg2 );
 
 	imsg2[IPMI_MSG2_SENSOR_OFFSET] = sens;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, lun );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_SENSOR_THRESH, imsg2, lun, responseSize );
 }
 
 
@@ -1128,24 +1165,13 @@ uint8_t  netfn = IPMI_MSG_NETFN_SENSOR_EVENT;
  *            non-zero for error
  */
 int
-ipmiMsgGetDeviceId(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs)
+ipmiMsgGetDeviceId(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( BASIC_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_DEVICE_ID;
-uint8_t  netfn = IPMI_MSG_NETFN_APP_REQUEST;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, BASIC_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_DEVICE_ID, imsg2 );
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_DEVICE_ID, imsg2, 0, responseSize );
 }
 /* Get device, sess ID
  *
@@ -1154,24 +1180,21 @@ uint8_t  netfn = IPMI_MSG_NETFN_APP_REQUEST;
  *            non-zero for error
  */
 int
-ipmiMsgBroadcastGetDeviceId(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs)
+ipmiMsgBroadcastGetDeviceId(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
 {
 uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( BASIC_MSG );
-uint8_t  imsg2[imsg2Size];
+uint8_t  imsg2[MSG_MAX_LENGTH];
+const IpmiCmdRec *c = &ipmiCmdTable[IPMI_CMD_GET_DEVICE_ID];
 size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_DEVICE_ID;
-uint8_t  netfn = IPMI_MSG_NETFN_APP_REQUEST;
-
-        memcpy( imsg2, BASIC_MSG, imsg2Size );
-        imsg2[IPMI_MSG2_CMD_OFFSET] = cmd;
-   
-        if ( bridged ) // may need to distinguish between once and twice-bridged messages
-                ipmiBuildSendMsg( sess, message+1, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-        else
-                messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-        return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_DEVICE_ID, imsg2 );
+
+	if ( route->bridged )
+		messageSize = ipmiMsgBuildRouted( sess, message+1, c->cmd, c->netfn, route, imsg2, c->msgSize, 0 );
+	else
+		messageSize = ipmiMsgBuild( sess, message, c->cmd, c->netfn, imsg2, c->msgSize, 0, 0, 0, 0, 0, 0 );
+
+	return sess->wrf( device, sess, message, messageSize, data, responseSize, c->cmd, c->netfn, route->roffs + c->codeOffs, 0 );
 }
 
 /* Name this PICMG? */
@@ -1183,32 +1206,19 @@ uint8_t  netfn = IPMI_MSG_NETFN_APP_REQUEST;
  *            non-zero for error
  */
 int
-ipmiMsgGetAddressInfoIpmb0(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, 
+ipmiMsgGetAddressInfoIpmb0(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, 
 			     uint8_t fru, uint8_t key)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_ADDR_INFO_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_ADDR_INFO;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, GET_ADDR_INFO_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_ADDR_INFO, imsg2 );
 
+	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_FRUID_OFFSET]     = fru;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_KEY_TYPE_OFFSET]  = PICMG_ADDR_KEY_TYPE_IPMB0;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_KEY_OFFSET]       = key;
-// if using different routines for different types of get hw address requests, may not need to pass these
-// values as arguments; can be hard-coded in routine
-
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_ADDR_INFO, imsg2, 0, responseSize );
 }
 
 /* Name this PICMG? */
@@ -1220,33 +1230,20 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  *            non-zero for error
  */
 int
-ipmiMsgGetAddressInfoHwAddr(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, 
+ipmiMsgGetAddressInfoHwAddr(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, 
 			     uint8_t fru, uint8_t keytype, uint8_t key, uint8_t sitetype)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_ADDR_INFO_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_ADDR_INFO;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, GET_ADDR_INFO_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_ADDR_INFO, imsg2 );
 
+	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_FRUID_OFFSET]     = fru;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_KEY_TYPE_OFFSET]  = keytype;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_KEY_OFFSET]       = key;
 	imsg2[PICMG_IMSG2_GET_ADDR_INFO_SITE_TYPE_OFFSET] = sitetype;
-// if using different routines for different types of get hw address requests, may not need to pass these
-// values as arguments; can be hard-coded in routine
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_ADDR_INFO, imsg2, 0, responseSize );
 }
 
 /* Name this PICMG? */
@@ -1258,25 +1255,15 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  *            non-zero for error
  */
 int
-ipmiMsgGetAddressInfoIpmc(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs)
+ipmiMsgGetAddressInfoIpmc(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_PICMG_PROP_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_ADDR_INFO;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, GET_PICMG_PROP_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_ADDR_INFO_IPMC, imsg2 );
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_ADDR_INFO_IPMC, imsg2, 0, responseSize );
 }
 
 /* Get PICMG properties
@@ -1286,25 +1273,15 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  *            non-zero for error
  */
 int
-ipmiMsgGetPicmgProp(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs)
+ipmiMsgGetPicmgProp(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_PICMG_PROP_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_PICMG_PROP;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
 
-	memcpy( imsg2, GET_PICMG_PROP_MSG, imsg2Size );
-	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
+	ipmiMsgCmdInit( IPMI_CMD_GET_PICMG_PROP, imsg2 );
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
+	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
 
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_PICMG_PROP, imsg2, 0, responseSize );
 }
 
 /* Get power level - PICMG command
@@ -1314,27 +1291,17 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  *            non-zero for error
  */
 int
-ipmiMsgGetPowerLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, uint8_t parm )
+ipmiMsgGetPowerLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, uint8_t parm )
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_POWER_LEVEL_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_POWER_LEVEL;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_POWER_LEVEL, imsg2 );
 
-	memcpy( imsg2, GET_POWER_LEVEL_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
 	imsg2[PICMG_RPLY_IMSG2_GET_POWER_LEVEL_TYPE_OFFSET] = parm;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_POWER_LEVEL, imsg2, 0, responseSize );
 }
 
 /* Get fan level - PICMG command
@@ -1345,26 +1312,16 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  */
 
 int
-ipmiMsgGetFanLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId)
+ipmiMsgGetFanLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_FAN_LEVEL_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_FAN_LEVEL;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_FAN_LEVEL, imsg2 );
 
-	memcpy( imsg2, GET_FAN_LEVEL_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_FAN_LEVEL, imsg2, 0, responseSize );
 }
 
 /* Set fan level - PICMG command
@@ -1375,27 +1332,17 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  */
 
 int
-ipmiMsgSetFanLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, uint8_t level)
+ipmiMsgSetFanLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, uint8_t level)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_FAN_LEVEL_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_FAN_LEVEL;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_SET_FAN_LEVEL, imsg2 );
 
-	memcpy( imsg2, GET_FAN_LEVEL_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
 	imsg2[IPMI_MSG2_SET_FAN_LEVEL_OFFSET] = level;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_SET_FAN_LEVEL, imsg2, 0, responseSize );
 }
 
 /* Set FRU Activation - PICMG command
@@ -1406,28 +1353,17 @@ uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
  */
 
 int
-ipmiMsgSetFruAct(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, int parm)
+ipmiMsgSetFruAct(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, int parm)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( SET_FRU_ACT_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_SET_FRU_ACT;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_SET_FRU_ACT, imsg2 );
 
-	memcpy( imsg2, GET_FAN_LEVEL_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_CMD_OFFSET] = parm;
 
-printf("*************ipmi set fru act parm %i\n", parm);
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_SET_FRU_ACT, imsg2, 0, responseSize );
 }
 
 /* Get PICMG properties
@@ -1437,26 +1373,16 @@ printf("*************ipmi set fru act parm %i\n", parm);
  *            non-zero for error
  */
 int
-ipmiMsgGetFanProp(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId)
+ipmiMsgGetFanProp(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId)
 {
-uint8_t  message[MSG_MAX_LENGTH] = { 0 };
-uint8_t  imsg2Size = sizeof( GET_FAN_PROP_MSG );
-uint8_t  imsg2[imsg2Size];
-size_t   messageSize;
-uint8_t  cmd   = IPMI_MSG_CMD_GET_FAN_PROP;
-uint8_t  netfn = IPMI_MSG_NETFN_PICMG;
+uint8_t  imsg2[MSG_MAX_LENGTH];
+
+	ipmiMsgCmdInit( IPMI_CMD_GET_FAN_PROP, imsg2 );
 
-	memcpy( imsg2, GET_FAN_PROP_MSG, imsg2Size );
 	imsg2[IPMI_MSG2_RQADDR_OFFSET] = IPMI_MSG_ADDR_SW;
-	imsg2[IPMI_MSG2_CMD_OFFSET]    = cmd;
 	imsg2[IPMI_MSG2_SET_FRU_ACT_FRU_OFFSET] = fruId;
 
-	if ( bridged ) // may need to distinguish between once and twice-bridged messages
-		ipmiBuildSendMsg( sess, message, &messageSize, cmd, netfn, rsAddr, rqAddr, imsg2, imsg2Size, 0 );
-	else
-		messageSize = ipmiMsgBuild( sess, message, cmd, netfn, imsg2, imsg2Size, 0, 0, 0, 0, 0, 0 );
-
-	return sess->wrf( device, sess, message, messageSize, data, responseSize, cmd, netfn, roffs, 0 );
+	return ipmiMsgCmd( device, sess, data, route, IPMI_CMD_GET_FAN_PROP, imsg2, 0, responseSize );
 }
 	
 
@@ -1480,3 +1406,58 @@ uint8_t  b1msg1[b1msg1Size];
                                                                  
 	*messageSize = ipmiMsgBuild( sess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, msg2, msg2Size, 0, 0, 0 );
 }
+
+/*
+ * Build message for target described by route: sent directly to the BMC,
+ * embedded in a Send Message request, or (NAT) embedded in a Send Message
+ * to the carrier manager that embeds it in a second Send Message on IPMB-L.
+ *
+ *   RETURNS: size of message
+ *
+ *   Arguments:
+ *                sess       - Pointer to IPMI session data structure
+ *                message    - Pointer to message array
+ *                cmd        - Command code of request
+ *                netfn      - Network function of request
+ *                route      - Route to target (see ipmiDef.h)
+ *                msg2       - Pointer to IPMI message 2 of request
+ *                msg2Size   - Size of IPMI message 2 of request
+ *                lun        - Target LUN of bridged request
+ */
+int
+ipmiMsgBuildRouted(IpmiSess sess, uint8_t *message, uint8_t cmd, uint8_t netfn, IpmiRoute route, uint8_t *msg2, size_t msg2Size, uint8_t lun)
+{
+size_t   imsg2Size   = sizeof( SEND_MSG_MSG );
+size_t   b1msg1Size  = sizeof( IPMI_MSG1 );
+size_t   b1msg2Size  = sizeof( SEND_MSG_MSG );
+size_t   b2msg1Size  = sizeof( IPMI_MSG1 );
+uint8_t  imsg2[imsg2Size];
+uint8_t  b1msg1[b1msg1Size];
+uint8_t  b1msg2[b1msg2Size];
+uint8_t  b2msg1[b2msg1Size];
+
+	if ( route->bridged == IPMI_ROUTE_DIRECT )
+		return ipmiMsgBuild( sess, message, cmd, netfn, msg2, msg2Size, 0, 0, 0, 0, 0, 0 );
+
+	memcpy( imsg2,  SEND_MSG_MSG, imsg2Size  );
+	memcpy( b1msg1, IPMI_MSG1,    b1msg1Size );
+
+	imsg2[IPMI_MSG2_CHAN_OFFSET]    = route->sendChan;
+	b1msg1[IPMI_MSG1_RSADDR_OFFSET] = route->rsAddr;
+
+	if ( route->bridged == IPMI_ROUTE_BRIDGED ) {
+		b1msg1[IPMI_MSG1_NETFNLUN_OFFSET] = lun | (netfn << 2);
+		msg2[IPMI_MSG2_RQADDR_OFFSET]     = route->rqAddr;
+		return ipmiMsgBuild( sess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, msg2, msg2Size, 0, 0, 0 );
+	}
+
+	memcpy( b1msg2, SEND_MSG_MSG, b1msg2Size );
+	memcpy( b2msg1, IPMI_MSG1,    b2msg1Size );
+
+	b1msg2[IPMI_MSG2_RQADDR_OFFSET]   = route->rqAddr;
+	b1msg2[IPMI_MSG2_CHAN_OFFSET]     = IPMI_MSG_CHAN_IPMBL + IPMI_MSG_TRACKING;
+	b2msg1[IPMI_MSG1_NETFNLUN_OFFSET] = lun | (netfn << 2);
+	b2msg1[IPMI_MSG1_RSADDR_OFFSET]   = route->addr;
+
+	return ipmiMsgBuild( sess, message, cmd, IPMI_MSG_NETFN_APP_REQUEST, imsg2, imsg2Size, b1msg1, b1msg2, b1msg2Size, b2msg1, msg2, msg2Size );
+}
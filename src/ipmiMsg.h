@@ -94,19 +94,75 @@ void  incr4Uint8Array(uint8_t *data, int incr);
  *   IPMI Message Part 2 Checksum - 2's complement checksum (1 byte)
  */
 
+/*
+ * Command descriptors
+ *
+ * One entry per in-session request, indexed by IPMI_CMD_xxx (see ipmiCmdTable in ipmiMsg.c).
+ * Request template is IPMI message 2 (see templates in ipmiDef.c, picmgDef.c).
+ * Reply length is that of the reply payload, starting with the completion code.
+ * For variable-length replies (IPMI_CMD_RPLY_VAR) it is the fixed part; the
+ * number of data bytes requested is added by the caller.
+ */
+#define IPMI_CMD_RPLY_VAR  (1<<0) /* Reply length depends on request */
+
+typedef struct IpmiCmdRec_ {
+	uint8_t       netfn;         /* Network function */
+	uint8_t       cmd;           /* Command code */
+	uint8_t      *msg;           /* Request template */
+	uint8_t       msgSize;       /* Size of request template */
+	uint8_t       rplyLength;    /* Expected reply payload length */
+	uint8_t       codeOffs;      /* Offset of completion code in reply payload */
+	uint8_t       flags;         /* IPMI_CMD_RPLY_xxx */
+} IpmiCmdRec;
+
+#define IPMI_CMD_CHAS_CTRL             0
+#define IPMI_CMD_GET_CHAS_STATUS       1
+#define IPMI_CMD_GET_FRU_INFO          2
+#define IPMI_CMD_READ_FRU_DATA         3
+#define IPMI_CMD_GET_SDRREP_INFO       4
+#define IPMI_CMD_RESERVE_SDRREP        5
+#define IPMI_CMD_GET_SDR               6
+#define IPMI_CMD_GET_DEV_SDR_INFO      7
+#define IPMI_CMD_RESERVE_DEV_SDRREP    8
+#define IPMI_CMD_GET_DEV_SDR           9
+#define IPMI_CMD_GET_SEL_INFO          10
+#define IPMI_CMD_RESERVE_SEL           11
+#define IPMI_CMD_GET_SEL_ENTRY         12
+#define IPMI_CMD_SENSOR_READ           13
+#define IPMI_CMD_GET_SENSOR_THRESH     14
+#define IPMI_CMD_GET_DEVICE_ID         15
+#define IPMI_CMD_GET_ADDR_INFO         16
+#define IPMI_CMD_GET_ADDR_INFO_IPMC    17 /* Get Address Info without FRU/key: info about the responding controller */
+#define IPMI_CMD_GET_PICMG_PROP        18
+#define IPMI_CMD_GET_POWER_LEVEL       19
+#define IPMI_CMD_GET_FAN_PROP          20
+#define IPMI_CMD_GET_FAN_LEVEL         21
+#define IPMI_CMD_SET_FAN_LEVEL         22
+#define IPMI_CMD_SET_FRU_ACT           23
+#define IPMI_CMD_GET_FRU_POLICY        24
+#define IPMI_CMD_COUNT                 25
+
+extern const IpmiCmdRec ipmiCmdTable[IPMI_CMD_COUNT];
+
 /* IMPORTANT: For all routines below, caller must perform locking */
 
+size_t ipmiMsgCmdInit(int id, uint8_t *imsg2);
+
+int ipmiMsgCmd(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, int id, uint8_t *imsg2, uint8_t lun, size_t *responseSize);
+
 void ipmiBuildSendMsg(IpmiSess sess, uint8_t *message, size_t *messageSize, uint8_t cmd, uint8_t netfn, uint8_t rsAddr, uint8_t rqAddr, uint8_t *msg2, size_t msg2Size, uint8_t lun);
 
+int ipmiMsgBuildRouted(IpmiSess sess, uint8_t *message, uint8_t cmd, uint8_t netfn, IpmiRoute route, uint8_t *msg2, size_t msg2Size, uint8_t lun);
+
 void ipmiCompletionCode(const char *name, uint8_t code, uint8_t cmd, uint8_t netfn);
 
 int ipmiMsgBuild(IpmiSess sess, uint8_t *message, uint8_t cmd, uint8_t imsg1netfn, uint8_t *imsg2, size_t imsg2Size, uint8_t *b1msg1, uint8_t *b1msg2, size_t b1msg2Size, uint8_t *b2msg1, uint8_t *b2msg2, size_t b2msg2Size);
 
 int ipmiMsgWriteRead(const char *name, uint8_t *message, size_t messageSize, uint8_t *response, size_t *responseSize, double timeout, size_t *responseLen);
 
-int ipmiMsgBroadcastGetDeviceId(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int offs);
+int ipmiMsgBroadcastGetDeviceId(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
-int ipmiMsgGetDeviceId(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int offs);
+int ipmiMsgGetDeviceId(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
 int ipmiMsgGetChanAuth(void *device, IpmiSess sess, uint8_t *data, size_t *responseSize, size_t roffs);
 
@@ -120,41 +176,47 @@ int ipmiMsgCloseSess(void *device, IpmiSess sess, uint8_t *data, size_t *respons
 
 int ipmiMsgColdReset(void *device, IpmiSess sess, uint8_t *data);
 
-int ipmiMsgChassisControl(void *device, IpmiSess sess,  uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t parm, size_t *responseSize, int offs);
+int ipmiMsgChassisControl(void *device, IpmiSess sess,  uint8_t *data, IpmiRoute route, uint8_t parm, size_t *responseSize);
+
+int ipmiMsgGetChassisStatus(void *device, IpmiSess sess,  uint8_t *data, IpmiRoute route, size_t *responseSize);
+
+int ipmiMsgGetFruInvInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t id, size_t *responseSize);
+
+int ipmiMsgReadFru(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t id, uint8_t *readOffset, uint8_t readSize, size_t *responseSize);
 
-int ipmiMsgGetChassisStatus(void *device, IpmiSess sess,  uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs);
+int ipmiMsgGetSdrRepInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t parm);
 
-int ipmiMsgGetFruInvInfo(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t id, size_t *responseSize, int offs);
+int ipmiMsgReserveSdrRep(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t parm);
 
-int ipmiMsgReadFru(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t id, uint8_t *readOffset, uint8_t readSize, size_t *responseSize, int offs);
+int ipmiMsgGetSdr(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, size_t *responseSize, uint8_t parm);
 
-int ipmiMsgGetSdrRepInfo(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int offs, uint8_t parm);
+int ipmiMsgGetSelInfo(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
-int ipmiMsgReserveSdrRep(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int offs, uint8_t parm);
+int ipmiMsgReserveSel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
-int ipmiMsgGetSdr(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr,  uint8_t *id, uint8_t *res, uint8_t offset, uint8_t readSize, size_t *responseSize, int offs, uint8_t parm);
+int ipmiMsgGetSelEntry(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t *id, uint8_t *res, size_t *responseSize);
 				
-int ipmiMsgReadSensor(void *device, IpmiSess sess, uint8_t *data, uint8_t bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t sens, uint8_t lun, size_t *responseSize, int offs);
+int ipmiMsgReadSensor(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t sens, uint8_t lun, size_t *responseSize);
 
-int ipmiMsgGetSensorThresholds(void *device, IpmiSess sess, uint8_t *data, uint8_t bridged, uint8_t rsAddr, uint8_t rqAddr, uint8_t sens, uint8_t lun, size_t *responseSize, int offs);
+int ipmiMsgGetSensorThresholds(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, uint8_t sens, uint8_t lun, size_t *responseSize);
 
-int ipmiMsgGetAddressInfoHwAddr(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fru, uint8_t keytpe, uint8_t key, uint8_t sitetype);
+int ipmiMsgGetAddressInfoHwAddr(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fru, uint8_t keytpe, uint8_t key, uint8_t sitetype);
 
-int ipmiMsgGetAddressInfoIpmb0(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fru, uint8_t key);
+int ipmiMsgGetAddressInfoIpmb0(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fru, uint8_t key);
 
-int ipmiMsgGetAddressInfoIpmc(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs);
+int ipmiMsgGetAddressInfoIpmc(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
-int ipmiMsgGetFanProp(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId);
+int ipmiMsgGetFanProp(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId);
 
-int ipmiMsgGetPicmgProp(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs);
+int ipmiMsgGetPicmgProp(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize);
 
-int ipmiMsgGetPowerLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, uint8_t parm);
+int ipmiMsgGetPowerLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, uint8_t parm);
 
-int ipmiMsgGetFanLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId);
+int ipmiMsgGetFanLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId);
 
-int ipmiMsgSetFanLevel(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, uint8_t level);
+int ipmiMsgSetFanLevel(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, uint8_t level);
 
-int ipmiMsgSetFruAct(void *device, IpmiSess sess, uint8_t *data, int bridged, uint8_t rsAddr, uint8_t rqAddr, size_t *responseSize, int roffs, uint8_t fruId, int parm);
+int ipmiMsgSetFruAct(void *device, IpmiSess sess, uint8_t *data, IpmiRoute route, size_t *responseSize, uint8_t fruId, int parm);
 
 #ifdef __cplusplus
 };
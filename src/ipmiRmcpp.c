@@ -0,0 +1,632 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* HMAC_CTX is deprecated in OpenSSL 3 but is the fastest way to reuse a key */
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+
+#include <ipmiMsg.h>
+#include <ipmiDef.h>
+#include <ipmiRmcpp.h>
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static HMAC_CTX *
+HMAC_CTX_new(void)
+{
+HMAC_CTX *ctx = calloc( 1, sizeof(*ctx) );
+
+	if ( ctx )
+		HMAC_CTX_init( ctx );
+	return ctx;
+}
+
+static void
+HMAC_CTX_free(HMAC_CTX *ctx)
+{
+	if ( ctx ) {
+		HMAC_CTX_cleanup( ctx );
+		free( ctx );
+	}
+}
+#endif
+
+typedef struct IpmiRmcppRec_ {
+	int             active;       /* 1 once RAKP 4 has been verified */
+	int             suite;
+	const EVP_MD   *md;           /* RAKP and integrity digest */
+	size_t          mdLength;     /* Digest length */
+	size_t          authLength;   /* AuthCode length in packets; 0 if no integrity */
+	int             conf;         /* 1 if payloads are encrypted (AES-CBC-128) */
+	uint8_t         idConsole[4]; /* Our session ID (SIDm); BMC uses it in replies */
+	uint8_t         idBmc[4];     /* BMC session ID (SIDc); we use it in requests */
+	HMAC_CTX       *integ;        /* Keyed with K1 */
+	EVP_CIPHER_CTX *enc;          /* Keyed with K2 */
+	EVP_CIPHER_CTX *dec;          /* Keyed with K2 */
+} IpmiRmcppRec;
+
+int
+ipmiRmcppSuiteValid(int suite)
+{
+	switch ( suite ) {
+		case IPMI_RMCPP_SUITE_1:
+		case IPMI_RMCPP_SUITE_2:
+		case IPMI_RMCPP_SUITE_3:
+		case IPMI_RMCPP_SUITE_15:
+		case IPMI_RMCPP_SUITE_16:
+		case IPMI_RMCPP_SUITE_17:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static void
+ipmiRmcppSuiteAlgs(int suite, uint8_t *auth, uint8_t *integ, uint8_t *conf)
+{
+int sha256 = suite >= IPMI_RMCPP_SUITE_15;
+
+	*auth  = sha256 ? IPMI_RMCPP_AUTH_ALG_SHA256 : IPMI_RMCPP_AUTH_ALG_SHA1;
+	*integ = ( suite == IPMI_RMCPP_SUITE_1 || suite == IPMI_RMCPP_SUITE_15 ) ? IPMI_RMCPP_INTEG_ALG_NONE :
+	         sha256 ? IPMI_RMCPP_INTEG_ALG_SHA256 : IPMI_RMCPP_INTEG_ALG_SHA1;
+	*conf  = ( suite == IPMI_RMCPP_SUITE_3 || suite == IPMI_RMCPP_SUITE_17 ) ? IPMI_RMCPP_CONF_ALG_AES : IPMI_RMCPP_CONF_ALG_NONE;
+}
+
+/* Allocate RMCP+ state and crypto contexts for session, once
+ *
+ *   RETURNS: state, NULL if no memory
+ */
+static IpmiRmcpp
+ipmiRmcppGet(IpmiSess sess)
+{
+IpmiRmcpp r;
+
+	if ( sess->rmcpp )
+		return sess->rmcpp;
+
+	if ( !(r = calloc( 1, sizeof(*r) )) )
+		return 0;
+
+	if ( !(r->integ = HMAC_CTX_new()) || !(r->enc = EVP_CIPHER_CTX_new()) || !(r->dec = EVP_CIPHER_CTX_new()) ) {
+		printf("ipmiRmcppGet: failed to allocate crypto contexts\n");
+		HMAC_CTX_free( r->integ );
+		EVP_CIPHER_CTX_free( r->enc );
+		EVP_CIPHER_CTX_free( r->dec );
+		free( r );
+		return 0;
+	}
+
+	sess->rmcpp = r;
+
+	return r;
+}
+
+int
+ipmiRmcppKeys(IpmiSess sess, int suite, const uint8_t *sik, const uint8_t *idConsole, const uint8_t *idBmc)
+{
+IpmiRmcpp    r;
+uint8_t      c[IPMI_RMCPP_KEY_MAX_LENGTH];
+uint8_t      k1[IPMI_RMCPP_KEY_MAX_LENGTH], k2[IPMI_RMCPP_KEY_MAX_LENGTH];
+unsigned int n;
+uint8_t      authAlg, integAlg, confAlg;
+
+	if ( !ipmiRmcppSuiteValid( suite ) || !(r = ipmiRmcppGet( sess )) )
+		return -1;
+
+	ipmiRmcppSuiteAlgs( suite, &authAlg, &integAlg, &confAlg );
+
+	r->active     = 0;
+	r->suite      = suite;
+	r->md         = ( authAlg == IPMI_RMCPP_AUTH_ALG_SHA256 ) ? EVP_sha256() : EVP_sha1();
+	r->mdLength   = EVP_MD_size( r->md );
+	r->authLength = ( integAlg == IPMI_RMCPP_INTEG_ALG_NONE ) ? 0 :
+	                ( integAlg == IPMI_RMCPP_INTEG_ALG_SHA256 ) ? 16 : 12;
+	r->conf       = ( confAlg == IPMI_RMCPP_CONF_ALG_AES );
+	memcpy( r->idConsole, idConsole, sizeof(r->idConsole) );
+	memcpy( r->idBmc, idBmc, sizeof(r->idBmc) );
+
+	/* K1 = HMAC_SIK(0x01 repeated), K2 = HMAC_SIK(0x02 repeated) */
+	memset( c, 0x01, r->mdLength );
+	HMAC( r->md, sik, r->mdLength, c, r->mdLength, k1, &n );
+	memset( c, 0x02, r->mdLength );
+	HMAC( r->md, sik, r->mdLength, c, r->mdLength, k2, &n );
+
+	/* Key contexts once; per packet only the IV changes */
+	if ( r->authLength && !HMAC_Init_ex( r->integ, k1, r->mdLength, r->md, NULL ) )
+		return -1;
+
+	if ( r->conf ) {
+		if ( !EVP_EncryptInit_ex( r->enc, EVP_aes_128_cbc(), NULL, k2, NULL ) ||
+		     !EVP_DecryptInit_ex( r->dec, EVP_aes_128_cbc(), NULL, k2, NULL ) )
+			return -1;
+		/* We pad as the spec requires */
+		EVP_CIPHER_CTX_set_padding( r->enc, 0 );
+		EVP_CIPHER_CTX_set_padding( r->dec, 0 );
+	}
+
+	OPENSSL_cleanse( k1, sizeof(k1) );
+	OPENSSL_cleanse( k2, sizeof(k2) );
+
+	r->active = 1;
+
+	return 0;
+}
+
+void
+ipmiRmcppDown(IpmiSess sess)
+{
+	if ( sess->rmcpp )
+		sess->rmcpp->active = 0;
+}
+
+int
+ipmiRmcppActive(IpmiSess sess)
+{
+	return sess->rmcpp && sess->rmcpp->active;
+}
+
+/* Number of integrity pad bytes so that session header through next header is a multiple of 4 */
+static size_t
+ipmiRmcppIntegPad(size_t payloadLength)
+{
+	return (4 - (IPMI_RMCPP_HEADER_LENGTH + payloadLength + 2) % 4) % 4;
+}
+
+/* Length of payload for IPMI message of length n; includes IV and confidentiality pad */
+static size_t
+ipmiRmcppPayloadLength(IpmiRmcpp r, size_t n)
+{
+	if ( !r->conf )
+		return n;
+
+	/* IV, then data, pad and pad length rounded up to cipher block */
+	return IPMI_RMCPP_AES_BLOCK + ((n + 1 + IPMI_RMCPP_AES_BLOCK - 1) / IPMI_RMCPP_AES_BLOCK) * IPMI_RMCPP_AES_BLOCK;
+}
+
+size_t
+ipmiRmcppPacketSize(IpmiSess sess, size_t messageSize)
+{
+IpmiRmcpp r = sess->rmcpp;
+size_t    n, p;
+
+	if ( !ipmiRmcppActive( sess ) )
+		return messageSize;
+
+	if ( messageSize == 0 || messageSize < RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_LENGTH )
+		return 0;
+
+	n = messageSize - RMCP_MSG_HEADER_LENGTH - IPMI_WRAPPER_LENGTH;
+	p = ipmiRmcppPayloadLength( r, n );
+	n = RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + p;
+
+	if ( r->authLength )
+		n += ipmiRmcppIntegPad( p ) + 2 + r->authLength;
+
+	return n;
+}
+
+/* Compute AuthCode over session header through next header (s, n bytes)
+ *
+ *   RETURNS: 0 on success, non-zero on error
+ */
+static int
+ipmiRmcppAuthCode(IpmiRmcpp r, const uint8_t *s, size_t n, uint8_t *authCode)
+{
+uint8_t      md[EVP_MAX_MD_SIZE];
+unsigned int mdLength;
+
+	if ( !HMAC_Init_ex( r->integ, NULL, 0, NULL, NULL ) || !HMAC_Update( r->integ, s, n ) ||
+	     !HMAC_Final( r->integ, md, &mdLength ) )
+		return -1;
+
+	memcpy( authCode, md, r->authLength );
+	return 0;
+}
+
+size_t
+ipmiRmcppWrap(IpmiSess sess, const uint8_t *message, size_t messageSize, uint8_t *packet)
+{
+IpmiRmcpp      r = sess->rmcpp;
+const uint8_t *wrapper = message + RMCP_MSG_HEADER_LENGTH;
+const uint8_t *imsg    = wrapper + IPMI_WRAPPER_LENGTH;
+uint8_t       *s       = packet + RMCP_MSG_HEADER_LENGTH;
+uint8_t       *payload = s + IPMI_RMCPP_HEADER_LENGTH;
+uint8_t        block[MSG_MAX_LENGTH + IPMI_RMCPP_AES_BLOCK];
+size_t         n, p, pad, i;
+int            outl;
+
+	if ( messageSize < RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_LENGTH ||
+	     wrapper[IPMI_WRAPPER_AUTH_TYPE_OFFSET] != IPMI_MSG_AUTH_TYPE_NONE )
+		return 0;
+
+	n = wrapper[IPMI_WRAPPER_NBYTES_OFFSET];
+	if ( n > messageSize - RMCP_MSG_HEADER_LENGTH - IPMI_WRAPPER_LENGTH || n > MSG_MAX_LENGTH )
+		return 0;
+
+	p = ipmiRmcppPayloadLength( r, n );
+
+	memcpy( packet, message, RMCP_MSG_HEADER_LENGTH );
+
+	s[IPMI_WRAPPER_AUTH_TYPE_OFFSET]  = IPMI_RMCPP_AUTH_TYPE;
+	s[IPMI_RMCPP_PAYLOAD_TYPE_OFFSET] = IPMI_RMCPP_PAYLOAD_IPMI
+	                                    | ( r->conf ? IPMI_RMCPP_PAYLOAD_ENCRYPTED : 0 )
+	                                    | ( r->authLength ? IPMI_RMCPP_PAYLOAD_AUTHENTICATED : 0 );
+	memcpy( s + IPMI_RMCPP_ID_OFFSET,  wrapper + IPMI_WRAPPER_ID_OFFSET,  IPMI_WRAPPER_ID_LENGTH );
+	memcpy( s + IPMI_RMCPP_SEQ_OFFSET, wrapper + IPMI_WRAPPER_SEQ_OFFSET, IPMI_WRAPPER_SEQ_LENGTH );
+	s[IPMI_RMCPP_LENGTH_OFFSET]     = p & 0xFF;
+	s[IPMI_RMCPP_LENGTH_OFFSET + 1] = p >> 8;
+
+	if ( r->conf ) {
+		/* Confidentiality pad is 1, 2, 3..., followed by pad length */
+		memcpy( block, imsg, n );
+		pad = p - IPMI_RMCPP_AES_BLOCK - n - 1;
+		for ( i = 0; i < pad; i++ )
+			block[n + i] = i + 1;
+		block[n + pad] = pad;
+
+		if ( RAND_bytes( payload, IPMI_RMCPP_AES_BLOCK ) != 1 ||
+		     !EVP_EncryptInit_ex( r->enc, NULL, NULL, NULL, payload ) ||
+		     !EVP_EncryptUpdate( r->enc, payload + IPMI_RMCPP_AES_BLOCK, &outl, block, p - IPMI_RMCPP_AES_BLOCK ) )
+			return 0;
+	}
+	else
+		memcpy( payload, imsg, n );
+
+	n = IPMI_RMCPP_HEADER_LENGTH + p;
+
+	if ( r->authLength ) {
+		pad = ipmiRmcppIntegPad( p );
+		memset( s + n, 0xFF, pad );
+		n += pad;
+		s[n++] = pad;
+		s[n++] = IPMI_RMCPP_NEXT_HEADER;
+		if ( ipmiRmcppAuthCode( r, s, n, s + n ) )
+			return 0;
+		n += r->authLength;
+	}
+
+	return RMCP_MSG_HEADER_LENGTH + n;
+}
+
+int
+ipmiRmcppUnwrap(IpmiSess sess, const uint8_t *packet, size_t packetSize, uint8_t *message, size_t *messageSize)
+{
+IpmiRmcpp      r = sess->rmcpp;
+const uint8_t *s = packet + RMCP_MSG_HEADER_LENGTH;
+const uint8_t *payload = s + IPMI_RMCPP_HEADER_LENGTH;
+uint8_t       *wrapper = message + RMCP_MSG_HEADER_LENGTH;
+uint8_t       *imsg    = wrapper + IPMI_WRAPPER_LENGTH;
+uint8_t        authCode[IPMI_RMCPP_KEY_MAX_LENGTH];
+uint8_t        block[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX];
+uint8_t        ptype;
+size_t         p, n, trailer;
+int            outl;
+
+	if ( packetSize < RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH ||
+	     s[IPMI_WRAPPER_AUTH_TYPE_OFFSET] != IPMI_RMCPP_AUTH_TYPE )
+		return -1;
+
+	ptype = s[IPMI_RMCPP_PAYLOAD_TYPE_OFFSET];
+
+	if ( IPMI_RMCPP_PAYLOAD_TYPE( ptype ) != IPMI_RMCPP_PAYLOAD_IPMI ||
+	     memcmp( s + IPMI_RMCPP_ID_OFFSET, r->idConsole, sizeof(r->idConsole) ) )
+		return -1;
+
+	/* Refuse downgrade: BMC must protect replies as negotiated */
+	if ( !(ptype & IPMI_RMCPP_PAYLOAD_ENCRYPTED) != !r->conf || !(ptype & IPMI_RMCPP_PAYLOAD_AUTHENTICATED) != !r->authLength )
+		return -1;
+
+	p = s[IPMI_RMCPP_LENGTH_OFFSET] | (s[IPMI_RMCPP_LENGTH_OFFSET + 1] << 8);
+	trailer = r->authLength ? ipmiRmcppIntegPad( p ) + 2 + r->authLength : 0;
+
+	if ( packetSize < RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + p + trailer )
+		return -1;
+
+	if ( r->authLength ) {
+		n = IPMI_RMCPP_HEADER_LENGTH + p + trailer - r->authLength;
+		if ( ipmiRmcppAuthCode( r, s, n, authCode ) || CRYPTO_memcmp( authCode, s + n, r->authLength ) )
+			return -1;
+	}
+
+	if ( r->conf ) {
+		if ( p < 2*IPMI_RMCPP_AES_BLOCK || (p % IPMI_RMCPP_AES_BLOCK) || p - IPMI_RMCPP_AES_BLOCK > sizeof(block) ||
+		     !EVP_DecryptInit_ex( r->dec, NULL, NULL, NULL, payload ) ||
+		     !EVP_DecryptUpdate( r->dec, block, &outl, payload + IPMI_RMCPP_AES_BLOCK, p - IPMI_RMCPP_AES_BLOCK ) )
+			return -1;
+		n = outl;
+		/* Strip pad and pad length */
+		if ( block[n - 1] >= n )
+			return -1;
+		n -= block[n - 1] + 1;
+		payload = block;
+	}
+	else
+		n = p;
+
+	/* Converted reply goes to a MSG_MAX_LENGTH buffer */
+	if ( RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_LENGTH + n > MSG_MAX_LENGTH )
+		return -1;
+
+	memcpy( imsg, payload, n );
+
+	memcpy( message, packet, RMCP_MSG_HEADER_LENGTH );
+	wrapper[IPMI_WRAPPER_AUTH_TYPE_OFFSET] = IPMI_MSG_AUTH_TYPE_NONE;
+	memcpy( wrapper + IPMI_WRAPPER_SEQ_OFFSET, s + IPMI_RMCPP_SEQ_OFFSET, IPMI_WRAPPER_SEQ_LENGTH );
+	memcpy( wrapper + IPMI_WRAPPER_ID_OFFSET,  s + IPMI_RMCPP_ID_OFFSET,  IPMI_WRAPPER_ID_LENGTH );
+	wrapper[IPMI_WRAPPER_NBYTES_OFFSET] = n;
+
+	*messageSize = RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_LENGTH + n;
+
+	return 0;
+}
+
+int
+ipmiRmcppWriteRead(IpmiSess sess, const char *name, uint8_t *message, size_t messageSize, uint8_t *response, size_t *responseSize, double timeout, size_t *responseLen)
+{
+uint8_t packet[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX];
+uint8_t reply[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX];
+size_t  packetSize, replySize, replyLen = 0;
+int     status;
+
+	if ( !(packetSize = ipmiRmcppWrap( sess, message, messageSize, packet )) ) {
+		printf("%s ipmiRmcppWriteRead: cannot convert message\n", name);
+		*responseLen = 0;
+		return -1;
+	}
+
+	if ( *responseSize == 0 || *responseSize > MSG_MAX_LENGTH )
+		*responseSize = MSG_MAX_LENGTH;
+
+	/* Unknown reply length: read as much as the largest reply could take */
+	replySize = ipmiRmcppPacketSize( sess, *responseSize );
+	if ( replySize > sizeof(reply) )
+		replySize = sizeof(reply);
+
+	status = ipmiMsgWriteRead( name, packet, packetSize, reply, &replySize, timeout, &replyLen );
+
+	memset( response, 0, *responseSize );
+	*responseLen = 0;
+
+	if ( replyLen && ipmiRmcppUnwrap( sess, reply, replyLen, response, responseLen ) ) {
+		printf("%s RMCP+ reply failed integrity check or could not be decrypted\n", name);
+		*responseLen = 0;
+	}
+
+	return status;
+}
+
+/* Build RMCP+ packet outside a session (session ID and sequence 0)
+ *
+ *   RETURNS: packet size
+ */
+static size_t
+ipmiRmcppBuildOutSess(uint8_t *packet, uint8_t ptype, const uint8_t *payload, size_t n)
+{
+uint8_t *s = packet + RMCP_MSG_HEADER_LENGTH;
+
+	memcpy( packet, RMCP_HEADER, RMCP_MSG_HEADER_LENGTH );
+	memset( s, 0, IPMI_RMCPP_HEADER_LENGTH );
+	s[IPMI_WRAPPER_AUTH_TYPE_OFFSET]  = IPMI_RMCPP_AUTH_TYPE;
+	s[IPMI_RMCPP_PAYLOAD_TYPE_OFFSET] = ptype;
+	s[IPMI_RMCPP_LENGTH_OFFSET]       = n & 0xFF;
+	s[IPMI_RMCPP_LENGTH_OFFSET + 1]   = n >> 8;
+	memcpy( s + IPMI_RMCPP_HEADER_LENGTH, payload, n );
+
+	return RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + n;
+}
+
+/* RMCP+ and RAKP message status codes (IPMI v2.0 table 13-15) */
+static const char *
+ipmiRmcppStatusStr(uint8_t code)
+{
+	switch ( code ) {
+		case 0x01: return "insufficient resources to create session";
+		case 0x02: return "invalid session ID";
+		case 0x03: return "invalid payload type";
+		case 0x04: return "invalid authentication algorithm";
+		case 0x05: return "invalid integrity algorithm";
+		case 0x06: return "no matching authentication payload";
+		case 0x07: return "no matching integrity payload";
+		case 0x08: return "inactive session ID";
+		case 0x09: return "invalid role";
+		case 0x0A: return "unauthorized role or privilege level requested";
+		case 0x0B: return "insufficient resources to create session at requested role";
+		case 0x0C: return "invalid name length";
+		case 0x0D: return "unauthorized name";
+		case 0x0E: return "unauthorized GUID";
+		case 0x0F: return "invalid integrity check value";
+		case 0x10: return "invalid confidentiality algorithm";
+		case 0x11: return "no cipher suite match with proposed security algorithms";
+		case 0x12: return "illegal or unrecognized parameter";
+		default:   return "unknown status";
+	}
+}
+
+/* Report failed handshake step; status is an RMCP+ status code if the BMC replied */
+static void
+ipmiRmcppFailed(const char *step, const uint8_t *response, size_t responseSize, int status)
+{
+	if ( responseSize > IPMI_RMCPP_RPLY_STATUS_OFFSET && response[IPMI_RMCPP_RPLY_STATUS_OFFSET] == status )
+		printf("ipmiRmcppOpen: %s failed: %s\n", step, ipmiRmcppStatusStr( status ));
+	else
+		printf("ipmiRmcppOpen: %s failed, status %i\n", step, status);
+}
+
+/* Payload offsets (from start of payload) */
+#define RMCPP_OPEN_RPLY_ID_BMC_OFFSET   8
+#define RMCPP_OPEN_RPLY_LENGTH          36
+#define RMCPP_RAKP2_RANDOM_OFFSET       8
+#define RMCPP_RAKP2_GUID_OFFSET         24
+#define RMCPP_RAKP2_AUTH_OFFSET         40
+#define RMCPP_RAKP4_ICV_OFFSET          8
+#define RMCPP_ROLE_NAME_ONLY            0x10  /* RAKP 1 role: name-only lookup */
+
+int
+ipmiRmcppOpen(void *device, IpmiSess sess, int suite, const uint8_t *user, size_t userLength, const uint8_t *key, size_t keyLength, uint8_t priv)
+{
+uint8_t  packet[MSG_MAX_LENGTH];
+uint8_t  response[MSG_MAX_LENGTH];
+uint8_t  payload[64];
+uint8_t  buf[128];
+uint8_t  md[EVP_MAX_MD_SIZE];
+uint8_t  sik[EVP_MAX_MD_SIZE];
+uint8_t  idConsole[4], idBmc[4], rm[IPMI_RMCPP_RANDOM_LENGTH], rc[IPMI_RMCPP_RANDOM_LENGTH], guid[IPMI_RMCPP_GUID_LENGTH];
+uint8_t  authAlg, integAlg, confAlg, role;
+const EVP_MD *evp;
+const uint8_t *rply = response + RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH;
+size_t   n, packetSize, responseSize, mdLength, icvLength;
+unsigned int mdl;
+int      status;
+
+	if ( !ipmiRmcppSuiteValid( suite ) || userLength > 16 || keyLength > 20 )
+		return -1;
+
+	ipmiRmcppDown( sess );
+
+	ipmiRmcppSuiteAlgs( suite, &authAlg, &integAlg, &confAlg );
+	evp       = ( authAlg == IPMI_RMCPP_AUTH_ALG_SHA256 ) ? EVP_sha256() : EVP_sha1();
+	mdLength  = EVP_MD_size( evp );
+	icvLength = ( authAlg == IPMI_RMCPP_AUTH_ALG_SHA256 ) ? 16 : 12;
+	role      = RMCPP_ROLE_NAME_ONLY | priv;
+
+	if ( RAND_bytes( idConsole, sizeof(idConsole) ) != 1 || RAND_bytes( rm, sizeof(rm) ) != 1 )
+		return -1;
+	idConsole[3] |= 0x01; /* Session ID 0 is reserved */
+
+	/* Open Session Request */
+	memset( payload, 0, sizeof(payload) );
+	payload[1]  = priv;
+	memcpy( payload + 4, idConsole, 4 );
+	payload[8]  = 0x00; payload[11] = 8; payload[12] = authAlg;
+	payload[16] = 0x01; payload[19] = 8; payload[20] = integAlg;
+	payload[24] = 0x02; payload[27] = 8; payload[28] = confAlg;
+	packetSize   = ipmiRmcppBuildOutSess( packet, IPMI_RMCPP_PAYLOAD_OPEN_REQ, payload, 32 );
+	responseSize = RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_OPEN_RPLY_LENGTH;
+
+	if ( (status = sess->wrf( device, sess, packet, packetSize, response, &responseSize, IPMI_RMCPP_PAYLOAD_OPEN_REQ, 0, IPMI_RMCPP_RPLY_STATUS_OFFSET, 1 )) ) {
+		ipmiRmcppFailed( "Open Session", response, responseSize, status );
+		return -1;
+	}
+	if ( responseSize < RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_OPEN_RPLY_LENGTH ||
+	     rply[-IPMI_RMCPP_HEADER_LENGTH + IPMI_RMCPP_PAYLOAD_TYPE_OFFSET] != IPMI_RMCPP_PAYLOAD_OPEN_RPLY ||
+	     memcmp( rply + 4, idConsole, 4 ) ) {
+		printf("ipmiRmcppOpen: invalid Open Session Response\n");
+		return -1;
+	}
+	memcpy( idBmc, rply + RMCPP_OPEN_RPLY_ID_BMC_OFFSET, 4 );
+
+	/* RAKP 1 */
+	memset( payload, 0, sizeof(payload) );
+	memcpy( payload + 4, idBmc, 4 );
+	memcpy( payload + 8, rm, sizeof(rm) );
+	payload[24] = role;
+	payload[27] = userLength;
+	memcpy( payload + 28, user, userLength );
+	packetSize   = ipmiRmcppBuildOutSess( packet, IPMI_RMCPP_PAYLOAD_RAKP1, payload, 28 + userLength );
+	responseSize = RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_RAKP2_AUTH_OFFSET + mdLength;
+
+	if ( (status = sess->wrf( device, sess, packet, packetSize, response, &responseSize, IPMI_RMCPP_PAYLOAD_RAKP1, 0, IPMI_RMCPP_RPLY_STATUS_OFFSET, 1 )) ) {
+		ipmiRmcppFailed( "RAKP 2", response, responseSize, status );
+		return -1;
+	}
+	if ( responseSize < RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_RAKP2_AUTH_OFFSET + mdLength ||
+	     rply[-IPMI_RMCPP_HEADER_LENGTH + IPMI_RMCPP_PAYLOAD_TYPE_OFFSET] != IPMI_RMCPP_PAYLOAD_RAKP2 ||
+	     memcmp( rply + 4, idConsole, 4 ) ) {
+		printf("ipmiRmcppOpen: invalid RAKP 2\n");
+		return -1;
+	}
+	memcpy( rc,   rply + RMCPP_RAKP2_RANDOM_OFFSET, sizeof(rc) );
+	memcpy( guid, rply + RMCPP_RAKP2_GUID_OFFSET,   sizeof(guid) );
+
+	/* RAKP 2 AuthCode = HMAC_Kuid(SIDm, SIDc, Rm, Rc, GUIDc, ROLEm, ULENGTHm, UNAMEm) */
+	n = 0;
+	memcpy( buf + n, idConsole, 4 );   n += 4;
+	memcpy( buf + n, idBmc, 4 );       n += 4;
+	memcpy( buf + n, rm, sizeof(rm) ); n += sizeof(rm);
+	memcpy( buf + n, rc, sizeof(rc) ); n += sizeof(rc);
+	memcpy( buf + n, guid, sizeof(guid) ); n += sizeof(guid);
+	buf[n++] = role;
+	buf[n++] = userLength;
+	memcpy( buf + n, user, userLength ); n += userLength;
+	HMAC( evp, key, keyLength, buf, n, md, &mdl );
+
+	if ( CRYPTO_memcmp( md, rply + RMCPP_RAKP2_AUTH_OFFSET, mdLength ) ) {
+		printf("ipmiRmcppOpen: RAKP 2 key exchange code mismatch; check user name and password\n");
+		return -1;
+	}
+
+	/* SIK = HMAC_Kg(Rm, Rc, ROLEm, ULENGTHm, UNAMEm); no BMC key, so Kg = Kuid */
+	n = 0;
+	memcpy( buf + n, rm, sizeof(rm) ); n += sizeof(rm);
+	memcpy( buf + n, rc, sizeof(rc) ); n += sizeof(rc);
+	buf[n++] = role;
+	buf[n++] = userLength;
+	memcpy( buf + n, user, userLength ); n += userLength;
+	HMAC( evp, key, keyLength, buf, n, sik, &mdl );
+
+	/* RAKP 3 AuthCode = HMAC_Kuid(Rc, SIDm, ROLEm, ULENGTHm, UNAMEm) */
+	n = 0;
+	memcpy( buf + n, rc, sizeof(rc) ); n += sizeof(rc);
+	memcpy( buf + n, idConsole, 4 );   n += 4;
+	buf[n++] = role;
+	buf[n++] = userLength;
+	memcpy( buf + n, user, userLength ); n += userLength;
+
+	memset( payload, 0, sizeof(payload) );
+	memcpy( payload + 4, idBmc, 4 );
+	HMAC( evp, key, keyLength, buf, n, payload + 8, &mdl );
+	packetSize   = ipmiRmcppBuildOutSess( packet, IPMI_RMCPP_PAYLOAD_RAKP3, payload, 8 + mdLength );
+	responseSize = RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_RAKP4_ICV_OFFSET + icvLength;
+
+	if ( (status = sess->wrf( device, sess, packet, packetSize, response, &responseSize, IPMI_RMCPP_PAYLOAD_RAKP3, 0, IPMI_RMCPP_RPLY_STATUS_OFFSET, 1 )) ) {
+		ipmiRmcppFailed( "RAKP 4", response, responseSize, status );
+		goto bail;
+	}
+	if ( responseSize < RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + RMCPP_RAKP4_ICV_OFFSET + icvLength ||
+	     rply[-IPMI_RMCPP_HEADER_LENGTH + IPMI_RMCPP_PAYLOAD_TYPE_OFFSET] != IPMI_RMCPP_PAYLOAD_RAKP4 ||
+	     memcmp( rply + 4, idConsole, 4 ) ) {
+		printf("ipmiRmcppOpen: invalid RAKP 4\n");
+		goto bail;
+	}
+
+	/* RAKP 4 integrity check value = HMAC_SIK(Rm, SIDc, GUIDc), truncated */
+	n = 0;
+	memcpy( buf + n, rm, sizeof(rm) ); n += sizeof(rm);
+	memcpy( buf + n, idBmc, 4 );       n += 4;
+	memcpy( buf + n, guid, sizeof(guid) ); n += sizeof(guid);
+	HMAC( evp, sik, mdLength, buf, n, md, &mdl );
+
+	if ( CRYPTO_memcmp( md, rply + RMCPP_RAKP4_ICV_OFFSET, icvLength ) ) {
+		printf("ipmiRmcppOpen: RAKP 4 integrity check value mismatch\n");
+		goto bail;
+	}
+
+	if ( ipmiRmcppKeys( sess, suite, sik, idConsole, idBmc ) )
+		goto bail;
+
+	OPENSSL_cleanse( sik, sizeof(sik) );
+
+	/* In-session messages carry BMC's session ID; our sequence starts at 1 */
+	memcpy( sess->id, idBmc, sizeof(sess->id) );
+	memset( sess->seqSend, 0, sizeof(sess->seqSend) );
+	sess->seqSend[0] = 1;
+
+	return 0;
+
+bail:
+	OPENSSL_cleanse( sik, sizeof(sik) );
+	return -1;
+}
@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#ifndef IPMI_RMCPP_H
+#define IPMI_RMCPP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ipmiDef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * RMCP+ (IPMI v2.0, 'lanplus') sessions
+ *
+ * Session establishment is RMCP+ Open Session followed by RAKP messages 1-4.
+ * Once the session is active, requests are still built in IPMI v1.5 format
+ * with authentication type NONE (ipmiMsgBuild); ipmiRmcppWriteRead converts
+ * each request to an RMCP+ packet just before it is sent and converts the
+ * reply back, so that reply offsets and sequence checks in the driver are
+ * the same for both session types.
+ *
+ * Session keys are derived once per session; HMAC and cipher contexts are
+ * allocated once per IpmiSess and only re-keyed when a new session starts.
+ *
+ * Built only if IPMI_RMCPP=YES (configure/CONFIG_APP); requires OpenSSL libcrypto.
+ * Caller must perform locking (in the driver, the MCH mutex).
+ */
+
+/* Cipher suite IDs (IPMI v2.0 table 22-20): authentication/integrity/confidentiality */
+#define IPMI_RMCPP_SUITE_1         1    /* RAKP-HMAC-SHA1,   none,            none        */
+#define IPMI_RMCPP_SUITE_2         2    /* RAKP-HMAC-SHA1,   HMAC-SHA1-96,    none        */
+#define IPMI_RMCPP_SUITE_3         3    /* RAKP-HMAC-SHA1,   HMAC-SHA1-96,    AES-CBC-128 */
+#define IPMI_RMCPP_SUITE_15        15   /* RAKP-HMAC-SHA256, none,            none        */
+#define IPMI_RMCPP_SUITE_16        16   /* RAKP-HMAC-SHA256, HMAC-SHA256-128, none        */
+#define IPMI_RMCPP_SUITE_17        17   /* RAKP-HMAC-SHA256, HMAC-SHA256-128, AES-CBC-128 */
+#define IPMI_RMCPP_SUITE_DEFAULT   IPMI_RMCPP_SUITE_3
+
+/* Algorithm numbers used in Open Session Request */
+#define IPMI_RMCPP_AUTH_ALG_SHA1     0x01  /* RAKP-HMAC-SHA1 */
+#define IPMI_RMCPP_AUTH_ALG_SHA256   0x03  /* RAKP-HMAC-SHA256 */
+#define IPMI_RMCPP_INTEG_ALG_NONE    0x00
+#define IPMI_RMCPP_INTEG_ALG_SHA1    0x01  /* HMAC-SHA1-96 */
+#define IPMI_RMCPP_INTEG_ALG_SHA256  0x04  /* HMAC-SHA256-128 */
+#define IPMI_RMCPP_CONF_ALG_NONE     0x00
+#define IPMI_RMCPP_CONF_ALG_AES      0x01  /* AES-CBC-128 */
+
+/* RMCP+ session header: {auth type}{payload type}{4-byte session ID}{4-byte session seq}{2-byte payload length} */
+#define IPMI_RMCPP_AUTH_TYPE            0x06  /* Auth type/format: RMCP+ */
+#define IPMI_RMCPP_HEADER_LENGTH        12
+#define IPMI_RMCPP_PAYLOAD_TYPE_OFFSET  1
+#define IPMI_RMCPP_ID_OFFSET            2
+#define IPMI_RMCPP_SEQ_OFFSET           6
+#define IPMI_RMCPP_LENGTH_OFFSET        10
+#define IPMI_RMCPP_PAYLOAD_ENCRYPTED    0x80  /* Payload type bit: payload is encrypted */
+#define IPMI_RMCPP_PAYLOAD_AUTHENTICATED 0x40 /* Payload type bit: packet carries AuthCode */
+#define IPMI_RMCPP_PAYLOAD_TYPE(x)      ((x) & 0x3F)
+#define IPMI_RMCPP_NEXT_HEADER          0x07  /* Session trailer 'next header' */
+
+/* Payload types */
+#define IPMI_RMCPP_PAYLOAD_IPMI         0x00
+#define IPMI_RMCPP_PAYLOAD_OPEN_REQ     0x10
+#define IPMI_RMCPP_PAYLOAD_OPEN_RPLY    0x11
+#define IPMI_RMCPP_PAYLOAD_RAKP1        0x12
+#define IPMI_RMCPP_PAYLOAD_RAKP2        0x13
+#define IPMI_RMCPP_PAYLOAD_RAKP3        0x14
+#define IPMI_RMCPP_PAYLOAD_RAKP4        0x15
+
+/* Offset of status code in Open Session Response and RAKP 2 and 4 replies */
+#define IPMI_RMCPP_RPLY_STATUS_OFFSET   (RMCP_MSG_HEADER_LENGTH + IPMI_RMCPP_HEADER_LENGTH + 1)
+
+#define IPMI_RMCPP_RANDOM_LENGTH        16
+#define IPMI_RMCPP_GUID_LENGTH          16
+#define IPMI_RMCPP_KEY_MAX_LENGTH       32    /* SHA256 digest */
+#define IPMI_RMCPP_AES_BLOCK            16
+
+/* Largest number of bytes RMCP+ adds to an IPMI v1.5 (auth type NONE) packet:
+ * longer session header, IV, confidentiality pad, integrity pad, pad length,
+ * next header and AuthCode
+ */
+#define IPMI_RMCPP_OVERHEAD_MAX         64
+
+typedef struct IpmiRmcppRec_ *IpmiRmcpp;
+
+/* Return 1 if suite is one we support, else 0 */
+int    ipmiRmcppSuiteValid(int suite);
+
+/* Establish RMCP+ session: Open Session, RAKP 1-4. Creates sess->rmcpp on first use.
+ * On success, sess->id holds the BMC's session ID and in-session messages
+ * are converted by ipmiRmcppWriteRead. Messages are sent with sess->wrf.
+ *
+ *   device     - Passed to sess->wrf
+ *   suite      - Cipher suite ID, IPMI_RMCPP_SUITE_xxx
+ *   user       - User name, userLength bytes (at most 16)
+ *   key        - Password (Kuid), keyLength bytes (at most 20)
+ *   priv       - Requested privilege level, IPMI_MSG_PRIV_LEVEL_xxx
+ *
+ *   RETURNS: 0 on success
+ *            non-zero on failure
+ */
+int    ipmiRmcppOpen(void *device, IpmiSess sess, int suite, const uint8_t *user, size_t userLength, const uint8_t *key, size_t keyLength, uint8_t priv);
+
+/* Set session keys without handshake (SIK from RAKP); used by ipmiRmcppOpen and benchmarks */
+int    ipmiRmcppKeys(IpmiSess sess, int suite, const uint8_t *sik, const uint8_t *idConsole, const uint8_t *idBmc);
+
+/* Mark RMCP+ session (if any) inactive; messages are sent unconverted until next ipmiRmcppOpen */
+void   ipmiRmcppDown(IpmiSess sess);
+
+/* Return 1 if sess has an active RMCP+ session, else 0 */
+int    ipmiRmcppActive(IpmiSess sess);
+
+/* Convert IPMI v1.5 packet (auth type NONE) to RMCP+ packet.
+ *   RETURNS: size of RMCP+ packet; 0 on error
+ */
+size_t ipmiRmcppWrap(IpmiSess sess, const uint8_t *message, size_t messageSize, uint8_t *packet);
+
+/* Check integrity of, decrypt and convert RMCP+ packet to IPMI v1.5 format (auth type NONE).
+ *   RETURNS: 0 on success, *messageSize set to size of converted packet
+ *            non-zero if packet is invalid or fails integrity check
+ */
+int    ipmiRmcppUnwrap(IpmiSess sess, const uint8_t *packet, size_t packetSize, uint8_t *message, size_t *messageSize);
+
+/* RMCP+ packet size corresponding to IPMI v1.5 (auth type NONE) packet size; 0 if size is 0 (unknown).
+ * messageSize if there is no active RMCP+ session.
+ */
+size_t ipmiRmcppPacketSize(IpmiSess sess, size_t messageSize);
+
+/* As ipmiMsgWriteRead, for an active RMCP+ session: message and response are
+ * IPMI v1.5 packets, responseSize is the expected v1.5 response size.
+ * If the reply fails the integrity check, *responseLen is 0.
+ *
+ *   RETURNS: asyn status from write/read
+ */
+int    ipmiRmcppWriteRead(IpmiSess sess, const char *name, uint8_t *message, size_t messageSize, uint8_t *response, size_t *responseSize, double timeout, size_t *responseLen);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
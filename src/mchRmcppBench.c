@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <epicsTime.h>
+
+#include <ipmiMsg.h>
+#include <ipmiDef.h>
+#include <ipmiRmcpp.h>
+
+/*
+ * Microbenchmark: host-side cost of one sensor sweep (a Get Sensor Reading
+ * request and its reply per sensor) for an IPMI v1.5 session and for RMCP+
+ * sessions with integrity and confidentiality on and off:
+ *
+ *   v1.5      - build request; reply used as received
+ *   suite 1   - RMCP+ framing only (no integrity, no confidentiality)
+ *   suite 2   - HMAC-SHA1-96 integrity
+ *   suite 3   - HMAC-SHA1-96 integrity, AES-CBC-128 confidentiality
+ *   suite 16  - HMAC-SHA256-128 integrity
+ *   suite 17  - HMAC-SHA256-128 integrity, AES-CBC-128 confidentiality
+ *
+ * For RMCP+, each sensor costs building the request, converting it to an
+ * RMCP+ packet and checking/decrypting the reply, with session keys and
+ * cipher contexts set up once, as in the driver. Network time is not included;
+ * no MCH is needed.
+ *
+ * Usage: mchRmcppBench [sensors per sweep] [sweeps]
+ */
+
+#define BENCH_SENSORS_DEFAULT  400
+#define BENCH_SWEEPS_DEFAULT   500
+
+static const int benchSuites[] = { 0, IPMI_RMCPP_SUITE_1, IPMI_RMCPP_SUITE_2, IPMI_RMCPP_SUITE_3, IPMI_RMCPP_SUITE_16, IPMI_RMCPP_SUITE_17 };
+
+/* Get Sensor Reading reply, as an IPMI v1.5 packet with auth type NONE */
+static size_t
+benchReply(uint8_t *reply, int sensor, const uint8_t *id)
+{
+size_t n = 0;
+
+	memcpy( reply, RMCP_HEADER, RMCP_MSG_HEADER_LENGTH );
+	n += RMCP_MSG_HEADER_LENGTH;
+	memcpy( reply + n, IPMI_WRAPPER, IPMI_WRAPPER_LENGTH );
+	reply[n + IPMI_WRAPPER_SEQ_OFFSET] = 1;
+	memcpy( reply + n + IPMI_WRAPPER_ID_OFFSET, id, IPMI_WRAPPER_ID_LENGTH );
+	reply[n + IPMI_WRAPPER_NBYTES_OFFSET] = IPMI_MSG_HEADER_LENGTH + IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH + FOOTER_LENGTH;
+	n += IPMI_WRAPPER_LENGTH;
+	reply[n++] = IPMI_MSG_ADDR_SW;
+	reply[n++] = (IPMI_MSG_NETFN_SENSOR_EVENT + 1) << 2;
+	reply[n++] = 0;
+	reply[n++] = IPMI_MSG_ADDR_BMC;
+	reply[n++] = 0;
+	reply[n++] = IPMI_MSG_CMD_SENSOR_READ;
+	reply[n++] = 0;              /* Completion code */
+	reply[n++] = sensor & 0xFF;  /* Reading */
+	reply[n++] = 0xC0;
+	reply[n++] = 0;
+	reply[n++] = 0;
+	reply[n++] = 0;              /* Checksum */
+
+	return n;
+}
+
+/* One sweep; RETURNS number of sensors whose reply was accepted */
+static int
+benchSweep(IpmiSess sess, int nsens, uint8_t (*wire)[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX], size_t *wireSize)
+{
+uint8_t message[MSG_MAX_LENGTH], packet[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX], response[MSG_MAX_LENGTH];
+uint8_t imsg2[sizeof( SENS_READ_MSG )];
+size_t  messageSize, responseSize;
+int     i, ok = 0;
+
+	for ( i = 0; i < nsens; i++ ) {
+		memcpy( imsg2, SENS_READ_MSG, sizeof( imsg2 ) );
+		imsg2[IPMI_MSG2_SENSOR_OFFSET] = i & 0xFF;
+		messageSize = ipmiMsgBuild( sess, message, IPMI_MSG_CMD_SENSOR_READ, IPMI_MSG_NETFN_SENSOR_EVENT, imsg2, sizeof( imsg2 ), 0, 0, 0, 0, 0, 0 );
+
+		if ( ipmiRmcppActive( sess ) ) {
+			if ( !ipmiRmcppWrap( sess, message, messageSize, packet ) )
+				continue;
+			if ( ipmiRmcppUnwrap( sess, wire[i], wireSize[i], response, &responseSize ) )
+				continue;
+		}
+		else {
+			memcpy( response, wire[i], wireSize[i] );
+			responseSize = wireSize[i];
+		}
+		ok += ( response[IPMI_RPLY_HEADER_LENGTH] == 0 ) && responseSize;
+	}
+	return ok;
+}
+
+int
+main(int argc, char **argv)
+{
+int             nsens   = ( argc > 1 ) ? atoi( argv[1] ) : BENCH_SENSORS_DEFAULT;
+int             nsweep  = ( argc > 2 ) ? atoi( argv[2] ) : BENCH_SWEEPS_DEFAULT;
+IpmiSessRec     sess;
+uint8_t         sik[IPMI_RMCPP_KEY_MAX_LENGTH];
+uint8_t         idConsole[4] = { 0x11, 0x22, 0x33, 0x44 }, idBmc[4] = { 0x55, 0x66, 0x77, 0x88 };
+uint8_t         reply[MSG_MAX_LENGTH];
+uint8_t       (*wire)[MSG_MAX_LENGTH + IPMI_RMCPP_OVERHEAD_MAX];
+size_t         *wireSize, n;
+epicsTimeStamp  t0, t1;
+double          t, tBase = 0;
+int             i, k, s, ok;
+
+	if ( nsens <= 0 || nsweep <= 0 ) {
+		printf("Usage: %s [sensors per sweep] [sweeps]\n", argv[0]);
+		return 1;
+	}
+
+	wire     = calloc( nsens, sizeof(*wire) );
+	wireSize = calloc( nsens, sizeof(*wireSize) );
+	if ( !wire || !wireSize ) {
+		printf("No memory\n");
+		return 1;
+	}
+
+	for ( i = 0; i < (int)sizeof(sik); i++ )
+		sik[i] = i * 13 + 1;
+
+	memset( &sess, 0, sizeof(sess) );
+	sess.authReq = IPMI_MSG_AUTH_TYPE_NONE;
+
+	printf("Sensor sweep: %i sensors, %i sweeps; host-side message cost only\n", nsens, nsweep);
+
+	for ( s = 0; s < (int)(sizeof(benchSuites)/sizeof(benchSuites[0])); s++ ) {
+
+		if ( benchSuites[s] ) {
+			if ( ipmiRmcppKeys( &sess, benchSuites[s], sik, idConsole, idBmc ) ) {
+				printf("  suite %2i: cannot set up keys\n", benchSuites[s]);
+				continue;
+			}
+			memcpy( sess.id, idBmc, sizeof(sess.id) );
+		}
+		else
+			ipmiRmcppDown( &sess );
+
+		/* Replies as the BMC would send them; RMCP+ uses the same keys in both directions */
+		for ( i = 0; i < nsens; i++ ) {
+			n = benchReply( reply, i, idConsole );
+			if ( ipmiRmcppActive( &sess ) )
+				wireSize[i] = ipmiRmcppWrap( &sess, reply, n, wire[i] );
+			else {
+				memcpy( wire[i], reply, n );
+				wireSize[i] = n;
+			}
+		}
+
+		/* Untimed warm-up */
+		benchSweep( &sess, nsens, wire, wireSize );
+
+		ok = 0;
+		epicsTimeGetCurrent( &t0 );
+		for ( k = 0; k < nsweep; k++ )
+			ok += benchSweep( &sess, nsens, wire, wireSize );
+		epicsTimeGetCurrent( &t1 );
+		t = epicsTimeDiffInSeconds( &t1, &t0 );
+
+		if ( !benchSuites[s] ) {
+			tBase = t;
+			printf("  v1.5:     ");
+		}
+		else
+			printf("  suite %2i: ", benchSuites[s]);
+
+		printf("%8.2f us/sensor, %10.0f sensors/s, request %3i bytes, reply %3i bytes",
+		    1e6*t/((double)nsweep*nsens), t > 0 ? (double)nsweep*nsens/t : 0,
+		    (int)ipmiRmcppPacketSize( &sess, RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_LENGTH + IPMI_MSG1_LENGTH + sizeof( SENS_READ_MSG ) ),
+		    (int)wireSize[0]);
+		if ( benchSuites[s] && tBase > 0 )
+			printf(", %.2fx v1.5", t/tBase);
+		if ( ok != nsweep*nsens )
+			printf(" (%i replies rejected)", nsweep*nsens - ok);
+		printf("\n");
+	}
+
+	free( wire );
+	free( wireSize );
+
+	return 0;
+}
@@ -0,0 +1,1892 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <drvMch.h>
+#include <ipmiDef.h>
+#include <picmgDef.h>
+
+/*
+ * Shelf simulator: answers IPMI v1.5 over RMCP (UDP) on the loopback interface
+ * the way the shelf managers and BMCs supported by ipmiComm do, so the driver
+ * can be exercised and benchmarked without hardware. Each simulated shelf
+ * listens on its own port, starting at the base port.
+ *
+ * Dialects (-t):
+ *
+ *   nat        NAT MicroTCA MCH. Modules (AMCs) are management controllers on IPMB-0
+ *              that provide device SDRs; requests to them are bridged once.
+ *              Cooling unit and power module requests are bridged twice, via the
+ *              carrier manager (0x82) over IPMB-L. Hot-swap sensors belong to the
+ *              carrier manager and are named "HS <FRU ID> <FRU name>".
+ *   vt         Vadatech MicroTCA MCH. Every request after identification is bridged to 
+ *              the carrier manager (0x82), which answers for the whole shelf; the reply
+ *              is the Send Message reply followed by the bridged reply.
+ *   pentair    Pentair (Pigeon Point) ATCA shelf manager. Front boards and fan trays
+ *   artesyn    Artesyn ATCA shelf manager.  are IPM controllers on IPMB-0 that provide device SDRs.
+ *   supermicro Supermicro BMC; no FRU device locator records.
+ *   advantech  Advantech BMC; session sequence numbers do not increase.
+ *
+ * Twice-bridged replies and Send Message replies followed by the bridged reply 
+ * are sent as one datagram, as ipmiComm reads them. Requests bridged to a target 
+ * that does not exist are not answered. RMCP+ (IPMI v2.0) sessions are not simulated.
+ *
+ * Shelf contents are synthetic, or read from a file (-f) with lines:
+ *
+ *   ctrl   <addr> <name>                         management controller; 0x20 is the shelf manager/BMC
+ *   fru    <id> <entity ID> <entity inst> <name> FRU of current controller
+ *   sensor <temp|volt|current|fan|hotswap> <name> [raw value]
+ *                                                sensor of current controller and FRU
+ *
+ * Hot-swap transitions (-H, or on SIGUSR1) deactivate or activate a FRU that has a
+ * hot-swap sensor and add the transitions to the System Event Log.
+ * Statistics are printed on SIGINT/SIGTERM.
+ *
+ * Usage: mchSim [-t type] [-p base port] [-n shelves] [-b boards] [-s sensors per board]
+ *               [-f shelf file] [-l latency ms] [-j jitter ms] [-d drop fraction]
+ *               [-H hot-swap period s] [-P] [-S seed] [-v]
+ */
+
+#define SIM_PORT_DEFAULT     16230
+#define SIM_BOARDS_DEFAULT   4
+#define SIM_SENSORS_DEFAULT  3
+
+#define SIM_SHELF_MAX        1024
+#define SIM_CTRL_MAX         32
+#define SIM_FRU_MAX          64
+#define SIM_SENS_MAX         512
+#define SIM_SESS_MAX         32
+#define SIM_SEL_MAX          256
+#define SIM_PEND_MAX         4096
+#define SIM_PKT_MAX          512
+#define SIM_HOPS_MAX         3     /* Direct, bridged, twice bridged */
+#define SIM_NAME_LENGTH      16
+#define SIM_FRU_SIZE         256   /* FRU inventory area size; multiple of MSG_FRU_DATA_READ_SIZE */
+#define SIM_SEL_REC_LENGTH   16
+
+#define SIM_TYPE_NAT         0
+#define SIM_TYPE_VT          1
+#define SIM_TYPE_PENTAIR     2
+#define SIM_TYPE_ARTESYN     3
+#define SIM_TYPE_SUPERMICRO  4
+#define SIM_TYPE_ADVANTECH   5
+#define SIM_IS_MICROTCA(x)   ((x) == SIM_TYPE_NAT || (x) == SIM_TYPE_VT)
+#define SIM_IS_ATCA(x)       ((x) == SIM_TYPE_PENTAIR || (x) == SIM_TYPE_ARTESYN)
+#define SIM_IS_SERVER(x)     ((x) == SIM_TYPE_SUPERMICRO || (x) == SIM_TYPE_ADVANTECH)
+
+#define SIM_KIND_TEMP        0
+#define SIM_KIND_VOLT        1
+#define SIM_KIND_CURRENT     2
+#define SIM_KIND_FAN         3
+#define SIM_KIND_HOTSWAP     4
+
+#define SIM_ENTITY_MCH       0xC2  /* MicroTCA Carrier Hub */
+#define SIM_ATCA_FAN_ADDR    0x52  /* IPMB-0 address of first ATCA fan tray */
+
+/* Hot-swap event data 1: [7:4] 0xA = event data 2 and 3 present, [3:0] new M-state */
+#define SIM_HS_EVENT_DATA1(m) (0xA0 | (m))
+
+typedef struct SimTypeRec_ {
+	const char *name;
+	uint32_t    manuf;     /* Manufacturer ID returned by Get Device ID */
+	uint8_t     ipmiVers;  /* IPMI version, BCD, LS digit first */
+} SimTypeRec;
+
+static const SimTypeRec simType[] = {
+	[SIM_TYPE_NAT]        = { "nat",        MCH_MANUF_ID_NAT,        0x51 },
+	[SIM_TYPE_VT]         = { "vt",         MCH_MANUF_ID_VT,         0x51 },
+	[SIM_TYPE_PENTAIR]    = { "pentair",    MCH_MANUF_ID_PENTAIR,    0x51 },
+	[SIM_TYPE_ARTESYN]    = { "artesyn",    MCH_MANUF_ID_ARTESYN,    0x51 },
+	[SIM_TYPE_SUPERMICRO] = { "supermicro", MCH_MANUF_ID_SUPERMICRO, 0x02 },
+	[SIM_TYPE_ADVANTECH]  = { "advantech",  MCH_MANUF_ID_ADVANTECH,  0x02 },
+};
+
+#define SIM_TYPE_COUNT (sizeof(simType)/sizeof(simType[0]))
+
+typedef struct SimSdrRec_ {
+	uint8_t length;
+	uint8_t data[SDR_MAX_LENGTH];
+} SimSdrRec, *SimSdr;
+
+typedef struct SimCtrlRec_ {
+	uint8_t  addr;
+	uint8_t  entityId;
+	uint8_t  entityInst;
+	uint8_t  devSdr;       /* Provides device SDRs for its own sensors */
+	uint8_t  site;         /* ATCA site number and type, for Get Address Info */
+	uint8_t  siteType;
+	uint8_t  nextNumber;   /* Next sensor number to assign */
+	char     name[SIM_NAME_LENGTH + 1];
+	SimSdr   sdr;          /* SDR repository (shelf manager/BMC) or device SDRs */
+	int      sdrCount;
+	int      sdrMax;
+} SimCtrlRec, *SimCtrl;
+
+typedef struct SimFruRec_ {
+	uint8_t  addr;         /* Controller address */
+	uint8_t  id;
+	uint8_t  entityId;
+	uint8_t  entityInst;
+	uint8_t  mstate;       /* Hot-swap M-state */
+	uint8_t  fanLevel;
+	uint8_t  hotswap;      /* Has a hot-swap sensor */
+	char     name[SIM_NAME_LENGTH + 1];
+	uint8_t  data[SIM_FRU_SIZE];
+} SimFruRec, *SimFru;
+
+typedef struct SimSensRec_ {
+	uint8_t  owner;
+	uint8_t  number;
+	uint8_t  kind;
+	uint8_t  entityId;
+	uint8_t  entityInst;
+	uint8_t  nominal;      /* Raw reading about which readings vary */
+	int      fru;          /* Index of FRU, -1 if none */
+	double   phase;
+	char     name[SIM_NAME_LENGTH + 1];
+} SimSensRec, *SimSens;
+
+typedef struct SimSessRec_ {
+	uint32_t id;           /* 0 if slot is free */
+	uint32_t seq;          /* Session sequence number of last reply */
+	uint8_t  active;
+	double   last;         /* Time of last request, for reuse of idle slots */
+} SimSessRec, *SimSess;
+
+typedef struct SimShelfRec_ {
+	int        sd;
+	int        port;
+	int        index;
+	int        type;
+	SimCtrlRec ctrl[SIM_CTRL_MAX];
+	int        ctrlCount;
+	SimFruRec  fru[SIM_FRU_MAX];
+	int        fruCount;
+	SimSensRec sens[SIM_SENS_MAX];
+	int        sensCount;
+	SimSessRec sess[SIM_SESS_MAX];
+	uint32_t   sessNext;
+	uint8_t    sel[SIM_SEL_MAX][SIM_SEL_REC_LENGTH];
+	int        selHead;    /* Index of oldest entry */
+	int        selCount;
+	uint16_t   selNextId;
+	uint32_t   selAddTs;
+	uint32_t   selEraseTs;
+	uint32_t   sdrAddTs;
+	uint16_t   res;        /* Last reservation ID handed out */
+	int        hsNext;     /* FRU to change next */
+	double     hsTime;     /* Time of next hot-swap transition */
+	unsigned long rx, tx, dropped, ignored;
+} SimShelfRec, *SimShelf;
+
+/* Request as parsed: one hop per Send Message level */
+typedef struct SimHopRec_ {
+	uint8_t rsAddr;
+	uint8_t netfnLun;
+	uint8_t rqAddr;
+	uint8_t seqLun;
+	uint8_t cmd;
+	uint8_t chan;
+} SimHopRec;
+
+typedef struct SimReqRec_ {
+	uint8_t   auth;
+	uint8_t   authCode[IPMI_WRAPPER_AUTH_CODE_LENGTH];
+	uint32_t  id;
+	SimHopRec hop[SIM_HOPS_MAX];
+	int       depth;       /* Number of Send Message levels */
+	uint8_t  *data;        /* Request data of innermost message */
+	int       dataSize;
+} SimReqRec, *SimReq;
+
+typedef struct SimPendRec_ {
+	double             due;
+	SimShelf           shelf;
+	struct sockaddr_in to;
+	int                length;
+	uint8_t            buf[SIM_PKT_MAX];
+} SimPendRec;
+
+static SimShelfRec *simShelf;
+static int          simShelfCount = 1;
+static int          simTypeSel    = SIM_TYPE_NAT;
+static int          simBoards     = SIM_BOARDS_DEFAULT;
+static int          simSensors    = SIM_SENSORS_DEFAULT;
+static double       simLatency    = 0;   /* s */
+static double       simJitter     = 0;   /* s */
+static double       simDrop       = 0;
+static double       simHsPeriod   = 0;   /* s */
+static int          simPwdOnly    = 0;
+static int          simVerbose    = 0;
+static const char  *simFile       = 0;
+
+static SimPendRec   simPend[SIM_PEND_MAX];
+static int          simPendCount  = 0;
+
+static volatile sig_atomic_t simStop = 0;
+static volatile sig_atomic_t simHsNow = 0;
+
+static double
+simNow(void)
+{
+struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static double
+simRand(void)
+{
+	return random()/((double)RAND_MAX + 1);
+}
+
+static uint8_t
+simCs(uint8_t *p, int n)
+{
+uint8_t sum = 0;
+
+	while ( n-- )
+		sum += *p++;
+	return -sum;
+}
+
+static void
+simPut16(uint8_t *p, uint16_t v)
+{
+	p[0] = v & 0xFF;
+	p[1] = v >> 8;
+}
+
+static void
+simPut32(uint8_t *p, uint32_t v)
+{
+int i;
+
+	for ( i = 0; i < 4; i++ )
+		p[i] = (v >> 8*i) & 0xFF;
+}
+
+static uint32_t
+simGet32(uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Shelf contents
+ */
+
+static SimCtrl
+simCtrlFind(SimShelf sh, uint8_t addr)
+{
+int i;
+
+	for ( i = 0; i < sh->ctrlCount; i++ )
+		if ( sh->ctrl[i].addr == addr )
+			return &sh->ctrl[i];
+	return 0;
+}
+
+static SimFru
+simFruFind(SimShelf sh, uint8_t addr, uint8_t id)
+{
+int i;
+
+	for ( i = 0; i < sh->fruCount; i++ )
+		if ( sh->fru[i].addr == addr && sh->fru[i].id == id )
+			return &sh->fru[i];
+	return 0;
+}
+
+/* FRU reached over IPMB-L at I2C address addr (NAT carrier manager route) */
+static SimFru
+simFruFindI2c(SimShelf sh, uint8_t addr)
+{
+int i;
+
+	for ( i = 0; i < sh->fruCount; i++ )
+		if ( sh->fru[i].id < sizeof(FRU_I2C_ADDR) && FRU_I2C_ADDR[sh->fru[i].id] == addr )
+			return &sh->fru[i];
+	return 0;
+}
+
+/* Sensor 'number' of 'owner'; if any is set, of any owner (Vadatech carrier manager) */
+static SimSens
+simSensFind(SimShelf sh, uint8_t owner, uint8_t number, int any)
+{
+int i;
+
+	for ( i = 0; i < sh->sensCount; i++ )
+		if ( sh->sens[i].number == number && (any || sh->sens[i].owner == owner) )
+			return &sh->sens[i];
+	return 0;
+}
+
+static SimCtrl
+simCtrlAdd(SimShelf sh, uint8_t addr, uint8_t entityId, uint8_t entityInst, const char *name)
+{
+SimCtrl c;
+
+	if ( (c = simCtrlFind( sh, addr )) )
+		return c;
+
+	if ( sh->ctrlCount >= SIM_CTRL_MAX ) {
+		fprintf(stderr, "mchSim: more than %i controllers\n", SIM_CTRL_MAX);
+		exit( 1 );
+	}
+
+	c = &sh->ctrl[sh->ctrlCount++];
+	memset( c, 0, sizeof(*c) );
+	c->addr       = addr;
+	c->entityId   = entityId;
+	c->entityInst = entityInst;
+	c->nextNumber = 1;
+	snprintf( c->name, sizeof(c->name), "%s", name );
+
+	/* Vadatech carrier manager and server BMCs present all sensors in the SDR repository */
+	c->devSdr = ( addr != IPMI_MSG_ADDR_BMC ) && !SIM_IS_SERVER( sh->type ) && sh->type != SIM_TYPE_VT;
+
+	return c;
+}
+
+/* Length-prefixed 8-bit ASCII field of FRU area */
+static int
+simFruField(uint8_t *p, const char *s)
+{
+int n = strlen( s );
+
+	if ( n > SIM_NAME_LENGTH )
+		n = SIM_NAME_LENGTH;
+	p[0] = (FRU_DATA_TYPE_LANG << 6) | n;
+	memcpy( p + 1, s, n );
+	return n + 1;
+}
+
+/* Close FRU area: end-of-fields marker, pad to multiple of 8 bytes, checksum */
+static int
+simFruAreaEnd(uint8_t *area, int n)
+{
+	area[n++] = 0xC1;
+	while ( (n + 1) % 8 )
+		area[n++] = 0;
+	area[1] = (n + 1)/8;
+	area[n] = simCs( area, n );
+	return n + 1;
+}
+
+/* Build FRU inventory: common header, board area, product area */
+static void
+simFruData(SimShelf sh, SimFru f)
+{
+uint8_t *p = f->data, *a;
+char     sn[SIM_NAME_LENGTH + 1];
+int      n;
+
+	memset( p, 0, SIM_FRU_SIZE );
+	snprintf( sn, sizeof(sn), "%02x%02x%02x%02x", sh->index & 0xFF, f->addr, f->id, sh->port & 0xFF );
+
+	/* Board area */
+	a = p + 8;
+	n = 0;
+	a[n++] = 1;
+	a[n++] = 0;
+	a[n++] = IPMI_DATA_LANG_CODE_ENGLISH1;
+	n += 3;    /* Manufacturing time */
+	n += simFruField( a + n, "mchSim" );
+	n += simFruField( a + n, f->name );
+	n += simFruField( a + n, sn );
+	n += simFruField( a + n, "SIM-0001" );
+	n += simFruField( a + n, "" );
+	n  = simFruAreaEnd( a, n );
+
+	p[FRU_DATA_COMMON_HEADER_BOARD_AREA_OFFSET] = 1;
+	p[FRU_DATA_COMMON_HEADER_PROD_AREA_OFFSET]  = 1 + n/8;
+
+	/* Product area */
+	a += n;
+	n  = 0;
+	a[n++] = 1;
+	a[n++] = 0;
+	a[n++] = IPMI_DATA_LANG_CODE_ENGLISH1;
+	n += simFruField( a + n, "mchSim" );
+	n += simFruField( a + n, f->name );
+	n += simFruField( a + n, "SIM-0001" );
+	n += simFruField( a + n, "1.0" );
+	n += simFruField( a + n, sn );
+	n += simFruField( a + n, "" );
+	n += simFruField( a + n, "" );
+	simFruAreaEnd( a, n );
+
+	p[0] = 1;  /* Format version */
+	p[FRU_DATA_COMMON_HEADER_CS] = simCs( p, FRU_DATA_COMMON_HEADER_CS );
+}
+
+static SimFru
+simFruAdd(SimShelf sh, SimCtrl c, uint8_t id, uint8_t entityId, uint8_t entityInst, const char *name)
+{
+SimFru f;
+
+	if ( sh->fruCount >= SIM_FRU_MAX ) {
+		fprintf(stderr, "mchSim: more than %i FRUs\n", SIM_FRU_MAX);
+		exit( 1 );
+	}
+
+	f = &sh->fru[sh->fruCount++];
+	memset( f, 0, sizeof(*f) );
+	f->addr       = c->addr;
+	f->id         = id;
+	f->entityId   = entityId;
+	f->entityInst = entityInst;
+	f->mstate     = 4;
+	f->fanLevel   = 8;
+	snprintf( f->name, sizeof(f->name), "%s", name );
+	simFruData( sh, f );
+
+	return f;
+}
+
+static SimSens
+simSensAdd(SimShelf sh, SimCtrl c, SimFru f, int kind, const char *name, int nominal)
+{
+static const uint8_t nom[] = { [SIM_KIND_TEMP] = 40, [SIM_KIND_VOLT] = 120, [SIM_KIND_CURRENT] = 25, [SIM_KIND_FAN] = 60, [SIM_KIND_HOTSWAP] = 0 };
+SimSens s;
+SimCtrl owner = c;
+int     i;
+
+	if ( sh->sensCount >= SIM_SENS_MAX ) {
+		fprintf(stderr, "mchSim: more than %i sensors\n", SIM_SENS_MAX);
+		exit( 1 );
+	}
+
+	/* Vadatech carrier manager answers for all sensors by number, so numbers are unique in the shelf */
+	if ( sh->type == SIM_TYPE_VT )
+		owner = &sh->ctrl[0];
+
+	if ( owner->nextNumber == 0xFF ) {
+		fprintf(stderr, "mchSim: out of sensor numbers for controller 0x%02x\n", owner->addr);
+		exit( 1 );
+	}
+
+	s = &sh->sens[sh->sensCount++];
+	memset( s, 0, sizeof(*s) );
+	s->owner      = c->addr;
+	s->number     = owner->nextNumber++;
+	s->kind       = kind;
+	s->entityId   = f ? f->entityId   : c->entityId;
+	s->entityInst = f ? f->entityInst : c->entityInst;
+	s->nominal    = nominal >= 0 ? nominal : nom[kind];
+	s->fru        = f ? f - sh->fru : -1;
+	s->phase      = 2*M_PI*simRand();
+	snprintf( s->name, sizeof(s->name), "%s", name );
+
+	if ( f && kind == SIM_KIND_HOTSWAP )
+		f->hotswap = 1;
+
+	/* Hot-swap sensor of NAT carrier manager */
+	if ( sh->type == SIM_TYPE_NAT && kind == SIM_KIND_HOTSWAP )
+		s->owner = IPMI_MSG_ADDR_BMC;
+
+	for ( i = 0; i < sh->sensCount - 1; i++ )
+		if ( sh->sens[i].owner == s->owner && sh->sens[i].number == s->number ) {
+			fprintf(stderr, "mchSim: duplicate sensor number %i of 0x%02x\n", s->number, s->owner);
+			exit( 1 );
+		}
+
+	return s;
+}
+
+/* Hot-swap sensor name; NAT names carry the FRU ID, which the driver parses */
+static void
+simHsName(SimShelf sh, SimFru f, char *buf, size_t size)
+{
+	if ( sh->type == SIM_TYPE_NAT )
+		snprintf( buf, size, "HS %03d %.8s", f->id, f->name );
+	else
+		snprintf( buf, size, "HS %.12s", f->name );
+}
+
+/* Add FRU with hot-swap sensor */
+static SimFru
+simModuleAdd(SimShelf sh, SimCtrl c, uint8_t id, uint8_t entityId, uint8_t entityInst, const char *name)
+{
+SimFru f;
+char   str[SIM_NAME_LENGTH + 1];
+
+	f = simFruAdd( sh, c, id, entityId, entityInst, name );
+	simHsName( sh, f, str, sizeof(str) );
+	simSensAdd( sh, c, f, SIM_KIND_HOTSWAP, str, -1 );
+	return f;
+}
+
+/* Add n sensors of controller c for FRU f, alternating temperature, voltage and current */
+static void
+simSensorsAdd(SimShelf sh, SimCtrl c, SimFru f, const char *name, int n)
+{
+static const char *label[] = { "Temp", "+12V", "Cur" };
+static const int   kind[]  = { SIM_KIND_TEMP, SIM_KIND_VOLT, SIM_KIND_CURRENT };
+char str[2*SIM_NAME_LENGTH];  /* Truncated by simSensAdd */
+int  i;
+
+	for ( i = 0; i < n; i++ ) {
+		snprintf( str, sizeof(str), "%s%i %s", label[i % 3], i/3 + 1, name );
+		simSensAdd( sh, c, f, kind[i % 3], str, -1 );
+	}
+}
+
+static void
+simShelfMicroTca(SimShelf sh)
+{
+SimCtrl bmc, c;
+SimFru  f;
+char    name[SIM_NAME_LENGTH + 1];
+int     i, id;
+
+	bmc = simCtrlAdd( sh, IPMI_MSG_ADDR_BMC, SIM_ENTITY_MCH, 0x61, "MCH1" );
+	f   = simModuleAdd( sh, bmc, UTCA_FRU_TYPE_MCH_MIN, SIM_ENTITY_MCH, 0x61, "MCH1" );
+	simSensorsAdd( sh, bmc, f, "MCH1", 2 );
+
+	for ( i = 0; i < 2; i++ ) {
+		snprintf( name, sizeof(name), "CU%i", i + 1 );
+		f = simModuleAdd( sh, bmc, UTCA_FRU_TYPE_CU_MIN + i, ENTITY_ID_COOLING_UNIT, 0x61 + i, name );
+		snprintf( name, sizeof(name), "Fan1 CU%i", i + 1 );
+		simSensAdd( sh, bmc, f, SIM_KIND_FAN, name, -1 );
+		simSensorsAdd( sh, bmc, f, f->name, 1 );
+	}
+
+	f = simModuleAdd( sh, bmc, UTCA_FRU_TYPE_PM_MIN, ENTITY_ID_POWER_MODULE, 0x61, "PM1" );
+	simSensAdd( sh, bmc, f, SIM_KIND_VOLT, "+12V PM1", -1 );
+	simSensAdd( sh, bmc, f, SIM_KIND_CURRENT, "Cur PM1", -1 );
+
+	/* AMCs: FRU information from the MCH, sensors from the module's own controller */
+	for ( i = 0; i < simBoards && i < 12; i++ ) {
+		id = UTCA_FRU_TYPE_AMC_MIN + i;
+		snprintf( name, sizeof(name), "AMC%i", i + 1 );
+		f = simModuleAdd( sh, bmc, id, ENTITY_ID_PICMG_AMC, 0x61 + i, name );
+		c = simCtrlAdd( sh, FRU_I2C_ADDR[id], ENTITY_ID_PICMG_AMC, 0x61 + i, name );
+		simSensorsAdd( sh, c, f, name, simSensors );
+	}
+}
+
+static void
+simShelfAtca(SimShelf sh)
+{
+SimCtrl shmc, c;
+SimFru  f;
+char    name[SIM_NAME_LENGTH + 1];
+int     i;
+
+	shmc = simCtrlAdd( sh, IPMI_MSG_ADDR_BMC, ENTITY_ID_PICMG_SHMC, 0x60, "ShMC" );
+	f    = simFruAdd( sh, shmc, 0, ENTITY_ID_PICMG_SHMC, 0x60, "ShMC" );
+	simSensorsAdd( sh, shmc, f, "ShMC", 1 );
+	simFruAdd( sh, shmc, 1, ENTITY_ID_PICMG_SHELF_FRU_INFO, 0x60, "Shelf" );
+
+	for ( i = 0; i < 2; i++ ) {
+		snprintf( name, sizeof(name), "PEM%i", i + 1 );
+		f = simFruAdd( sh, shmc, 2 + i, ENTITY_ID_POWER_MODULE, 0x60 + i, name );
+		simSensorsAdd( sh, shmc, f, name, 3 );
+	}
+
+	/* Fan trays and front boards are IPM controllers with device SDRs */
+	for ( i = 0; i < 2; i++ ) {
+		snprintf( name, sizeof(name), "Fan%i", i + 1 );
+		c = simCtrlAdd( sh, SIM_ATCA_FAN_ADDR + 2*i, ENTITY_ID_COOLING_UNIT, 0x60 + i, name );
+		c->site     = i + 1;
+		c->siteType = PICMG_SITE_TYPE_FAN_TRAY;
+		f = simModuleAdd( sh, c, 0, ENTITY_ID_COOLING_UNIT, 0x60 + i, name );
+		snprintf( name, sizeof(name), "Fan1 %.10s", f->name );
+		simSensAdd( sh, c, f, SIM_KIND_FAN, name, -1 );
+		snprintf( name, sizeof(name), "Fan2 %.10s", f->name );
+		simSensAdd( sh, c, f, SIM_KIND_FAN, name, -1 );
+	}
+
+	for ( i = 1; i <= simBoards && i <= 14; i++ ) {
+		snprintf( name, sizeof(name), "Slot%i", i );
+		c = simCtrlAdd( sh, 0x80 + 2*i, ENTITY_ID_PICMG_FRONT_BOARD, 0x60 + i, name );
+		c->site     = i;
+		c->siteType = PICMG_SITE_TYPE_FRONT_BOARD;
+		f = simModuleAdd( sh, c, 0, ENTITY_ID_PICMG_FRONT_BOARD, 0x60 + i, name );
+		simSensorsAdd( sh, c, f, name, simSensors );
+	}
+}
+
+static void
+simShelfServer(SimShelf sh)
+{
+SimCtrl bmc;
+SimFru  f = 0;
+char    name[SIM_NAME_LENGTH + 1];
+int     i;
+
+	bmc = simCtrlAdd( sh, IPMI_MSG_ADDR_BMC, ENTITY_ID_SYS_BOARD, 0x01, "BMC" );
+
+	if ( sh->type == SIM_TYPE_ADVANTECH )
+		f = simFruAdd( sh, bmc, 0, ENTITY_ID_SYS_BOARD, 0x01, "System" );
+
+	simSensAdd( sh, bmc, f, SIM_KIND_TEMP, "CPU1 Temp", 45 );
+	simSensAdd( sh, bmc, f, SIM_KIND_TEMP, "CPU2 Temp", 47 );
+	simSensAdd( sh, bmc, f, SIM_KIND_TEMP, "System Temp", 30 );
+	for ( i = 0; i < 4; i++ ) {
+		snprintf( name, sizeof(name), "FAN%i", i + 1 );
+		simSensAdd( sh, bmc, f, SIM_KIND_FAN, name, -1 );
+	}
+	simSensAdd( sh, bmc, f, SIM_KIND_VOLT, "12V", 120 );
+	simSensAdd( sh, bmc, f, SIM_KIND_VOLT, "5VCC", 50 );
+	simSensAdd( sh, bmc, f, SIM_KIND_VOLT, "3.3VCC", 33 );
+}
+
+static int
+simKindParse(const char *str)
+{
+static const char *kind[] = { [SIM_KIND_TEMP] = "temp", [SIM_KIND_VOLT] = "volt", [SIM_KIND_CURRENT] = "current",
+                              [SIM_KIND_FAN] = "fan", [SIM_KIND_HOTSWAP] = "hotswap" };
+int i;
+
+	for ( i = 0; i < sizeof(kind)/sizeof(kind[0]); i++ )
+		if ( !strcmp( str, kind[i] ) )
+			return i;
+	return -1;
+}
+
+/* Read shelf contents from file; see top of file for format */
+static void
+simShelfFile(SimShelf sh, const char *path)
+{
+FILE    *fp;
+char     line[256], key[16], name[64], kind[16];
+unsigned addr, id, entityId, entityInst;
+int      raw, n, lineno = 0, k;
+SimCtrl  c = 0;
+SimFru   f = 0;
+
+	if ( !(fp = fopen( path, "r" )) ) {
+		fprintf(stderr, "mchSim: unable to open %s: %s\n", path, strerror( errno ));
+		exit( 1 );
+	}
+
+	while ( fgets( line, sizeof(line), fp ) ) {
+
+		lineno++;
+		if ( 1 != sscanf( line, "%15s", key ) || key[0] == '#' )
+			continue;
+
+		if ( !strcmp( key, "ctrl" ) ) {
+			entityId = entityInst = 0;
+			if ( (n = sscanf( line, "%*s %i %63s %i %i", &addr, name, &entityId, &entityInst )) < 2 )
+				goto bad;
+			c = simCtrlAdd( sh, addr, entityId, entityInst, name );
+			f = 0;
+			/* ATCA front boards and fan trays are located by site */
+			c->siteType = ( entityId == ENTITY_ID_COOLING_UNIT ) ? PICMG_SITE_TYPE_FAN_TRAY : PICMG_SITE_TYPE_FRONT_BOARD;
+			c->site     = sh->ctrlCount - 1;
+		}
+		else if ( !strcmp( key, "fru" ) ) {
+			if ( !c || 4 != sscanf( line, "%*s %i %i %i %63s", &id, &entityId, &entityInst, name ) )
+				goto bad;
+			f = simFruAdd( sh, c, id, entityId, entityInst, name );
+		}
+		else if ( !strcmp( key, "sensor" ) ) {
+			raw = -1;
+			if ( !c || (n = sscanf( line, "%*s %15s %63s %i", kind, name, &raw )) < 2 || (k = simKindParse( kind )) < 0 )
+				goto bad;
+			if ( k == SIM_KIND_HOTSWAP ) {
+				if ( !f )
+					goto bad;
+				simHsName( sh, f, name, SIM_NAME_LENGTH + 1 );
+			}
+			simSensAdd( sh, c, f, k, name, raw );
+		}
+		else
+			goto bad;
+	}
+
+	fclose( fp );
+
+	if ( !simCtrlFind( sh, IPMI_MSG_ADDR_BMC ) ) {
+		fprintf(stderr, "mchSim: %s has no controller at 0x%02x\n", path, IPMI_MSG_ADDR_BMC);
+		exit( 1 );
+	}
+	return;
+
+bad:
+	fprintf(stderr, "mchSim: %s line %i not understood: %s", path, lineno, line);
+	exit( 1 );
+}
+
+/*
+ * Sensor data records
+ */
+
+static SimSdr
+simSdrNew(SimCtrl c, uint8_t type)
+{
+SimSdr r;
+
+	if ( c->sdrCount == c->sdrMax ) {
+		c->sdrMax = c->sdrMax ? 2*c->sdrMax : 16;
+		if ( !(c->sdr = realloc( c->sdr, c->sdrMax*sizeof(*c->sdr) )) ) {
+			fprintf(stderr, "mchSim: no memory for SDRs\n");
+			exit( 1 );
+		}
+	}
+
+	r = &c->sdr[c->sdrCount];
+	memset( r, 0, sizeof(*r) );
+	simPut16( r->data + SDR_ID_LSB_OFFSET, c->sdrCount );
+	r->data[SDR_VER_OFFSET]      = 0x51;
+	r->data[SDR_REC_TYPE_OFFSET] = type;
+	c->sdrCount++;
+
+	return r;
+}
+
+/* Set ID string at offset off and record length */
+static void
+simSdrStr(SimSdr r, int off, const char *str)
+{
+int n = strlen( str );
+
+	if ( n > SIM_NAME_LENGTH )
+		n = SIM_NAME_LENGTH;
+	r->data[off] = (FRU_DATA_TYPE_LANG << 6) | n;
+	memcpy( r->data + off + 1, str, n );
+	r->length = off + 1 + n;
+	r->data[SDR_LENGTH_OFFSET] = r->length - SDR_HEADER_LENGTH;
+}
+
+static uint8_t
+simClip(int v)
+{
+	return v < 0 ? 0 : v > 0xFF ? 0xFF : v;
+}
+
+static int
+simThreshStep(SimSens s)
+{
+	return ( s->kind == SIM_KIND_TEMP ) ? 10 : s->nominal/20 + 1;
+}
+
+/* Thresholds in Get Sensor Thresholds order: lower non-critical, critical, non-recoverable, then upper */
+static void
+simThresh(SimSens s, uint8_t *t)
+{
+int d = simThreshStep( s ), i;
+
+	for ( i = 0; i < 3; i++ ) {
+		t[i]     = simClip( s->nominal - (i + 2)*d );
+		t[i + 3] = simClip( s->nominal + (i + 2)*d );
+	}
+}
+
+/* Full sensor record for threshold sensors; compact record for hot-swap (discrete) sensors */
+static void
+simSdrSensor(SimCtrl c, SimSens s)
+{
+static const uint8_t units[] = { [SIM_KIND_TEMP] = SENSOR_UNITS_DEGC, [SIM_KIND_VOLT] = SENSOR_UNITS_VOLTS, 
+                                 [SIM_KIND_CURRENT] = SENSOR_UNITS_AMPS, [SIM_KIND_FAN] = SENSOR_UNITS_RPM };
+static const uint8_t stype[] = { [SIM_KIND_TEMP] = SENSOR_TYPE_TEMP, [SIM_KIND_VOLT] = SENSOR_TYPE_VOLTAGE, 
+                                 [SIM_KIND_CURRENT] = SENSOR_TYPE_CURRENT, [SIM_KIND_FAN] = SENSOR_TYPE_FAN };
+/* Result exponent: volts and amps in 0.1, RPM in 100 */
+static const uint8_t rexp[]  = { [SIM_KIND_TEMP] = 0x00, [SIM_KIND_VOLT] = 0xF0, [SIM_KIND_CURRENT] = 0xF0, [SIM_KIND_FAN] = 0x20 };
+SimSdr   r;
+uint8_t *p, t[6];
+
+	if ( s->kind == SIM_KIND_HOTSWAP ) {
+		r = simSdrNew( c, SDR_TYPE_COMPACT_SENSOR );
+		p = r->data;
+		p[SDR_OWNER_OFFSET]       = s->owner;
+		p[SDR_NUMBER_OFFSET]      = s->number;
+		p[SDR_ENTITY_ID_OFFSET]   = s->entityId;
+		p[SDR_ENTITY_INST_OFFSET] = s->entityInst;
+		p[SDR_INIT_OFFSET]        = 0x63;
+		p[SDR_CAP_OFFSET]         = 0x40;
+		p[SDR_SENS_TYPE_OFFSET]   = SENSOR_TYPE_HOTSWAP;
+		p[SDR_READ_TYPE_OFFSET]   = 0x6F;    /* Sensor-specific */
+		p[SDR_ASSERT_MASK_OFFSET] = p[SDR_DEASSER_MAXK_OFFSET] = p[SDR_READ_MASK_OFFSET] = 0xFF;
+		simSdrStr( r, SDR_COMPACT_STR_LENGTH_OFFSET, s->name );
+		return;
+	}
+
+	r = simSdrNew( c, SDR_TYPE_FULL_SENSOR );
+	p = r->data;
+	p[SDR_OWNER_OFFSET]       = s->owner;
+	p[SDR_NUMBER_OFFSET]      = s->number;
+	p[SDR_ENTITY_ID_OFFSET]   = s->entityId;
+	p[SDR_ENTITY_INST_OFFSET] = s->entityInst;
+	p[SDR_INIT_OFFSET]        = 0x7F;
+	p[SDR_CAP_OFFSET]         = 0x68;    /* Thresholds readable and settable */
+	p[SDR_SENS_TYPE_OFFSET]   = stype[s->kind];
+	p[SDR_READ_TYPE_OFFSET]   = IPMI_EVENT_TYPE_THRESHOLD;
+	p[SDR_READ_MASK_OFFSET]   = 0x3F;
+	p[SDR_READ_MASK_OFFSET+1] = 0x3F;
+	p[SDR_UNITS2_OFFSET]      = units[s->kind];
+	p[SDR_LINEAR_OFFSET]      = SENSOR_CONV_LINEAR;
+	p[SDR_M_OFFSET]           = 1;
+	p[SDR_EXP_OFFSET]         = rexp[s->kind];
+	p[SDR_ANLG_CHAR_OFFSET]   = 0x07;    /* Nominal, normal max and normal min given */
+	simThresh( s, t );
+	p[SDR_NOMINAL_OFFSET]     = s->nominal;
+	p[SDR_NORM_MAX_OFFSET]    = simClip( s->nominal + simThreshStep( s ) );
+	p[SDR_NORM_MIN_OFFSET]    = simClip( s->nominal - simThreshStep( s ) );
+	p[34]                     = 0xFF;    /* Sensor maximum and minimum */
+	p[35]                     = 0;
+	p[36]                     = t[5];    /* Upper non-recoverable, critical, non-critical */
+	p[37]                     = t[4];
+	p[38]                     = t[3];
+	p[39]                     = t[2];    /* Lower non-recoverable, critical, non-critical */
+	p[40]                     = t[1];
+	p[41]                     = t[0];
+	p[42]                     = p[43] = 1;             /* Hysteresis */
+	simSdrStr( r, SDR_STR_LENGTH_OFFSET, s->name );
+}
+
+static void
+simSdrFru(SimCtrl c, SimFru f)
+{
+SimSdr   r = simSdrNew( c, SDR_TYPE_FRU_DEV );
+uint8_t *p = r->data;
+
+	p[SDR_FRU_ADDR_OFFSET]        = f->addr;
+	p[SDR_FRU_ID_OFFSET]          = f->id;
+	p[SDR_FRU_LUN_OFFSET]         = 0x80;  /* Logical FRU device */
+	p[SDR_FRU_CHAN_OFFSET]        = IPMI_MSG_CHAN_IPMB0;
+	p[SDR_FRU_TYPE_OFFSET]        = 0x10;  /* FRU inventory device behind controller */
+	p[SDR_FRU_ENTITY_ID_OFFSET]   = f->entityId;
+	p[SDR_FRU_ENTITY_INST_OFFSET] = f->entityInst;
+	simSdrStr( r, SDR_FRU_STR_LENGTH_OFFSET, f->name );
+}
+
+static void
+simSdrMgmt(SimCtrl c, SimCtrl m)
+{
+SimSdr   r = simSdrNew( c, SDR_TYPE_MGMT_CTRL_DEV );
+uint8_t *p = r->data;
+
+	p[SDR_MGMT_ADDR_OFFSET]        = m->addr;
+	p[SDR_MGMT_CHAN_OFFSET]        = IPMI_MSG_CHAN_IPMB0;
+	p[SDR_MGMT_CAP_OFFSET]         = 0x29;  /* IPMB event generator, SEL, sensors */
+	p[SDR_MGMT_ENTITY_ID_OFFSET]   = m->entityId;
+	p[SDR_MGMT_ENTITY_INST_OFFSET] = m->entityInst;
+	simSdrStr( r, SDR_MGMT_STR_LENGTH_OFFSET, m->name );
+}
+
+/* 
+ * Shelf manager/BMC repository: controller and FRU locators, sensors of
+ * controllers without device SDRs. Other controllers: their own sensors.
+ */
+static void
+simSdrBuild(SimShelf sh)
+{
+SimCtrl bmc = simCtrlFind( sh, IPMI_MSG_ADDR_BMC ), c;
+int     i;
+
+	for ( i = 0; i < sh->ctrlCount; i++ ) {
+		c = &sh->ctrl[i];
+		if ( c != bmc )
+			simSdrMgmt( bmc, c );
+	}
+
+	/* Supermicro BMCs provide no FRU locator records */
+	if ( sh->type != SIM_TYPE_SUPERMICRO ) {
+		for ( i = 0; i < sh->fruCount; i++ )
+			simSdrFru( bmc, &sh->fru[i] );
+	}
+
+	for ( i = 0; i < sh->sensCount; i++ ) {
+		c = simCtrlFind( sh, sh->sens[i].owner );
+		simSdrSensor( c->devSdr ? c : bmc, &sh->sens[i] );
+	}
+
+	sh->sdrAddTs = time( 0 );
+}
+
+static void
+simShelfInit(SimShelf sh)
+{
+	if ( simFile )
+		simShelfFile( sh, simFile );
+	else if ( SIM_IS_MICROTCA( sh->type ) )
+		simShelfMicroTca( sh );
+	else if ( SIM_IS_ATCA( sh->type ) )
+		simShelfAtca( sh );
+	else
+		simShelfServer( sh );
+
+	simSdrBuild( sh );
+	sh->selEraseTs = sh->sdrAddTs;
+}
+
+/*
+ * System event log and hot-swap
+ */
+
+static void
+simSelAdd(SimShelf sh, SimSens s, uint8_t data1, uint8_t data2, uint8_t data3)
+{
+uint8_t *rec;
+
+	if ( sh->selCount == SIM_SEL_MAX ) {
+		sh->selHead = (sh->selHead + 1) % SIM_SEL_MAX;
+		sh->selCount--;
+	}
+
+	rec = sh->sel[(sh->selHead + sh->selCount) % SIM_SEL_MAX];
+	sh->selCount++;
+
+	/* Record IDs 0 and 0xFFFF mean first and last entry in requests */
+	if ( sh->selNextId == 0 || sh->selNextId == 0xFFFF )
+		sh->selNextId = 1;
+
+	sh->selAddTs = time( 0 );
+	memset( rec, 0, SIM_SEL_REC_LENGTH );
+	simPut16( rec, sh->selNextId++ );
+	rec[IPMI_SEL_REC_TYPE_OFFSET] = IPMI_SEL_REC_TYPE_SYSTEM;
+	simPut32( rec + IPMI_SEL_REC_TS_OFFSET, sh->selAddTs );
+	rec[IPMI_SEL_REC_GEN_ADDR_OFFSET] = s->owner;
+	rec[9]  = 0x04;  /* Event message format version */
+	rec[IPMI_SEL_REC_SENS_TYPE_OFFSET]  = SENSOR_TYPE_HOTSWAP;
+	rec[IPMI_SEL_REC_SENS_NUM_OFFSET]   = s->number;
+	rec[IPMI_SEL_REC_EVENT_TYPE_OFFSET] = 0x6F;
+	rec[IPMI_SEL_REC_EVENT_DATA_OFFSET]     = data1;
+	rec[IPMI_SEL_REC_EVENT_DATA_OFFSET + 1] = data2;
+	rec[IPMI_SEL_REC_EVENT_DATA_OFFSET + 2] = data3;
+}
+
+/* Move FRU through the n M-states in state[], logging each transition */
+static void
+simFruSteps(SimShelf sh, SimFru f, const uint8_t *state, int n)
+{
+SimSens s = 0;
+int     i;
+
+	for ( i = 0; i < sh->sensCount; i++ )
+		if ( sh->sens[i].kind == SIM_KIND_HOTSWAP && &sh->fru[sh->sens[i].fru] == f )
+			s = &sh->sens[i];
+
+	for ( i = 1; i < n; i++ ) {
+		f->mstate = state[i];
+		if ( s )
+			simSelAdd( sh, s, SIM_HS_EVENT_DATA1( state[i] ), state[i - 1], f->id );
+	}
+
+	if ( simVerbose )
+		printf("mchSim: shelf %i FRU %i (%s) M%i -> M%i\n", sh->index, f->id, f->name, state[0], f->mstate);
+}
+
+static void
+simFruActivate(SimShelf sh, SimFru f, int activate)
+{
+static const uint8_t deact[] = { 4, 5, 6, 1 };
+static const uint8_t act[]   = { 1, 2, 3, 4 };
+
+	if ( activate && f->mstate == 1 )
+		simFruSteps( sh, f, act, sizeof(act) );
+	else if ( !activate && f->mstate == 4 )
+		simFruSteps( sh, f, deact, sizeof(deact) );
+}
+
+/* Deactivate a random active FRU with a hot-swap sensor, or activate it if inactive */
+static void
+simHotswap(SimShelf sh)
+{
+int i, n = 0, pick;
+
+	for ( i = 0; i < sh->fruCount; i++ )
+		n += sh->fru[i].hotswap;
+
+	if ( !n )
+		return;
+
+	pick = random() % n;
+	for ( i = 0; i < sh->fruCount; i++ ) {
+		if ( sh->fru[i].hotswap && !pick-- ) {
+			simFruActivate( sh, &sh->fru[i], sh->fru[i].mstate != 4 );
+			return;
+		}
+	}
+}
+
+/*
+ * Command handling
+ */
+
+static uint8_t
+simReading(SimSens s)
+{
+double a = s->nominal/50.0 + 1;
+
+	return simClip( s->nominal + a*sin( 0.1*simNow() + s->phase ) + 0.5 );
+}
+
+/* Reply data for SDR/device SDR read; d is request data */
+static int
+simGetSdr(SimCtrl c, uint8_t *d, int nd, uint8_t *r)
+{
+unsigned id, off, cnt;
+SimSdr   rec;
+
+	if ( nd < 6 )
+		return (r[0] = IPMI_COMP_CODE_REQUEST_LENGTH_INVALID), 1;
+
+	id  = d[2] | (d[3] << 8);
+	off = d[4];
+	cnt = d[5];
+
+	if ( id >= c->sdrCount )
+		return (r[0] = IPMI_COMP_CODE_REQUESTED_DATA), 1;
+
+	rec = &c->sdr[id];
+	if ( off > rec->length )
+		off = rec->length;
+	if ( cnt > rec->length - off )
+		cnt = rec->length - off;
+
+	r[0] = 0;
+	simPut16( r + 1, (id + 1 < c->sdrCount) ? id + 1 : SDR_ID_LAST_SENSOR );
+	memcpy( r + 3, rec->data + off, cnt );
+	return 3 + cnt;
+}
+
+static int
+simGetSelEntry(SimShelf sh, uint8_t *d, int nd, uint8_t *r)
+{
+unsigned id, i;
+uint8_t *rec;
+
+	if ( nd < 6 )
+		return (r[0] = IPMI_COMP_CODE_REQUEST_LENGTH_INVALID), 1;
+
+	if ( !sh->selCount )
+		return (r[0] = IPMI_COMP_CODE_REQUESTED_DATA), 1;
+
+	id = d[2] | (d[3] << 8);
+
+	if ( id == 0 )
+		i = 0;
+	else if ( id == 0xFFFF )
+		i = sh->selCount - 1;
+	else {
+		for ( i = 0; i < sh->selCount; i++ ) {
+			rec = sh->sel[(sh->selHead + i) % SIM_SEL_MAX];
+			if ( (rec[0] | (rec[1] << 8)) == id )
+				break;
+		}
+		if ( i == sh->selCount )
+			return (r[0] = IPMI_COMP_CODE_REQUESTED_DATA), 1;
+	}
+
+	rec = sh->sel[(sh->selHead + i) % SIM_SEL_MAX];
+	r[0] = 0;
+	if ( i + 1 < sh->selCount )
+		memcpy( r + 1, sh->sel[(sh->selHead + i + 1) % SIM_SEL_MAX], 2 );
+	else
+		simPut16( r + 1, 0xFFFF );
+	memcpy( r + 3, rec, SIM_SEL_REC_LENGTH );
+	return 3 + SIM_SEL_REC_LENGTH;
+}
+
+/*
+ * Execute command for controller c. If cm is set, c is the carrier manager
+ * answering for the whole shelf (Vadatech; NAT twice-bridged requests) and
+ * fru, if non-zero, is the FRU addressed on IPMB-L.
+ * Reply data, starting with completion code, are written to r.
+ *
+ *   RETURNS: length of reply data
+ *            -1 if there is no reply
+ */
+static int
+simCmd(SimShelf sh, SimCtrl c, int cm, SimFru fru, uint8_t netfn, uint8_t cmd, uint8_t *d, int nd, uint8_t *r)
+{
+const SimTypeRec *t = &simType[sh->type];
+SimSens  s;
+SimFru   f;
+SimCtrl  k;
+unsigned off, cnt;
+int      n = 1;
+
+	r[0] = 0;
+
+	switch ( (netfn << 8) | cmd ) {
+
+		default:
+			r[0] = IPMI_COMP_CODE_INVALID_COMMAND;
+			break;
+
+		case (IPMI_MSG_NETFN_APP_REQUEST << 8) | IPMI_MSG_CMD_GET_DEVICE_ID:
+			memset( r + 1, 0, 11 );
+			r[2]  = ( c->devSdr ) ? 0x81 : 0x01;  /* Bit 7: provides device SDRs */
+			r[3]  = 0x01;                         /* Firmware revision 1.20 */
+			r[4]  = 0x20;
+			r[5]  = t->ipmiVers;
+			/* Sensors, IPMB event generator; shelf manager/BMC also SDR repository, SEL and FRU inventory */
+			r[6]  = ( c->addr == IPMI_MSG_ADDR_BMC && !cm ) ? 0x2F : 0x21;
+			r[7]  = t->manuf & 0xFF;
+			r[8]  = (t->manuf >> 8) & 0xFF;
+			r[9]  = (t->manuf >> 16) & 0xFF;
+			r[10] = c->addr;                      /* Product ID */
+			n = 12;
+			break;
+
+		case (IPMI_MSG_NETFN_APP_REQUEST << 8) | IPMI_MSG_CMD_COLD_RESET:
+			break;
+
+		case (IPMI_MSG_NETFN_CHASSIS << 8) | IPMI_MSG_CMD_GET_CHAS_STATUS:
+			r[1] = 0x01;  /* Power on */
+			r[2] = r[3] = 0;
+			n = 4;
+			break;
+
+		case (IPMI_MSG_NETFN_CHASSIS << 8) | IPMI_MSG_CMD_CHAS_CTRL:
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_GET_FRU_INFO:
+			if ( nd < 1 || !(f = simFruFind( sh, c->addr, d[0] )) ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			simPut16( r + 1, SIM_FRU_SIZE );
+			r[3] = 0;     /* Accessed by bytes */
+			n = 4;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_READ_FRU_DATA:
+			if ( nd < 4 || !(f = simFruFind( sh, c->addr, d[0] )) ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			off = d[1] | (d[2] << 8);
+			cnt = d[3];
+			if ( off >= SIM_FRU_SIZE ) {
+				r[0] = IPMI_COMP_CODE_PARAMETER_RANGE;
+				break;
+			}
+			if ( cnt > SIM_FRU_SIZE - off )
+				cnt = SIM_FRU_SIZE - off;
+			r[1] = cnt;
+			memcpy( r + 2, f->data + off, cnt );
+			n = 2 + cnt;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_GET_SDRREP_INFO:
+			r[1] = 0x51;
+			simPut16( r + 2, c->sdrCount );
+			simPut16( r + 4, 0x8000 );  /* Free space */
+			simPut32( r + 6, sh->sdrAddTs );
+			simPut32( r + 10, sh->sdrAddTs );
+			r[14] = 0x02;  /* Reserve supported */
+			n = 15;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_RESERVE_SDRREP:
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_RESERVE_SEL:
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_RESERVE_DEV_SDRREP:
+			simPut16( r + 1, ++sh->res );
+			n = 3;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_GET_SDR:
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_GET_DEV_SDR:
+			n = simGetSdr( c, d, nd, r );
+			break;
+
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_GET_DEV_SDR_INFO:
+			r[1] = c->sdrCount;
+			r[2] = 0x01;  /* Static sensor population, LUN 0 */
+			simPut32( r + 3, sh->sdrAddTs );
+			n = 7;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_GET_SEL_INFO:
+			r[1] = 0x51;
+			simPut16( r + 2, sh->selCount );
+			simPut16( r + 4, (SIM_SEL_MAX - sh->selCount)*SIM_SEL_REC_LENGTH );
+			simPut32( r + 6, sh->selAddTs );
+			simPut32( r + 10, sh->selEraseTs );
+			r[14] = 0x02;  /* Reserve supported */
+			n = 15;
+			break;
+
+		case (IPMI_MSG_NETFN_STORAGE << 8) | IPMI_MSG_CMD_GET_SEL_ENTRY:
+			n = simGetSelEntry( sh, d, nd, r );
+			break;
+
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_SENSOR_READ:
+			if ( nd < 1 || !(s = simSensFind( sh, c->addr, d[0], cm && sh->type == SIM_TYPE_VT )) ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			if ( s->kind == SIM_KIND_HOTSWAP ) {
+				r[1] = 0;
+				r[2] = 0xC0;
+				r[3] = 1 << sh->fru[s->fru].mstate;
+			}
+			else {
+				r[1] = simReading( s );
+				/* Reading unavailable while FRU is not active */
+				r[2] = ( s->fru >= 0 && sh->fru[s->fru].mstate != 4 ) ? 0xE0 : 0xC0;
+				r[3] = 0;
+			}
+			r[4] = 0x80;
+			n = 5;
+			break;
+
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_GET_SENSOR_THRESH:
+			if ( nd < 1 || !(s = simSensFind( sh, c->addr, d[0], cm && sh->type == SIM_TYPE_VT )) || s->kind == SIM_KIND_HOTSWAP ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			r[1] = 0x3F;
+			simThresh( s, r + 2 );
+			n = 8;
+			break;
+
+		case (IPMI_MSG_NETFN_SENSOR_EVENT << 8) | IPMI_MSG_CMD_SET_SENSOR_THRESH:
+			break;
+
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_PICMG_PROP:
+			r[1] = 0;
+			r[2] = SIM_IS_ATCA( sh->type ) ? 0x22 : 0x51;  /* PICMG 3.0 R2.2 or MicroTCA.0 R1 */
+			r[3] = SIM_FRU_MAX;
+			r[4] = 0;
+			n = 5;
+			break;
+
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_ADDR_INFO:
+			k = c;
+			if ( nd >= 4 && d[2] == PICMG_ADDR_KEY_TYPE_IPMB0 )
+				k = simCtrlFind( sh, d[3] );
+			if ( !k ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			r[1] = 0;
+			r[2] = k->addr >> 1;  /* Hardware address */
+			r[3] = k->addr;
+			r[4] = 0xFF;
+			r[5] = 0;
+			r[6] = k->site;
+			r[7] = k->siteType;
+			n = 8;
+			break;
+
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_SET_FRU_POLICY:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_FRU_POLICY:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_SET_FRU_ACT:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_POWER_LEVEL:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_FAN_PROP:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_SET_FAN_LEVEL:
+		case (IPMI_MSG_NETFN_PICMG << 8) | IPMI_MSG_CMD_GET_FAN_LEVEL:
+			if ( !(f = fru) && (nd < 2 || !(f = simFruFind( sh, c->addr, d[1] ))) ) {
+				r[0] = IPMI_COMP_CODE_REQUESTED_DATA;
+				break;
+			}
+			r[1] = 0;
+			n = 2;
+			if ( cmd == IPMI_MSG_CMD_GET_FRU_POLICY ) {
+				r[2] = 0;
+				n = 3;
+			}
+			else if ( cmd == IPMI_MSG_CMD_SET_FRU_ACT && nd >= 3 )
+				simFruActivate( sh, f, d[2] == IPMI_MSG2_SET_FRU_ACT_ACTIVATE );
+			else if ( cmd == IPMI_MSG_CMD_GET_POWER_LEVEL ) {
+				r[2] = 0;   /* Properties */
+				r[3] = 0;   /* Delay */
+				r[4] = 10;  /* Multiplier, 0.1 W */
+				r[5] = 20;  /* Draw */
+				n = 6;
+			}
+			else if ( cmd == IPMI_MSG_CMD_GET_FAN_PROP ) {
+				r[2] = 0;   /* Minimum, maximum, normal level */
+				r[3] = 15;
+				r[4] = 8;
+				r[5] = 0x80;
+				n = 6;
+			}
+			else if ( cmd == IPMI_MSG_CMD_SET_FAN_LEVEL && nd >= 3 )
+				f->fanLevel = d[2];
+			else if ( cmd == IPMI_MSG_CMD_GET_FAN_LEVEL ) {
+				r[2] = f->fanLevel;
+				r[3] = f->fanLevel;
+				r[4] = 1;
+				n = 5;
+			}
+			break;
+	}
+
+	return n;
+}
+
+/*
+ * Sessions and message framing
+ */
+
+static SimSess
+simSessFind(SimShelf sh, uint32_t id)
+{
+int i;
+
+	for ( i = 0; i < SIM_SESS_MAX; i++ )
+		if ( sh->sess[i].id == id )
+			return &sh->sess[i];
+	return 0;
+}
+
+/* New session; the driver opens several per shelf, so reuse the longest idle slot when full */
+static SimSess
+simSessNew(SimShelf sh)
+{
+SimSess ss = &sh->sess[0];
+int     i;
+
+	for ( i = 0; i < SIM_SESS_MAX; i++ ) {
+		if ( !sh->sess[i].id ) {
+			ss = &sh->sess[i];
+			break;
+		}
+		if ( sh->sess[i].last < ss->last )
+			ss = &sh->sess[i];
+	}
+
+	if ( ++sh->sessNext == 0 )
+		sh->sessNext = 1;
+
+	memset( ss, 0, sizeof(*ss) );
+	ss->id   = sh->sessNext | ((sh->index & 0xFF) << 24);
+	ss->last = simNow();
+	return ss;
+}
+
+static int
+simSessCount(SimShelf sh)
+{
+int i, n = 0;
+
+	for ( i = 0; i < SIM_SESS_MAX; i++ )
+		n += sh->sess[i].active;
+	return n;
+}
+
+/*
+ * Parse message at p (n bytes, through checksum) into hop 'depth' of q,
+ * following Send Message requests to the bridged message.
+ *
+ *   RETURNS: 0 on success, -1 if message is malformed
+ */
+static int
+simParse(SimReq q, uint8_t *p, int n, int depth)
+{
+SimHopRec *h = &q->hop[depth];
+
+	if ( n < IPMI_MSG1_LENGTH + IPMI_MSG2_CMD_OFFSET + 2 )
+		return -1;
+
+	h->rsAddr   = p[0];
+	h->netfnLun = p[1];
+	h->rqAddr   = p[IPMI_MSG1_LENGTH + IPMI_MSG2_RQADDR_OFFSET];
+	h->seqLun   = p[IPMI_MSG1_LENGTH + IPMI_MSG2_SEQLUN_OFFSET];
+	h->cmd      = p[IPMI_MSG1_LENGTH + IPMI_MSG2_CMD_OFFSET];
+	q->depth    = depth;
+
+	if ( (h->netfnLun >> 2) == IPMI_MSG_NETFN_APP_REQUEST && h->cmd == IPMI_MSG_CMD_SEND_MSG && depth + 1 < SIM_HOPS_MAX ) {
+		h->chan = p[6] & 0x0F;
+		/* Bridged message follows channel; our checksum is last */
+		return simParse( q, p + 7, n - 7 - 1, depth + 1 );
+	}
+
+	q->data     = p + 6;
+	q->dataSize = n - 7;
+	return 0;
+}
+
+/* Reply header for hop h: requester's and our addresses, sequence, command */
+static int
+simHdr(uint8_t *m, SimHopRec *h)
+{
+	m[0] = h->rqAddr;
+	m[1] = (h->netfnLun & ~3) + (1 << 2) + (h->seqLun & 3);  /* Response network function */
+	m[2] = simCs( m, 2 );
+	m[3] = h->rsAddr;
+	m[4] = h->seqLun;
+	m[5] = h->cmd;
+	return 6;
+}
+
+/* RMCP header, session wrapper and message; returns length */
+static int
+simFrame(uint8_t *out, SimReq q, uint32_t seq, uint32_t id, uint8_t *msg, int len)
+{
+int k = RMCP_MSG_HEADER_LENGTH;
+
+	memcpy( out, RMCP_HEADER, RMCP_MSG_HEADER_LENGTH );
+	out[k + IPMI_WRAPPER_AUTH_TYPE_OFFSET] = q->auth;
+	simPut32( out + k + IPMI_WRAPPER_SEQ_OFFSET, seq );
+	simPut32( out + k + IPMI_WRAPPER_ID_OFFSET, id );
+	k += IPMI_WRAPPER_NBYTES_OFFSET;
+	if ( q->auth != IPMI_MSG_AUTH_TYPE_NONE ) {
+		memcpy( out + k, q->authCode, IPMI_WRAPPER_AUTH_CODE_LENGTH );
+		k += IPMI_WRAPPER_AUTH_CODE_LENGTH;
+	}
+	out[k++] = len;
+	memcpy( out + k, msg, len );
+	return k + len;
+}
+
+/*
+ * Compose reply to q with reply data r (nr bytes, from completion code).
+ * Bridged: Send Message reply then bridged reply, two messages in one datagram.
+ * Twice bridged (NAT): bridged replies nested in the Send Message replies.
+ */
+static int
+simReply(uint8_t *out, SimReq q, uint32_t seq, uint32_t id, uint8_t *r, int nr)
+{
+uint8_t   m[SIM_PKT_MAX];
+int       i, n = 0, k, start[SIM_HOPS_MAX];
+SimReqRec b;
+
+	if ( nr > SIM_PKT_MAX - 64 )
+		nr = SIM_PKT_MAX - 64;
+
+	if ( q->depth == 1 ) {
+		n  = simHdr( m, &q->hop[0] );
+		m[n++] = 0;
+		m[n]   = simCs( m + IPMI_MSG1_LENGTH, n - IPMI_MSG1_LENGTH );
+		k  = simFrame( out, q, seq, id, m, n + 1 );
+		n  = simHdr( m, &q->hop[1] );
+		memcpy( m + n, r, nr );
+		n += nr;
+		m[n] = simCs( m + IPMI_MSG1_LENGTH, n - IPMI_MSG1_LENGTH );
+		/* Only the first message carries an authentication code */
+		b      = *q;
+		b.auth = IPMI_MSG_AUTH_TYPE_NONE;
+		return k + simFrame( out + k, &b, seq, id, m, n + 1 );
+	}
+
+	for ( i = 0; i <= q->depth; i++ ) {
+		start[i] = n;
+		n += simHdr( m + n, &q->hop[i] );
+		if ( i < q->depth )
+			m[n++] = 0;
+	}
+	memcpy( m + n, r, nr );
+	n += nr;
+	for ( i = q->depth; i >= 0; i-- ) {
+		m[n] = simCs( m + start[i] + IPMI_MSG1_LENGTH, n - start[i] - IPMI_MSG1_LENGTH );
+		n++;
+	}
+	return simFrame( out, q, seq, id, m, n );
+}
+
+static void
+simSendNow(SimShelf sh, struct sockaddr_in *to, uint8_t *buf, int len)
+{
+	if ( sendto( sh->sd, buf, len, 0, (struct sockaddr *)to, sizeof(*to) ) == len )
+		sh->tx++;
+}
+
+/* Send reply, dropping or delaying it as configured */
+static void
+simSend(SimShelf sh, struct sockaddr_in *to, uint8_t *buf, int len)
+{
+SimPendRec *pend;
+double      delay;
+
+	if ( simDrop > 0 && simRand() < simDrop ) {
+		sh->dropped++;
+		return;
+	}
+
+	delay = simLatency + simJitter*simRand();
+
+	if ( delay <= 0 || simPendCount == SIM_PEND_MAX ) {
+		simSendNow( sh, to, buf, len );
+		return;
+	}
+
+	pend = &simPend[simPendCount++];
+	pend->due    = simNow() + delay;
+	pend->shelf  = sh;
+	pend->to     = *to;
+	pend->length = len;
+	memcpy( pend->buf, buf, len );
+}
+
+static void
+simPendFlush(double now)
+{
+int i = 0;
+
+	while ( i < simPendCount ) {
+		if ( simPend[i].due <= now ) {
+			simSendNow( simPend[i].shelf, &simPend[i].to, simPend[i].buf, simPend[i].length );
+			simPend[i] = simPend[--simPendCount];
+		}
+		else
+			i++;
+	}
+}
+
+/* Presence Ping: answer with Presence Pong */
+static void
+simPong(SimShelf sh, struct sockaddr_in *from, uint8_t *buf, int len)
+{
+uint8_t out[RMCP_MSG_HEADER_LENGTH + ASF_MSG_HEADER_LENGTH + ASF_RPLY_PONG_PAYLOAD_LENGTH] = { 0 };
+uint8_t *asf = out + ASF_MSG_OFFSET;
+
+	if ( len < RMCP_MSG_HEADER_LENGTH + ASF_MSG_HEADER_LENGTH || buf[ASF_MSG_OFFSET + 4] != 0x80 )
+		return;
+
+	memcpy( out, buf, RMCP_MSG_HEADER_LENGTH );
+	memcpy( asf, ASF_MSG, 4 );
+	asf[4] = 0x40;                                  /* Presence Pong */
+	asf[5] = buf[ASF_MSG_OFFSET + 5];               /* Message tag */
+	asf[7] = ASF_RPLY_PONG_PAYLOAD_LENGTH;
+	memcpy( asf + ASF_MSG_HEADER_LENGTH, ASF_MSG, 4 );
+	asf[ASF_MSG_HEADER_LENGTH + 8] = 0x81;          /* IPMI supported */
+	simSend( sh, from, out, sizeof(out) );
+}
+
+/* Session establishment commands; returns reply data length */
+static int
+simSessCmd(SimShelf sh, SimReq q, SimSess *pss, uint8_t *r)
+{
+SimSess ss = *pss;
+uint8_t cmd = q->hop[0].cmd, *d = q->data;
+
+	r[0] = 0;
+
+	switch ( cmd ) {
+
+		case IPMI_MSG_CMD_GET_CHAN_AUTH:
+			memset( r + 1, 0, 8 );
+			r[1] = IPMI_MSG_CHAN_IPMB0 + 0x0E;  /* This channel */
+			r[2] = simPwdOnly ? (1 << IPMI_MSG_AUTH_TYPE_PWD_KEY) : ((1 << IPMI_MSG_AUTH_TYPE_NONE) | (1 << IPMI_MSG_AUTH_TYPE_PWD_KEY));
+			r[3] = 0x04;  /* Non-null user names */
+			return 9;
+
+		case IPMI_MSG_CMD_GET_SESSION_CHALLENGE:
+			*pss = ss = simSessNew( sh );
+			simPut32( r + 1, ss->id );
+			memset( r + 5, 0xA5, 16 );
+			return 21;
+
+		case IPMI_MSG_CMD_ACTIVATE_SESSION:
+			if ( !ss || q->dataSize < 1 )
+				return (r[0] = IPMI_COMP_CODE_REQUESTED_DATA), 1;
+			ss->active = 1;
+			r[1] = d[0];                    /* Authentication type */
+			simPut32( r + 2, ss->id );
+			simPut32( r + 6, 1 );           /* Initial inbound sequence number */
+			r[10] = IPMI_MSG_PRIV_LEVEL_ADMIN;
+			return 11;
+
+		case IPMI_MSG_CMD_SET_PRIV_LEVEL:
+			r[1] = q->dataSize > 0 ? d[0] : IPMI_MSG_PRIV_LEVEL_ADMIN;
+			return 2;
+
+		case IPMI_MSG_CMD_CLOSE_SESSION:
+			return 1;
+	}
+
+	return -1;
+}
+
+static void
+simRecv(SimShelf sh, uint8_t *buf, int len, struct sockaddr_in *from)
+{
+SimReqRec q;
+SimSess   ss = 0;
+SimCtrl   c;
+SimFru    fru = 0;
+uint8_t   r[SIM_PKT_MAX], out[2*SIM_PKT_MAX], netfn, cmd;
+int       k, n, cm = 0, closing = 0;
+uint32_t  seq = 0, id;
+
+	sh->rx++;
+
+	if ( len < RMCP_MSG_HEADER_LENGTH + IPMI_WRAPPER_NBYTES_OFFSET + 1 ) {
+		if ( len >= RMCP_MSG_HEADER_LENGTH && buf[RMCP_MSG_CLASS_OFFSET] == RMCP_MSG_CLASS_ASF )
+			simPong( sh, from, buf, len );
+		else
+			sh->ignored++;
+		return;
+	}
+
+	if ( buf[RMCP_MSG_CLASS_OFFSET] == RMCP_MSG_CLASS_ASF ) {
+		simPong( sh, from, buf, len );
+		return;
+	}
+
+	memset( &q, 0, sizeof(q) );
+	k      = RMCP_MSG_HEADER_LENGTH;
+	q.auth = buf[k + IPMI_WRAPPER_AUTH_TYPE_OFFSET];
+	q.id   = id = simGet32( buf + k + IPMI_WRAPPER_ID_OFFSET );
+	k     += IPMI_WRAPPER_NBYTES_OFFSET;
+	if ( q.auth != IPMI_MSG_AUTH_TYPE_NONE ) {
+		if ( len < k + IPMI_WRAPPER_AUTH_CODE_LENGTH + 1 ) {
+			sh->ignored++;
+			return;
+		}
+		memcpy( q.authCode, buf + k, IPMI_WRAPPER_AUTH_CODE_LENGTH );
+		k += IPMI_WRAPPER_AUTH_CODE_LENGTH;
+	}
+	n = buf[k++];
+
+	if ( n > len - k || simParse( &q, buf + k, n, 0 ) ) {
+		sh->ignored++;
+		return;
+	}
+
+	if ( id && !(ss = simSessFind( sh, id )) ) {
+		sh->ignored++;
+		return;
+	}
+
+	netfn = q.hop[q.depth].netfnLun >> 2;
+	cmd   = q.hop[q.depth].cmd;
+
+	if ( simVerbose )
+		printf("mchSim: shelf %i session 0x%08x netfn 0x%02x cmd 0x%02x target 0x%02x depth %i\n",
+		    sh->index, id, netfn, cmd, q.hop[q.depth].rsAddr, q.depth);
+
+	if ( q.depth == 0 && netfn == IPMI_MSG_NETFN_APP_REQUEST && 
+	    cmd >= IPMI_MSG_CMD_GET_CHAN_AUTH && cmd <= IPMI_MSG_CMD_CLOSE_SESSION ) {
+		if ( (n = simSessCmd( sh, &q, &ss, r )) < 0 )
+			return;
+		closing = ( cmd == IPMI_MSG_CMD_CLOSE_SESSION );
+		/* Session ID of challenge reply is in the data, not the wrapper */
+		if ( cmd == IPMI_MSG_CMD_GET_SESSION_CHALLENGE )
+			ss = 0;
+	}
+	else {
+		if ( !ss || !ss->active ) {
+			sh->ignored++;
+			return;
+		}
+
+		if ( q.depth == 0 )
+			c = simCtrlFind( sh, IPMI_MSG_ADDR_BMC );
+		else if ( SIM_IS_MICROTCA( sh->type ) && q.hop[1].rsAddr == IPMI_MSG_ADDR_CM ) {
+			c  = simCtrlFind( sh, IPMI_MSG_ADDR_BMC );
+			cm = 1;
+			/* NAT: bridged again by the carrier manager to a module on IPMB-L */
+			if ( q.depth == 2 )
+				fru = simFruFindI2c( sh, q.hop[2].rsAddr );
+		}
+		else
+			c = ( q.depth == 1 ) ? simCtrlFind( sh, q.hop[1].rsAddr ) : 0;
+
+		/* No such target: the bridged request times out */
+		if ( !c ) {
+			sh->ignored++;
+			return;
+		}
+
+		n = simCmd( sh, c, cm, fru, netfn, cmd, q.data, q.dataSize, r );
+	}
+
+	if ( ss ) {
+		ss->last = simNow();
+		/* Advantech session sequence numbers stop increasing once the session is up */
+		if ( sh->type != SIM_TYPE_ADVANTECH || ss->seq < 3 )
+			ss->seq++;
+		seq = ss->seq;
+	}
+
+	n = simReply( out, &q, seq, ss ? ss->id : 0, r, n );
+	simSend( sh, from, out, n );
+
+	if ( closing )
+		memset( ss, 0, sizeof(*ss) );
+}
+
+/*
+ * Main
+ */
+
+static void
+simSignal(int sig)
+{
+	if ( sig == SIGUSR1 )
+		simHsNow = 1;
+	else
+		simStop = 1;
+}
+
+static void
+simUsage(const char *nm)
+{
+	fprintf(stderr, "Usage: %s [-t type] [-p base port] [-n shelves] [-b boards] [-s sensors per board]\n"
+	    "          [-f shelf file] [-l latency ms] [-j jitter ms] [-d drop fraction]\n"
+	    "          [-H hot-swap period s] [-P] [-S seed] [-v]\n"
+	    "  -t  nat (default), vt, pentair, artesyn, supermicro or advantech\n"
+	    "  -p  UDP port of first shelf; shelf i listens on port + i (default %i)\n"
+	    "  -n  number of shelves (default 1, max %i)\n"
+	    "  -b  AMCs or front boards per shelf (default %i)\n"
+	    "  -s  sensors per AMC or front board (default %i)\n"
+	    "  -f  read shelf contents from file instead\n"
+	    "  -l  reply latency, ms; -j random extra latency, ms\n"
+	    "  -d  fraction of replies to drop\n"
+	    "  -H  period of hot-swap transitions, s (also on SIGUSR1)\n"
+	    "  -P  offer only password authentication\n"
+	    "  -S  random seed\n"
+	    "  -v  print requests and transitions\n",
+	    nm, SIM_PORT_DEFAULT, SIM_SHELF_MAX, SIM_BOARDS_DEFAULT, SIM_SENSORS_DEFAULT);
+}
+
+int
+main(int argc, char **argv)
+{
+struct sigaction   sa;
+struct sockaddr_in addr, from;
+struct pollfd     *pfd;
+socklen_t          fromLen;
+uint8_t            buf[SIM_PKT_MAX];
+SimShelf           sh;
+double             now, next;
+int                opt, i, len, port = SIM_PORT_DEFAULT, timeout;
+unsigned           seed = time( 0 );
+
+	while ( (opt = getopt( argc, argv, "t:p:n:b:s:f:l:j:d:H:PS:vh" )) > 0 ) {
+		switch ( opt ) {
+			case 't':
+				for ( simTypeSel = 0; simTypeSel < SIM_TYPE_COUNT; simTypeSel++ )
+					if ( !strcmp( optarg, simType[simTypeSel].name ) )
+						break;
+				if ( simTypeSel == SIM_TYPE_COUNT ) {
+					fprintf(stderr, "mchSim: unknown type '%s'\n", optarg);
+					return 1;
+				}
+				break;
+			case 'p': port          = strtol( optarg, 0, 0 );    break;
+			case 'n': simShelfCount = strtol( optarg, 0, 0 );    break;
+			case 'b': simBoards     = strtol( optarg, 0, 0 );    break;
+			case 's': simSensors    = strtol( optarg, 0, 0 );    break;
+			case 'f': simFile       = optarg;                    break;
+			case 'l': simLatency    = strtod( optarg, 0 )/1000.; break;
+			case 'j': simJitter     = strtod( optarg, 0 )/1000.; break;
+			case 'd': simDrop       = strtod( optarg, 0 );       break;
+			case 'H': simHsPeriod   = strtod( optarg, 0 );       break;
+			case 'P': simPwdOnly    = 1;                         break;
+			case 'S': seed          = strtoul( optarg, 0, 0 );   break;
+			case 'v': simVerbose    = 1;                         break;
+			default:
+				simUsage( argv[0] );
+				return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if ( simShelfCount < 1 || simShelfCount > SIM_SHELF_MAX || port < 1 || port + simShelfCount > 65536 ) {
+		simUsage( argv[0] );
+		return 1;
+	}
+
+	srandom( seed );
+
+	if ( !(simShelf = calloc( simShelfCount, sizeof(*simShelf) )) || !(pfd = calloc( simShelfCount, sizeof(*pfd) )) ) {
+		fprintf(stderr, "mchSim: no memory for %i shelves\n", simShelfCount);
+		return 1;
+	}
+
+	now = simNow();
+
+	for ( i = 0; i < simShelfCount; i++ ) {
+
+		sh        = &simShelf[i];
+		sh->index = i;
+		sh->type  = simTypeSel;
+		sh->port  = port + i;
+		simShelfInit( sh );
+		sh->hsTime = now + simHsPeriod*(1 + (double)i/simShelfCount);  /* Stagger shelves */
+
+		memset( &addr, 0, sizeof(addr) );
+		addr.sin_family      = AF_INET;
+		addr.sin_port        = htons( sh->port );
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+		if ( (sh->sd = socket( AF_INET, SOCK_DGRAM, 0 )) < 0 || bind( sh->sd, (struct sockaddr *)&addr, sizeof(addr) ) ) {
+			fprintf(stderr, "mchSim: unable to bind 127.0.0.1:%i: %s\n", sh->port, strerror( errno ));
+			return 1;
+		}
+		pfd[i].fd     = sh->sd;
+		pfd[i].events = POLLIN;
+	}
+
+	memset( &sa, 0, sizeof(sa) );
+	sa.sa_handler = simSignal;
+	sigaction( SIGINT,  &sa, 0 );
+	sigaction( SIGTERM, &sa, 0 );
+	sigaction( SIGUSR1, &sa, 0 );
+
+	printf("mchSim: %i %s shelves on 127.0.0.1:%i-%i, %i controllers, %i FRUs, %i sensors each, seed %u\n",
+	    simShelfCount, simType[simTypeSel].name, port, port + simShelfCount - 1,
+	    simShelf[0].ctrlCount, simShelf[0].fruCount, simShelf[0].sensCount, seed);
+	fflush( stdout );
+
+	while ( !simStop ) {
+
+		now  = simNow();
+		next = now + 1;
+		for ( i = 0; i < simPendCount; i++ )
+			if ( simPend[i].due < next )
+				next = simPend[i].due;
+		if ( simHsPeriod > 0 && simShelf[0].hsTime < next )
+			next = simShelf[0].hsTime;
+		timeout = ( next > now ) ? (int)((next - now)*1000) + 1 : 0;
+
+		if ( poll( pfd, simShelfCount, timeout ) < 0 && errno != EINTR ) {
+			perror( "mchSim: poll" );
+			break;
+		}
+
+		for ( i = 0; i < simShelfCount; i++ ) {
+			if ( !(pfd[i].revents & POLLIN) )
+				continue;
+			fromLen = sizeof(from);
+			while ( (len = recvfrom( pfd[i].fd, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &fromLen )) > 0 ) {
+				simRecv( &simShelf[i], buf, len, &from );
+				fromLen = sizeof(from);
+			}
+		}
+
+		now = simNow();
+		simPendFlush( now );
+
+		for ( i = 0; i < simShelfCount; i++ ) {
+			sh = &simShelf[i];
+			if ( simHsNow || (simHsPeriod > 0 && now >= sh->hsTime) ) {
+				simHotswap( sh );
+				if ( simHsPeriod > 0 && now >= sh->hsTime )
+					sh->hsTime += simHsPeriod;
+			}
+		}
+		simHsNow = 0;
+	}
+
+	for ( i = 0; i < simShelfCount; i++ ) {
+		sh = &simShelf[i];
+		printf("mchSim: shelf %i port %i rx %lu tx %lu dropped %lu ignored %lu sessions %i SEL %i\n",
+		    i, sh->port, sh->rx, sh->tx, sh->dropped, sh->ignored, simSessCount( sh ), sh->selCount);
+	}
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of 'ipmiComm'.
+// It is subject to the license terms in the LICENSE.txt file found in the 
+// top-level directory of this distribution and at: 
+//    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html. 
+// No part of 'ipmiComm', including this file, 
+// may be copied, modified, propagated, or distributed except according to 
+// the terms contained in the LICENSE.txt file.
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <epicsTime.h>
+
+#include <drvMch.h>
+
+/*
+ * Microbenchmark: sweep the cached state of every sensor in a shelf,
+ * as the periodic scan does, with two memory layouts:
+ *
+ *   interleaved - scan state stored inside each sensor record, next to the SDR
+ *                 (layout used before the hot/cold split)
+ *   hot         - scan state in the dense SensorHotRec array parallel to mchSys->sens
+ *
+ * No MCH is needed; sensor data are synthetic.
+ *
+ * Usage: mchSweepBench [sensors per shelf] [shelves] [sweeps]
+ */
+
+#define BENCH_SENSORS_DEFAULT  400
+#define BENCH_SHELVES_DEFAULT  16
+#define BENCH_SWEEPS_DEFAULT   2000
+
+/* Previous layout: scan state embedded in the (large) sensor record */
+typedef struct BenchSensorRec_ {
+	SensorRec     cold;
+	SensorHotRec  hot;
+} BenchSensorRec;
+
+static void
+benchFill(Sensor sens, SensorHot hot, int i)
+{
+	sens->sdr.number   = i & 0xFF;
+	sens->sdr.sensType = i % MAX_SENSOR_TYPE;
+	sens->sdr.recType  = SDR_TYPE_FULL_SENSOR;
+	snprintf( sens->sdr.str, sizeof(sens->sdr.str), "Sensor %i", i );
+	hot->val  = (uint8_t)(i * 7);
+	hot->stat = ( (i % 13) == 0 ) ? SENS_STAT_UNAVAIL : SENS_STAT_CNFG;
+	hot->readMsgLength = IPMI_RPLY_IMSG2_SENSOR_READ_MAX_LENGTH;
+	hot->sens = sens;
+}
+
+/* Touch the fields a scan pass touches: availability, value, error count */
+static uint32_t
+benchSweepInterleaved(BenchSensorRec *sens, int n)
+{
+uint32_t sum = 0;
+int i;
+
+	for ( i = 0; i < n; i++ ) {
+		if ( SENS_UNAVAIL( &sens[i].hot ) )
+			continue;
+		sum += sens[i].hot.val + sens[i].hot.err;
+	}
+	return sum;
+}
+
+static uint32_t
+benchSweepHot(SensorHotRec *hot, int n)
+{
+uint32_t sum = 0;
+int i;
+
+	for ( i = 0; i < n; i++ ) {
+		if ( SENS_UNAVAIL( &hot[i] ) )
+			continue;
+		sum += hot[i].val + hot[i].err;
+	}
+	return sum;
+}
+
+int
+main(int argc, char **argv)
+{
+int              nsens   = ( argc > 1 ) ? atoi( argv[1] ) : BENCH_SENSORS_DEFAULT;
+int              nshelf  = ( argc > 2 ) ? atoi( argv[2] ) : BENCH_SHELVES_DEFAULT;
+int              nsweep  = ( argc > 3 ) ? atoi( argv[3] ) : BENCH_SWEEPS_DEFAULT;
+BenchSensorRec **inter;
+SensorRec      **cold;
+SensorHotRec   **hot;
+epicsTimeStamp   t0, t1;
+double           tInter, tHot;
+uint32_t         sumInter = 0, sumHot = 0;
+int              i, j, k;
+
+	if ( nsens <= 0 || nshelf <= 0 || nsweep <= 0 ) {
+		printf("Usage: %s [sensors per shelf] [shelves] [sweeps]\n", argv[0]);
+		return 1;
+	}
+
+	inter = calloc( nshelf, sizeof(*inter) );
+	cold  = calloc( nshelf, sizeof(*cold)  );
+	hot   = calloc( nshelf, sizeof(*hot)   );
+	if ( !inter || !cold || !hot ) {
+		printf("No memory\n");
+		return 1;
+	}
+
+	for ( j = 0; j < nshelf; j++ ) {
+		inter[j] = calloc( nsens, sizeof(**inter) );
+		cold[j]  = calloc( nsens, sizeof(**cold)  );
+		hot[j]   = calloc( nsens, sizeof(**hot)   );
+		if ( !inter[j] || !cold[j] || !hot[j] ) {
+			printf("No memory\n");
+			return 1;
+		}
+		for ( i = 0; i < nsens; i++ ) {
+			benchFill( &inter[j][i].cold, &inter[j][i].hot, i );
+			benchFill( &cold[j][i], &hot[j][i], i );
+		}
+	}
+
+	/* Untimed warm-up so that neither layout pays for page faults or CPU clock ramp-up */
+	for ( k = 0; k < nsweep/10 + 1; k++ )
+		for ( j = 0; j < nshelf; j++ ) {
+			benchSweepInterleaved( inter[j], nsens );
+			benchSweepHot( hot[j], nsens );
+		}
+
+	/* Sweep every shelf in turn so that one shelf's data is evicted by the next,
+	 * like a scan of many MCHs
+	 */
+	epicsTimeGetCurrent( &t0 );
+	for ( k = 0; k < nsweep; k++ )
+		for ( j = 0; j < nshelf; j++ )
+			sumInter += benchSweepInterleaved( inter[j], nsens );
+	epicsTimeGetCurrent( &t1 );
+	tInter = epicsTimeDiffInSeconds( &t1, &t0 );
+
+	epicsTimeGetCurrent( &t0 );
+	for ( k = 0; k < nsweep; k++ )
+		for ( j = 0; j < nshelf; j++ )
+			sumHot += benchSweepHot( hot[j], nsens );
+	epicsTimeGetCurrent( &t1 );
+	tHot = epicsTimeDiffInSeconds( &t1, &t0 );
+
+	printf("Sensor sweep: %i shelves x %i sensors, %i sweeps\n", nshelf, nsens, nsweep);
+	printf("  interleaved: record stride %4i bytes, %8.2f ns/sensor (checksum %" PRIu32 ")\n",
+	    (int)sizeof(BenchSensorRec), 1e9*tInter/((double)nsweep*nshelf*nsens), sumInter);
+	printf("  hot array:   record stride %4i bytes, %8.2f ns/sensor (checksum %" PRIu32 ")\n",
+	    (int)sizeof(SensorHotRec), 1e9*tHot/((double)nsweep*nshelf*nsens), sumHot);
+	if ( tHot > 0 )
+		printf("  speedup:     %.2fx\n", tInter/tHot);
+
+	for ( j = 0; j < nshelf; j++ ) {
+		free( inter[j] );
+		free( cold[j] );
+		free( hot[j] );
+	}
+	free( inter );
+	free( cold );
+	free( hot );
+
+	return 0;
+}